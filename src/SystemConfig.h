@@ -19,7 +19,11 @@
 
 // Debugging
 #define CONFIG_ENABLE_DEBUG             1
+#ifdef PLATFORM_SIM
+#define CONFIG_ENABLE_PROFILER          1
+#else
 #define CONFIG_ENABLE_PROFILER          0
+#endif
 #define CONFIG_ENABLE_TASK_PROFILER     1
 
 // Sanitization
@@ -38,6 +38,10 @@
 // Default UI frames per second
 #define CONFIG_DEFAULT_UI_FPS           50
 
+// UI redraw
+#define CONFIG_UI_SETTLE_FRAMES         2               // frames redrawn after an invalidation (picks up changes the engine applies asynchronously)
+#define CONFIG_UI_REFRESH_FRAMES        50              // frames between redrawing pages that are not invalidated
+
 // CV/Gate channels
 #define CONFIG_CHANNEL_COUNT            8
 
@@ -58,6 +62,13 @@
 #define CONFIG_USER_SCALE_COUNT         4
 #define CONFIG_USER_SCALE_SIZE          32
 
+// Routing
+#define CONFIG_ROUTING_EPSILON          (1.f / 4096.f)  // minimum source change to update a route target
+#define CONFIG_ROUTING_REFRESH_INTERVAL 64              // engine updates between rewriting all route targets
+
+// MIDI
+#define CONFIG_MIDI_PAYLOAD_POOL_SIZE   192             // sysex payload memory, split into 4 slots of 48 bytes
+
 
 #define CONFIG_ENABLE_ASTEROIDS
 // #define CONFIG_ENABLE_INTRO
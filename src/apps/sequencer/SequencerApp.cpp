@@ -0,0 +1,20 @@
+#include "SequencerApp.h"
+
+#include "core/profiler/Profiler.h"
+
+static os::PeriodicTask<1024> fsTask("file", CONFIG_FILE_TASK_PRIORITY, os::time::ms(10), [] () {
+    FileManager::processTask();
+});
+
+// profile engine and ui updates like the engine and ui tasks on the hardware (1ms period)
+PROFILER_INTERVAL_BUDGET(engineTask, "engine", 1000)
+PROFILER_INTERVAL_BUDGET(uiTask, "ui", 1000)
+
+void SequencerApp::update() {
+    PROFILER_INTERVAL_BEGIN(engineTask)
+    engine.update();
+    PROFILER_INTERVAL_END(engineTask)
+    PROFILER_INTERVAL_BEGIN(uiTask)
+    ui.update();
+    PROFILER_INTERVAL_END(uiTask)
+}
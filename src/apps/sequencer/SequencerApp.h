@@ -21,10 +21,6 @@
 
 #include "os/os.h"
 
-static os::PeriodicTask<1024> fsTask("file", CONFIG_FILE_TASK_PRIORITY, os::time::ms(10), [] () {
-    FileManager::processTask();
-});
-
 struct SequencerApp {
     // drivers
     ClockTimer clockTimer;
@@ -42,7 +38,7 @@ struct SequencerApp {
     // filesystem
     fs::Volume volume;
 
-    uint8_t midiMessagePayloadPool[32];
+    uint8_t midiMessagePayloadPool[CONFIG_MIDI_PAYLOAD_POOL_SIZE];
 
     // application
     Model model;
@@ -63,8 +59,5 @@ struct SequencerApp {
         ui.init();
     }
 
-    void update() {
-        engine.update();
-        ui.update();
-    }
+    void update();
 };
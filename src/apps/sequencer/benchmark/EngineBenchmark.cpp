@@ -0,0 +1,525 @@
+// Headless engine benchmark
+//
+// Sets up the engine with a synthetic project (all tracks in the same track mode, all steps and layers filled in,
+// all routes active) and runs Engine::update() through the simulator for a number of simulated minutes at a range
+// of tempos. Reports the cost of engine updates, engine ticks and track engine ticks.
+//
+// Additionally dispatches 3 kB/s of CC messages (1000 messages/s) mapped to a varying number of MIDI routes to the
+// routing engine and reports the cost of dispatching the messages to the routes.
+//
+// Finally compares the cost of evaluating curve shapes with the float functions and the fixed point wavetables.
+//
+// Usage: sequencer_benchmark [minutes] [bpm ...]
+
+#include "Config.h"
+
+#include "drivers/Adc.h"
+#include "drivers/ClockTimer.h"
+#include "drivers/Dac.h"
+#include "drivers/Dio.h"
+#include "drivers/GateOutput.h"
+#include "drivers/HighResolutionTimer.h"
+#include "drivers/Midi.h"
+#include "drivers/UsbMidi.h"
+
+#include "model/Curve.h"
+#include "model/Model.h"
+#include "model/QuantizerTable.h"
+#include "engine/Engine.h"
+#include "engine/VoiceAllocator.h"
+
+#include "core/Debug.h"
+#include "core/utils/Random.h"
+
+#include "sim/Simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+static uint32_t elapsedNs(BenchmarkClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now() - start).count();
+}
+
+class LatencyStats {
+public:
+    void push(uint32_t ns) {
+        _samples.emplace_back(ns);
+    }
+
+    size_t count() const { return _samples.size(); }
+
+    double mean() const {
+        if (_samples.empty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (auto sample : _samples) {
+            sum += sample;
+        }
+        return sum / _samples.size();
+    }
+
+    uint32_t percentile(float p) {
+        if (_samples.empty()) {
+            return 0;
+        }
+        size_t index = std::min(_samples.size() - 1, size_t(p * _samples.size()));
+        std::nth_element(_samples.begin(), _samples.begin() + index, _samples.end());
+        return _samples[index];
+    }
+
+    uint32_t max() const {
+        return _samples.empty() ? 0 : *std::max_element(_samples.begin(), _samples.end());
+    }
+
+    void print(const char *name) {
+        DBG("  %-20s %10zu samples %10.0f ns mean %10u ns p50 %10u ns p99 %10u ns max",
+            name, count(), mean(), unsigned(percentile(0.5f)), unsigned(percentile(0.99f)), unsigned(max()));
+    }
+
+private:
+    std::vector<uint32_t> _samples;
+};
+
+struct BenchmarkApp : private Engine::TickListener {
+    // drivers
+    ClockTimer clockTimer;
+    Adc adc;
+    Dac dac;
+    Dio dio;
+    GateOutput gateOutput;
+    Midi midi;
+    UsbMidi usbMidi;
+
+    uint8_t midiMessagePayloadPool[CONFIG_MIDI_PAYLOAD_POOL_SIZE];
+
+    // application
+    Model model;
+    Engine engine;
+
+    // measurements
+    LatencyStats updateStats;
+    LatencyStats tickStats;
+    LatencyStats trackTickStats;
+
+    BenchmarkApp() :
+        engine(model, clockTimer, adc, dac, dio, gateOutput, midi, usbMidi)
+    {
+        MidiMessage::setPayloadPool(midiMessagePayloadPool, sizeof(midiMessagePayloadPool));
+
+        model.init();
+        engine.init();
+        engine.setTickListener(this);
+    }
+
+    // firmware objects live in zero-initialized static memory, mirror that when allocating on the heap
+    static void *operator new(size_t size) { return std::calloc(1, size); }
+    static void operator delete(void *ptr) { std::free(ptr); }
+
+    void update() {
+        auto start = BenchmarkClock::now();
+        engine.update();
+        updateStats.push(elapsedNs(start));
+    }
+
+private:
+    // Engine::TickListener
+    void onTickBegin(uint32_t tick) override {
+        _tickStart = BenchmarkClock::now();
+    }
+
+    void onTickEnd(uint32_t tick) override {
+        tickStats.push(elapsedNs(_tickStart));
+    }
+
+    void onTrackTickBegin(int trackIndex) override {
+        _trackTickStart = BenchmarkClock::now();
+    }
+
+    void onTrackTickEnd(int trackIndex) override {
+        trackTickStats.push(elapsedNs(_trackTickStart));
+    }
+
+    BenchmarkClock::time_point _tickStart;
+    BenchmarkClock::time_point _trackTickStart;
+};
+
+template<typename Sequence>
+static void fillSequence(Sequence &sequence, Random &rng) {
+    sequence.setFirstStep(0);
+    sequence.setLastStep(CONFIG_STEP_COUNT - 1);
+    for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+        auto &step = sequence.step(stepIndex);
+        for (int layerIndex = 0; layerIndex < int(Sequence::Layer::Last); ++layerIndex) {
+            auto layer = typename Sequence::Layer(layerIndex);
+            auto range = Sequence::layerRange(layer);
+            step.setLayerValue(layer, range.min + int(rng.nextRange(range.max - range.min + 1)));
+        }
+    }
+}
+
+template<typename TrackType>
+static void fillTrack(TrackType &track, Random &rng) {
+    for (int patternIndex = 0; patternIndex < CONFIG_PATTERN_COUNT; ++patternIndex) {
+        fillSequence(track.sequence(patternIndex), rng);
+    }
+}
+
+static void setupRouting(Routing &routing) {
+    static const Routing::Target targets[CONFIG_ROUTE_COUNT] = {
+        Routing::Target::Swing,
+        Routing::Target::Fill,
+        Routing::Target::FillAmount,
+        Routing::Target::SlideTime,
+        Routing::Target::Octave,
+        Routing::Target::Transpose,
+        Routing::Target::Offset,
+        Routing::Target::Rotate,
+        Routing::Target::GateProbabilityBias,
+        Routing::Target::RetriggerProbabilityBias,
+        Routing::Target::LengthBias,
+        Routing::Target::NoteProbabilityBias,
+        Routing::Target::ShapeProbabilityBias,
+        Routing::Target::CurveMin,
+        Routing::Target::CurveMax,
+        Routing::Target::RootNote,
+    };
+
+    int sourceCount = int(Routing::Source::CvLast) - int(Routing::Source::CvFirst) + 1;
+
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        auto &route = routing.route(routeIndex);
+        route.setTarget(targets[routeIndex % CONFIG_ROUTE_COUNT]);
+        route.setTracks((1 << CONFIG_TRACK_COUNT) - 1);
+        route.setSource(Routing::Source(int(Routing::Source::CvFirst) + routeIndex % sourceCount));
+        route.cvSource().setRange(Types::VoltageRange::Bipolar5V);
+    }
+}
+
+static void setupProject(Project &project, Track::TrackMode trackMode, float bpm) {
+    Random rng(0x1234);
+
+    project.setTempo(bpm);
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, trackMode);
+        auto &track = project.track(trackIndex);
+        switch (trackMode) {
+        case Track::TrackMode::Note:
+            fillTrack(track.noteTrack(), rng);
+            break;
+        case Track::TrackMode::Curve:
+            fillTrack(track.curveTrack(), rng);
+            break;
+        case Track::TrackMode::Stochastic:
+            fillTrack(track.stochasticTrack(), rng);
+            break;
+        case Track::TrackMode::Logic:
+            fillTrack(track.logicTrack(), rng);
+            break;
+        case Track::TrackMode::Arp:
+            fillTrack(track.arpTrack(), rng);
+            break;
+        case Track::TrackMode::MidiCv:
+        case Track::TrackMode::Last:
+            break;
+        }
+    }
+
+    setupRouting(project.routing());
+}
+
+static void runBenchmark(Track::TrackMode trackMode, float bpm, int minutes) {
+    std::unique_ptr<BenchmarkApp> app;
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new BenchmarkApp());
+            setupProject(app->model.project(), trackMode, bpm);
+            app->engine.clockStart();
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+
+    // modulate CV inputs so routes see changing source values
+    simulator.addUpdateCallback([&] () {
+        float phase = simulator.ticks() * 0.001f;
+        for (int channel = 0; channel < CONFIG_CV_INPUT_CHANNELS; ++channel) {
+            simulator.setAdc(channel, 5.f * std::sin(phase * (channel + 1)));
+        }
+    });
+
+    simulator.wait(minutes * 60 * 1000);
+
+    DBG("%s tracks @ %.1f bpm (%d min, %u ticks)", Track::trackModeName(trackMode), bpm, minutes, unsigned(app->engine.tick()));
+    app->updateStats.print("engine update");
+    app->tickStats.print("engine tick");
+    app->trackTickStats.print("track tick");
+
+    auto stats = app->engine.stats();
+    DBG("  %-20s %10u evaluated %10u skipped", "routes", unsigned(stats.routesEvaluated), unsigned(stats.routesSkipped));
+}
+
+static void setupMidiRouting(Routing &routing, int routeCount) {
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        auto &route = routing.route(routeIndex);
+        if (routeIndex >= routeCount) {
+            route.clear();
+            continue;
+        }
+        route.setSource(Routing::Source::Midi);
+        auto &midiSource = route.midiSource();
+        midiSource.source().setPort(Types::MidiPort::Midi);
+        midiSource.source().setChannel(routeIndex % 2 == 0 ? -1 : 0);
+        midiSource.setEvent(Routing::MidiSource::Event::ControlAbsolute);
+        midiSource.setControlNumber(routeIndex);
+    }
+}
+
+static void runMidiBenchmark(int routeCount, int minutes) {
+    std::unique_ptr<BenchmarkApp> app;
+    LatencyStats dispatchStats;
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new BenchmarkApp());
+            setupProject(app->model.project(), Track::TrackMode::Note, 120.f);
+            setupMidiRouting(app->model.project().routing(), routeCount);
+            app->engine.clockStart();
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+
+    // send one CC message per millisecond (3 kB/s), cycling through the controllers of all routes
+    simulator.addUpdateCallback([&] () {
+        uint32_t ticks = simulator.ticks();
+        auto message = MidiMessage::makeControlChange(0, ticks % CONFIG_ROUTE_COUNT, ticks % 128);
+
+        // dispatch directly to the routing engine (once) to measure the dispatch cost in isolation
+        auto start = BenchmarkClock::now();
+        app->engine.routingEngine().receiveMidi(MidiPort::Midi, message);
+        dispatchStats.push(elapsedNs(start));
+    });
+
+    simulator.wait(minutes * 60 * 1000);
+
+    DBG("MIDI CC flood @ 3 kB/s with %d MIDI routes (%d min)", routeCount, minutes);
+    app->updateStats.print("engine update");
+    dispatchStats.print("midi dispatch");
+}
+
+// dense note stream alternating 4 note chords and a fast arpeggio over a 3 octave range
+struct NoteStream {
+    struct Event {
+        bool noteOn;
+        uint8_t note;
+    };
+
+    uint32_t step = 0;
+    std::vector<uint8_t> held;
+
+    Event next() {
+        ++step;
+        bool chord = (step / 64) % 2 == 0;
+        size_t maxHeld = chord ? 4 : 2;
+        if (held.size() >= maxHeld || (!held.empty() && step % 3 == 0)) {
+            uint8_t note = held.front();
+            held.erase(held.begin());
+            return { false, note };
+        }
+        uint8_t note = chord ?
+            48 + (step / 8) % 12 + 4 * (held.size() % 3) + 12 * (held.size() / 3) :
+            48 + (step * 7) % 36;
+        if (std::find(held.begin(), held.end(), note) == held.end()) {
+            held.emplace_back(note);
+        }
+        return { true, note };
+    }
+};
+
+template<size_t VoiceCount>
+static void runVoiceAllocatorBenchmark(int outputCount) {
+    const int Events = 100000;
+    const char *priorityNames[] = { "last note", "first note", "lowest note", "highest note" };
+
+    DBG("Voice allocation (%d voices, %d outputs, cost per note event)", int(VoiceCount), outputCount);
+    for (int priority = 0; priority < 4; ++priority) {
+        VoiceAllocator<VoiceCount> allocator;
+        allocator.setPriority(typename VoiceAllocator<VoiceCount>::Priority(priority));
+        allocator.setOutputCount(outputCount);
+
+        NoteStream stream;
+        LatencyStats stats;
+        for (int i = 0; i < Events; ++i) {
+            auto event = stream.next();
+            auto start = BenchmarkClock::now();
+            if (event.noteOn) {
+                allocator.noteOn(event.note, 100, i);
+            } else {
+                allocator.noteOff(event.note);
+            }
+            stats.push(elapsedNs(start));
+        }
+        stats.print(priorityNames[priority]);
+    }
+}
+
+static void runMidiCvBenchmark(int minutes) {
+    std::unique_ptr<BenchmarkApp> app;
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new BenchmarkApp());
+            auto &project = app->model.project();
+            for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+                project.setTrackMode(trackIndex, Track::TrackMode::MidiCv);
+                auto &midiCvTrack = project.track(trackIndex).midiCvTrack();
+                midiCvTrack.setVoices(8);
+                midiCvTrack.setVoiceConfig(MidiCvTrack::VoiceConfig::PitchVelocityPressure);
+                midiCvTrack.setNotePriority(MidiCvTrack::NotePriority(trackIndex % 4));
+            }
+            app->engine.clockStart();
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+
+    // send one note event per millisecond to all MIDI/CV tracks
+    NoteStream stream;
+    simulator.addUpdateCallback([&] () {
+        auto event = stream.next();
+        simulator.sendMidi(0, event.noteOn ? MidiMessage::makeNoteOn(0, event.note, 100) : MidiMessage::makeNoteOff(0, event.note));
+    });
+
+    simulator.wait(minutes * 60 * 1000);
+
+    DBG("MIDI/CV tracks with chord/arp stream @ 1000 notes/s (%d min)", minutes);
+    app->updateStats.print("engine update");
+}
+
+static void runCurveBenchmark() {
+    const int Samples = 192;
+    const int Rounds = 1000;
+    volatile float sink = 0.f;
+
+    auto measure = [&] (const char *name, float (*eval)(Curve::Type, float)) {
+        LatencyStats stats;
+        for (int round = 0; round < Rounds; ++round) {
+            for (int type = 0; type < Curve::Last; ++type) {
+                auto start = BenchmarkClock::now();
+                float sum = 0.f;
+                for (int i = 0; i < Samples; ++i) {
+                    sum += eval(Curve::Type(type), float(i) / Samples);
+                }
+                stats.push(elapsedNs(start));
+                sink = sink + sum;
+            }
+        }
+        stats.print(name);
+    };
+
+    DBG("Curve evaluation (cost of %d samples per step, all curve types)", Samples);
+    measure("float functions", &Curve::eval);
+    measure("wavetables", &Curve::evalTable);
+}
+
+static void runScaleBenchmark() {
+    const int Rounds = 100;
+    const int RootNote = 3;
+    volatile int sink = 0;
+
+    auto measure = [&] (const char *name, int (*quantize)(const Scale &scale, int rootNote)) {
+        LatencyStats stats;
+        for (int round = 0; round < Rounds; ++round) {
+            for (int scaleIndex = 0; scaleIndex < Scale::Count; ++scaleIndex) {
+                auto start = BenchmarkClock::now();
+                int result = quantize(Scale::get(scaleIndex), RootNote);
+                stats.push(elapsedNs(start));
+                sink = sink + result;
+            }
+        }
+        stats.print(name);
+    };
+
+    // MIDI note to scale note and back to volts as done when recording and monitoring,
+    // and volts to scale note as done when quantizing CV input
+    DBG("Scale quantization (cost of 128 MIDI notes and 128 voltages, all scales)");
+    measure("scale", [] (const Scale &scale, int rootNote) {
+        int sum = 0;
+        for (int midiNote = 0; midiNote < 128; ++midiNote) {
+            int note = scale.noteFromVolts((midiNote - 60 - (scale.isChromatic() ? rootNote : 0)) * (1.f / 12.f));
+            float volts = scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+            sum += note + int(volts) + scale.noteFromVolts(midiNote * (10.f / 128.f) - 5.f);
+        }
+        return sum;
+    });
+    measure("quantizer table", [] (const Scale &scale, int rootNote) {
+        const auto &quantizer = QuantizerTable::get(scale, rootNote);
+        int sum = 0;
+        for (int midiNote = 0; midiNote < 128; ++midiNote) {
+            int note = quantizer.noteFromMidiNote(midiNote);
+            float volts = quantizer.noteToVolts(note);
+            sum += note + int(volts) + quantizer.noteFromVolts(midiNote * (10.f / 128.f) - 5.f);
+        }
+        return sum;
+    });
+}
+
+int main(int argc, char *argv[]) {
+    HighResolutionTimer::init();
+
+    int minutes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+
+    std::vector<float> bpms;
+    for (int i = 2; i < argc; ++i) {
+        bpms.emplace_back(std::atof(argv[i]));
+    }
+    if (bpms.empty()) {
+        bpms = { 120.f, 200.f, 300.f };
+    }
+
+    DBG("----------------------------------------");
+    DBG("Engine Benchmark");
+    DBG("----------------------------------------");
+
+    for (int trackModeIndex = 0; trackModeIndex < int(Track::TrackMode::Last); ++trackModeIndex) {
+        for (auto bpm : bpms) {
+            runBenchmark(Track::TrackMode(trackModeIndex), bpm, minutes);
+        }
+    }
+
+    for (int routeCount : { 1, CONFIG_ROUTE_COUNT / 2, CONFIG_ROUTE_COUNT }) {
+        runMidiBenchmark(routeCount, minutes);
+    }
+
+    runMidiCvBenchmark(minutes);
+    runVoiceAllocatorBenchmark<8>(8);
+    runVoiceAllocatorBenchmark<32>(16);
+
+    runCurveBenchmark();
+    runScaleBenchmark();
+
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include "core/math/Math.h"
 
 #include "model/ArpSequence.h"
+#include "model/QuantizerTable.h"
 #include "model/Scale.h"
 #include "ui/MatrixMap.h"
 #include <climits>
@@ -22,10 +23,6 @@
 
 static Random rng;
 
-bool sortTaskByProbRev(const ArpStep& lhs, const ArpStep& rhs) {
-    return lhs.probability() > rhs.probability();
-}
-
 // evaluate if step gate is active
 static bool evalStepGate(const ArpSequence::Step &step, int probabilityBias) {
     int probability = clamp(step.gateProbability() + probabilityBias, -1, ArpSequence::GateProbability::Max);
@@ -45,36 +42,15 @@ static bool evalMIDIStepGate(const ArpSequence::Step &step, int probabilityBias)
 
 // evaluate if step gate is active
  int ArpTrackEngine::evalRestProbability(ArpSequence &sequence) {
-    int sum = 0;
-    std::vector<ArpStep> probability;
-    for (int i = 0; i < 4; i++) {
-
-        switch (i) {
-            case 0: {
-                probability.insert(probability.end(), ArpStep(i, sequence.restProbability()));
-            }
-                break;
-            case 1: {
-                probability.insert(probability.end(), ArpStep(i, sequence.restProbability2()));
-                break;
-            }
-            case 2: {
-                probability.insert(probability.end(), ArpStep(i, sequence.restProbability4()));
-                break;
-            }
-            case 3: {
-                probability.insert(probability.end(), ArpStep(i, sequence.restProbability8()));
-                break;
-            }
-            default:
-                break;
-        }
-
-        sum = sum + probability.at(i).probability();
-    }
-    if (sum==0) { return -1;}
-    std::sort (std::begin(probability), std::end(probability), sortTaskByProbRev);
-    int stepIndex = getNextWeightedPitch(probability, probability.size());
+    int probabilities[4] = {
+        sequence.restProbability(),
+        sequence.restProbability2(),
+        sequence.restProbability4(),
+        sequence.restProbability8()
+    };
+    _restSampler.setWeights(probabilities, 4);
+    if (_restSampler.total() == 0) { return -1;}
+    int stepIndex = _restSampler.sample(rng);
     switch (stepIndex) {
         case 0:
             return 0;
@@ -132,16 +108,17 @@ static int evalStepLength(const ArpSequence::Step &step, int lengthBias) {
 }
 
 // evaluate transposition
-static int evalTransposition(const Scale &scale, int octave, int transpose) {
-    return octave * scale.notesPerOctave() + transpose;
+static int evalTransposition(const QuantizerTable &quantizer, int octave, int transpose) {
+    return octave * quantizer.notesPerOctave() + transpose;
 }
 
 // evaluate note voltage
-static float evalStepNote(const ArpSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, ArpSequence sequence, bool useVariation = true) {
+static float evalStepNote(const ArpSequence::Step &step, int probabilityBias, const QuantizerTable &quantizer, int rootNote, int octave, int transpose, ArpSequence sequence, bool useVariation = true) {
 
     if (step.bypassScale()) {
+        // bypassing the scale quantizes to semitones, which does not need a (cached) quantizer table
         const Scale &bypassScale = Scale::get(0);
-        int note = step.note() + evalTransposition(bypassScale, octave, transpose);
+        int note = step.note() + octave * bypassScale.notesPerOctave() + transpose;
         int probability = clamp(step.noteOctaveProbability() + probabilityBias, -1, ArpSequence::NoteOctaveProbability::Max);
         if (step.noteOctaveProbability()==0) {
             probability = 0;
@@ -155,12 +132,12 @@ static float evalStepNote(const ArpSequence::Step &step, int probabilityBias, co
         }
         if (useVariation && int(rng.nextRange(ArpSequence::NoteVariationProbability::Range)) <= probability) {
             int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
-            int offsetOctave = roundDownDivide(offset, scale.notesPerOctave());
-            int offSetCleared = offset - (offsetOctave*scale.notesPerOctave());
-            while (!scale.isNotePresent(offSetCleared)) {
+            int offsetOctave = roundDownDivide(offset, quantizer.notesPerOctave());
+            int offSetCleared = offset - (offsetOctave*quantizer.notesPerOctave());
+            while (!quantizer.isNotePresent(offSetCleared)) {
                 offset++;
-                offsetOctave = roundDownDivide(offset, scale.notesPerOctave());
-                offSetCleared = offset - (offsetOctave*scale.notesPerOctave());
+                offsetOctave = roundDownDivide(offset, quantizer.notesPerOctave());
+                offSetCleared = offset - (offsetOctave*quantizer.notesPerOctave());
             }
             if (step.noteVariationRange() < 0) {
                 offset = -offset;
@@ -169,11 +146,11 @@ static float evalStepNote(const ArpSequence::Step &step, int probabilityBias, co
         }
         return bypassScale.noteToVolts(note) + (bypassScale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
     }
-    int note = step.note() + evalTransposition(scale, octave, transpose);
+    int note = step.note() + evalTransposition(quantizer, octave, transpose);
     int probability = clamp(step.noteOctaveProbability() + probabilityBias, -1, ArpSequence::NoteOctaveProbability::Max);
     if (useVariation && int(rng.nextRange(ArpSequence::NoteOctaveProbability::Range)) <= probability && probability != 0) {
         int oct = step.noteOctave() + sequence.lowOctaveRange() + ( std::rand() % ( sequence.highOctaveRange() - sequence.lowOctaveRange() + 1 ) );
-        note = ArpSequence::Note::clamp(note + (scale.notesPerOctave()*oct));
+        note = ArpSequence::Note::clamp(note + (quantizer.notesPerOctave()*oct));
     }
     if (useVariation && int(rng.nextRange(ArpSequence::NoteVariationProbability::Range)) <= probability) {
         int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
@@ -182,28 +159,9 @@ static float evalStepNote(const ArpSequence::Step &step, int probabilityBias, co
         }
         note = NoteSequence::Note::clamp(note + offset);
     }
-    return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    return quantizer.noteToVolts(note);
 }
 
-int ArpTrackEngine::getNextWeightedPitch(std::vector<ArpStep> distr, int notesPerOctave) {
-        int total_weights = 0;
-
-        for(int i = 0; i < notesPerOctave; i++) {
-            total_weights += distr.at(i % notesPerOctave).probability();
-        }
-
-        int rnd = rng.nextRange(total_weights);
-
-        for(int i = 0; i < notesPerOctave; i++) {
-            int weight = distr.at(i % notesPerOctave).probability();
-            if (rnd <= weight && weight > 0) {
-                return distr.at(i % notesPerOctave).index();
-            }
-            rnd -= weight;
-        }
-        return -1;
-    }
-
 void ArpTrackEngine::reset() {
     _freeRelativeTick = 0;
     _sequenceState.reset();
@@ -233,7 +191,7 @@ void ArpTrackEngine::reset() {
 
     for (int i = 0; i < int(_notes.size()); ++i) {
         ++_noteCount;
-        uint32_t order = _notes.at(i).order;
+        uint32_t order = _notes[i].order;
         if (order > _noteOrder) {
             _noteOrder = order + 1;
         }
@@ -323,28 +281,27 @@ TrackEngine::TickResult ArpTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         if (!_monitorOverrideActive) {
             result |= TickResult::GateUpdate;
-            _activity = _gateQueue.front().gate;
+            _activity = gate.gate;
             _gateOutput = (!mute() || fill()) && _activity;
             midiOutputEngine.sendGate(_track.trackIndex(), _gateOutput);
         }
-        _gateQueue.pop();
-
     }
 
-    while (!_cvQueue.empty() && tick >= _cvQueue.front().tick) {
+    Cv cv;
+    while (_cvQueue.pop(tick, cv)) {
         if (!mute() || _arpTrack.cvUpdateMode() == ArpTrack::CvUpdateMode::Always) {
             if (!_monitorOverrideActive) {
                 result |= TickResult::CvUpdate;
-                _cvOutputTarget = _cvQueue.front().cv;
-                _slideActive = _cvQueue.front().slide;
+                _cvOutputTarget = cv.cv;
+                _slideActive = cv.slide;
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
         }
-        _cvQueue.pop();
     }
 
     return result;
@@ -355,8 +312,8 @@ void ArpTrackEngine::update(float dt) {
     bool running = _engine.state().running();
 
     const auto &sequence = *_sequence;
-    const auto &scale = sequence.selectedScale(_model.project().scale());
     int rootNote = sequence.selectedRootNote(_model.project().rootNote());
+    const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
     int octave = _arpTrack.octave();
     int transpose = _arpTrack.transpose();
 
@@ -399,10 +356,10 @@ void ArpTrackEngine::update(float dt) {
 
     if (stepMonitoring) {
         const auto &step = sequence.step(_monitorStepIndex);
-        setOverride(evalStepNote(step, 0, scale, rootNote, octave, transpose,  sequence, true));
+        setOverride(evalStepNote(step, 0, quantizer, rootNote, octave, transpose,  sequence, true));
     } else if (liveMonitoring && _recordHistory.isNoteActive() && !running) {
-        int note = noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(scale, octave, transpose);
-        setOverride(scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f));
+        int note = quantizer.noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(quantizer, octave, transpose);
+        setOverride(quantizer.noteToVolts(note));
     } else {
         clearOverride();
     }
@@ -425,12 +382,13 @@ void ArpTrackEngine::changePattern() {
     _fillSequence = &_arpTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
-void ArpTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
+void ArpTrackEngine::monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) {
     _noteCount = _notes.size();
-    _recordHistory.write(tick, message);
+    _recordHistory.write(tick, fraction, message);
 
     auto &sequence = *_sequence;
-    const auto &scale = sequence.selectedScale(_model.project().scale());
+    int rootNote = sequence.selectedRootNote(_model.project().rootNote());
+    const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
     int octave = _arpTrack.octave();
     int transpose = _arpTrack.transpose();
     
@@ -440,9 +398,9 @@ void ArpTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
     }
 
     if (message.isNoteOff()) {
-        int note = noteFromMidiNote(message.note())  + evalTransposition(scale, octave, transpose);
-        int octave = roundDownDivide(note, scale.notesPerOctave());
-        int stepNoteCleared = note - (octave*scale.notesPerOctave());
+        int note = quantizer.noteFromMidiNote(message.note())  + evalTransposition(quantizer, octave, transpose);
+        int octave = roundDownDivide(note, quantizer.notesPerOctave());
+        int stepNoteCleared = note - (octave*quantizer.notesPerOctave());
         if (sequence.step(stepNoteCleared).gate()) {
             return;
         }
@@ -452,10 +410,10 @@ void ArpTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
     }
 
     if (message.isNoteOn()) {
-        int note = noteFromMidiNote(message.note()) + evalTransposition(scale, octave, transpose);
+        int note = quantizer.noteFromMidiNote(message.note()) + evalTransposition(quantizer, octave, transpose);
         
-        int octave = roundDownDivide(note, scale.notesPerOctave());
-        int stepNoteCleared = note - (octave*scale.notesPerOctave());
+        int octave = roundDownDivide(note, quantizer.notesPerOctave());
+        int stepNoteCleared = note - (octave*quantizer.notesPerOctave());
         if (sequence.step(stepNoteCleared).gate()) {
             return;
         }
@@ -502,8 +460,8 @@ void ArpTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNextSt
 
     if (!_arpeggiator.hold() && !isKeyPressed()) {
         for (int i = 0; i < _noteCount; ++i) {
-            if (_notes.at(i).type == Type::MIDI) {
-                removeNote(_notes.at(i).note);
+            if (_notes[i].type == Type::MIDI) {
+                removeNote(_notes[i].note);
             }
         }
     }
@@ -551,7 +509,7 @@ void ArpTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNextSt
         }
     }
 
-    int sequenceStepIndex = _notes.at(_noteIndex).index;
+    int sequenceStepIndex = _notes[_noteIndex].index;
     _currentStep = sequenceStepIndex;
 
     const auto &step = evalSequence.step(sequenceStepIndex);
@@ -560,7 +518,7 @@ void ArpTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNextSt
     uint32_t stepTick = (int) tick + gateOffset;
 
     bool stepGate= false;
-    if (_notes.at(_noteIndex).type == Type::MIDI) {
+    if (_notes[_noteIndex].type == Type::MIDI) {
         stepGate = evalMIDIStepGate(step, _arpTrack.gateProbabilityBias()) || useFillGates;
     } else {
         stepGate = evalStepGate(step, _arpTrack.gateProbabilityBias()) || useFillGates;
@@ -598,9 +556,9 @@ void ArpTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNextSt
     }
 
     if (stepGate || _arpTrack.cvUpdateMode() == ArpTrack::CvUpdateMode::Always) {
-        const auto &scale = evalSequence.selectedScale(_model.project().scale());
         int rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
-        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _arpTrack.noteProbabilityBias(), scale, rootNote, _octave+octave+_notes.at(_noteIndex).octave, transpose, sequence), step.slide() });
+        const auto &quantizer = QuantizerTable::get(evalSequence.selectedScale(_model.project().scale()), rootNote);
+        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _arpTrack.noteProbabilityBias(), quantizer, rootNote, _octave+octave+_notes[_noteIndex].octave, transpose, sequence), step.slide() });
     }
 }
 
@@ -616,14 +574,14 @@ void ArpTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
 
     bool stepWritten = false;
 
-    auto writeStep = [this, divisor, &stepWritten] (int note, int lengthTicks) {
+    auto writeStep = [this, divisor, &stepWritten] (int note, float lengthTicks) {
 
         int stepNote = noteFromMidiNote(note);
         int octave = roundDownDivide(stepNote, 12);
         
         int stepNoteCleared = stepNote - (octave*12);
         auto &step = _sequence->step(stepNoteCleared);
-        int length = (lengthTicks * ArpSequence::Length::Range) / divisor;
+        int length = int((lengthTicks * ArpSequence::Length::Range) / divisor);
         step.setGate(true);
         step.setGateProbability(ArpSequence::GateProbability::Max);
         step.setRetrigger(0);
@@ -654,9 +612,9 @@ void ArpTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
         }
 
         int note = _recordHistory[i].note;
-        uint32_t noteStart = _recordHistory[i].tick;
-        uint32_t noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].tick : tick;
-        int length = noteEnd - noteStart;
+        float noteStart = _recordHistory[i].offset(tick);
+        float noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].offset(tick) : 0.f;
+        float length = noteEnd - noteStart;
         writeStep(note, length);
     }
     _recordHistory.clear();
@@ -670,11 +628,7 @@ int ArpTrackEngine::noteFromMidiNote(uint8_t midiNote) const {
     const auto &scale = _sequence->selectedScale(_model.project().scale());
     int rootNote = _sequence->selectedRootNote(_model.project().rootNote());
 
-    if (scale.isChromatic()) {
-        return scale.noteFromVolts((midiNote - 60 - rootNote) * (1.f / 12.f));
-    } else {
-        return scale.noteFromVolts((midiNote - 60) * (1.f / 12.f));
-    }
+    return QuantizerTable::get(scale, rootNote).noteFromMidiNote(midiNote);
 }
 
 void ArpTrackEngine::addNote(int note, int index, Type type, int octave) {
@@ -684,42 +638,32 @@ void ArpTrackEngine::addNote(int note, int index, Type type, int octave) {
         return;
     }
 
-    for (int i= 0; i < int(_notes.size()); ++i) {
-        if (_notes.at(i).note == note) {
-            return;
-        }
-    }
-
     Note n;
     n.note = note;
-    n.order = ++_noteOrder;
+    n.order = _noteOrder + 1;
     n.index = index;
     n.octave = octave;
     n.type = type;
 
-    _notes.insert(_notes.end(), n);
-
-    std::sort(_notes.begin(), _notes.end(), _note);
+    // insert into ordered note set, exit if note is already in note set
+    if (_notes.insert(n) == -1) {
+        return;
+    }
+    ++_noteOrder;
     ++_noteCount;
 }
 
 
 void ArpTrackEngine::removeNote(int note) {
-    int index = -1;
     _noteCount = _notes.size();
-    for (int i = 0; i < _noteCount; ++i) {
-        if (_arpeggiator.hold() && _arpTrack.midiKeyboard()) {
-            return;
-        }
-
-        if (_notes.at(i).note == note) {
-            index = i;
-            --_noteCount;
-            _notes.erase(_notes.begin() + index);
-            break;
-        }
+    // do not remove notes in hold mode when playing from the keyboard
+    if (_arpeggiator.hold() && _arpTrack.midiKeyboard()) {
+        return;
     }
 
+    if (_notes.remove(note)) {
+        --_noteCount;
+    }
 }
 
 int ArpTrackEngine::noteIndexFromOrder(int order) {
@@ -728,7 +672,7 @@ int ArpTrackEngine::noteIndexFromOrder(int order) {
     for (int noteIndex = 0; noteIndex < _noteCount; ++noteIndex) {
         int currentOrder = 0;
         for (int i = 0; i < _noteCount; ++i) {
-            if (_notes.at(i).order < _notes.at(noteIndex).order) {
+            if (_notes[i].order < _notes[noteIndex].order) {
                 ++currentOrder;
             }
         }
@@ -2,40 +2,20 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "EventScheduler.h"
 #include "Groove.h"
 #include "RecordHistory.h"
 #include "model/ArpSequence.h"
 #include "StepRecorder.h"
+#include "NoteSet.h"
+
+#include "core/utils/WeightedSampler.h"
+
 #include "model/Arpeggiator.h"
 #include <array>
 #include <cstdint>
-#include <map>
-#include <vector>
-
-
-class ArpStep {
-        public:
 
-            ArpStep() {}
-            ArpStep(int index, int probability) {
-                _index = index;
-                _probability = probability;
-            }
 
-            int index() {
-                return _index;
-            }
-
-            int probability() const {
-                return _probability;
-            }
-
-        private:
-            int _index;
-            int _probability;
-
-    };
 class ArpTrackEngine : public TrackEngine {
 public:
 
@@ -49,7 +29,6 @@ public:
         _arpTrack(track.arpTrack()),
         _arpeggiator(track.arpTrack().arpeggiator())
     {
-        _notes.reserve(12);
         reset();
     }
 
@@ -62,11 +41,13 @@ public:
 
     virtual void changePattern() override;
 
-    virtual void monitorMidi(uint32_t tick, const MidiMessage &message) override;
+    virtual void monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) override;
     virtual void clearMidiMonitoring() override;
 
     virtual const TrackLinkData *linkData() const override { return &_linkData; }
 
+    virtual uint32_t eventOverflowCount() const override { return _gateQueue.overflowCount() + _cvQueue.overflowCount(); }
+
     virtual bool activity() const override { return _activity; }
     virtual bool gateOutput(int index) const override { return _gateOutput; }
     virtual float cvOutput(int index) const override { return _cvOutput; }
@@ -97,16 +78,11 @@ public:
     int currentIndex() const { return _stepIndex; }
 
     void setKeyPressed(int i, bool val) {
-        _keyPressed[i] = val;
+        _keyPressed.set(i, val);
     }
 
-    bool isKeyPressed() {
-        for (auto const& x : _keyPressed)    {
-            if (x.second) {
-                return true;
-            }
-        }
-        return false;
+    bool isKeyPressed() const {
+        return _keyPressed.any();
     }
 
     void clearNotes() {
@@ -123,7 +99,6 @@ private:
     int noteIndexFromOrder(int order);
     void advanceStep();
     void advanceOctave();
-    int getNextWeightedPitch(std::vector<ArpStep> distr, int notesPerOctave = 12);
     int evalRestProbability(ArpSequence &sequence);
 
     bool fill() const {
@@ -157,6 +132,7 @@ private:
     unsigned int _currentStageRepeat;
 
     int _skips;
+    WeightedSampler<4> _restSampler;
 
     const Arpeggiator &_arpeggiator;
 
@@ -166,13 +142,11 @@ private:
         uint8_t index;
         int8_t octave;
         Type type;
-
-        bool operator() (Note i,Note j) { return (i.note < j.note);}
-    } _note;
+    };
 
     static constexpr int MaxNotes = 12;
 
-    std::vector<Note> _notes;
+    NoteSet<Note, MaxNotes> _notes;
 
     int _stepIndex;
     int _noteIndex;
@@ -181,7 +155,7 @@ private:
     int8_t _octave;
     int8_t _octaveDirection;
 
-    std::map<int32_t, bool> _keyPressed;
+    KeySet _keyPressed;
 
     int _prevPattern = 0;
 
@@ -192,13 +166,7 @@ private:
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    EventScheduler<Gate, 32> _gateQueue;
 
     struct Cv {
         uint32_t tick;
@@ -206,11 +174,5 @@ private:
         bool slide;
     };
 
-    struct CvCompare {
-        bool operator()(const Cv &a, const Cv &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Cv, 16, CvCompare> _cvQueue;
+    EventScheduler<Cv, 16> _cvQueue;
 };
@@ -26,7 +26,7 @@ void ArpeggiatorEngine::reset() {
     _octave = 0;
     _octaveDirection = 0;
 
-    _noteCount = 0;
+    _notes.clear();
     _noteHoldCount = 0;
 }
 
@@ -51,14 +51,14 @@ void ArpeggiatorEngine::tick(uint32_t tick, int swing) {
     uint32_t divisor = _arpeggiator.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
 
     if (tick % divisor == 0) {
-        if (_noteCount > 0) {
+        if (noteCount() > 0) {
             advanceStep();
             if (_stepIndex == 0) {
                 advanceOctave();
             }
 
             // flip pattern direction when going down octaves
-            int noteIndex = _octaveDirection == -1 ? _noteCount - _noteIndex - 1 : _noteIndex;
+            int noteIndex = _octaveDirection == -1 ? noteCount() - _noteIndex - 1 : _noteIndex;
 
             uint8_t note = uint8_t(clamp(_notes[noteIndex].note + _octave * 12, 0, 127));
             uint32_t length = std::max(uint32_t(1), uint32_t((divisor * _arpeggiator.gateLength()) / 100));
@@ -71,63 +71,36 @@ void ArpeggiatorEngine::tick(uint32_t tick, int swing) {
 }
 
 bool ArpeggiatorEngine::getEvent(uint32_t tick, Event &event) {
-    if (!_eventQueue.empty() && tick >= _eventQueue.front().tick) {
-        event = _eventQueue.front();
-        _eventQueue.pop();
-        return true;
-    }
-    return false;
+    return _eventQueue.pop(tick, event);
 }
 
 void ArpeggiatorEngine::addNote(int note) {
-    // exit if note set is full
-    if (_noteCount >= MaxNotes) {
+    // insert into ordered note set, exit if note set is full or note is already in note set
+    if (_notes.insert({ uint8_t(note), _noteOrder }) == -1) {
         return;
     }
-
-    // find insert position
-    int pos = 0;
-    while (pos < _noteCount && note > _notes[pos].note) {
-        ++pos;
-    }
-
-    // exit if note is already in note set
-    if (pos < _noteCount && note == _notes[pos].note) {
-        return;
-    }
-
-    // insert into ordered note set
-    ++_noteCount;
+    ++_noteOrder;
     ++_noteHoldCount;
-    for (int i = _noteCount - 1; i > pos; --i) {
-        _notes[i] = _notes[i - 1];
-    }
-    _notes[pos].note = note;
-    _notes[pos].order = _noteOrder++;
 }
 
 void ArpeggiatorEngine::removeNote(int note) {
-    for (int i = 0; i < _noteCount; ++i) {
-        if (note == _notes[i].note) {
-            _noteHoldCount = _noteHoldCount > 0 ? _noteHoldCount - 1 : 0;
-            // do not remove note in hold mode
-            if (_arpeggiator.hold()) {
-                return;
-            }
-            --_noteCount;
-            for (int j = i; j < _noteCount; ++j) {
-                _notes[j] = _notes[j + 1];
-            }
-            return;
-        }
+    int index = _notes.find(note);
+    if (index == -1) {
+        return;
+    }
+    _noteHoldCount = _noteHoldCount > 0 ? _noteHoldCount - 1 : 0;
+    // do not remove note in hold mode
+    if (_arpeggiator.hold()) {
+        return;
     }
+    _notes.erase(index);
 }
 
 int ArpeggiatorEngine::noteIndexFromOrder(int order) {
     // search note index of note with given relative order
-    for (int noteIndex = 0; noteIndex < _noteCount; ++noteIndex) {
+    for (int noteIndex = 0; noteIndex < noteCount(); ++noteIndex) {
         int currentOrder = 0;
-        for (int i = 0; i < _noteCount; ++i) {
+        for (int i = 0; i < noteCount(); ++i) {
             if (_notes[i].order < _notes[noteIndex].order) {
                 ++currentOrder;
             }
@@ -141,7 +114,7 @@ int ArpeggiatorEngine::noteIndexFromOrder(int order) {
 
 void ArpeggiatorEngine::printNotes() {
     DBG("notes:");
-    for (int i = 0; i < _noteCount; ++i) {
+    for (int i = 0; i < noteCount(); ++i) {
         DBG("note: %" PRIu8 ", order: %" PRIu32, _notes[i].note, _notes[i].order);
     }
 }
@@ -153,45 +126,45 @@ void ArpeggiatorEngine::advanceStep() {
 
     switch (mode) {
     case Arpeggiator::Mode::PlayOrder:
-        _stepIndex = (_stepIndex + 1) % _noteCount;
+        _stepIndex = (_stepIndex + 1) % noteCount();
         _noteIndex = noteIndexFromOrder(_stepIndex);
         break;
     case Arpeggiator::Mode::Up:
     case Arpeggiator::Mode::Down:
-        _stepIndex = (_stepIndex + 1) % _noteCount;
+        _stepIndex = (_stepIndex + 1) % noteCount();
         _noteIndex = _stepIndex;
         break;
     case Arpeggiator::Mode::UpDown:
     case Arpeggiator::Mode::DownUp:
-        if (_noteCount >= 2) {
-            _stepIndex = (_stepIndex + 1) % ((_noteCount - 1) * 2);
-            _noteIndex = _stepIndex % (_noteCount - 1);
-            _noteIndex = _stepIndex < _noteCount - 1 ? _noteIndex : _noteCount - _noteIndex - 1;
+        if (noteCount() >= 2) {
+            _stepIndex = (_stepIndex + 1) % ((noteCount() - 1) * 2);
+            _noteIndex = _stepIndex % (noteCount() - 1);
+            _noteIndex = _stepIndex < noteCount() - 1 ? _noteIndex : noteCount() - _noteIndex - 1;
         } else {
             _stepIndex = 0;
         }
         break;
     case Arpeggiator::Mode::UpAndDown:
     case Arpeggiator::Mode::DownAndUp:
-        _stepIndex = (_stepIndex + 1) % (_noteCount * 2);
-        _noteIndex = _stepIndex % _noteCount;
-        _noteIndex = _stepIndex < _noteCount ? _noteIndex : _noteCount - _noteIndex - 1;
+        _stepIndex = (_stepIndex + 1) % (noteCount() * 2);
+        _noteIndex = _stepIndex % noteCount();
+        _noteIndex = _stepIndex < noteCount() ? _noteIndex : noteCount() - _noteIndex - 1;
         break;
     case Arpeggiator::Mode::Converge:
-        _stepIndex = (_stepIndex + 1) % _noteCount;
+        _stepIndex = (_stepIndex + 1) % noteCount();
         _noteIndex = _stepIndex / 2;
         if (_stepIndex % 2 == 1) {
-            _noteIndex = _noteCount - _noteIndex - 1;
+            _noteIndex = noteCount() - _noteIndex - 1;
         }
         break;
     case Arpeggiator::Mode::Diverge:
-        _stepIndex = (_stepIndex + 1) % _noteCount;
+        _stepIndex = (_stepIndex + 1) % noteCount();
         _noteIndex = _stepIndex / 2;
-        _noteIndex = _noteCount / 2 + ((_stepIndex % 2 == 0) ? _noteIndex : - _noteIndex - 1);
+        _noteIndex = noteCount() / 2 + ((_stepIndex % 2 == 0) ? _noteIndex : - _noteIndex - 1);
         break;
     case Arpeggiator::Mode::Random:
-        _stepIndex = (_stepIndex + 1) % _noteCount;
-        _noteIndex = rng.nextRange(_noteCount);
+        _stepIndex = (_stepIndex + 1) % noteCount();
+        _noteIndex = rng.nextRange(noteCount());
         break;
     case Arpeggiator::Mode::Last:
         break;
@@ -201,7 +174,7 @@ void ArpeggiatorEngine::advanceStep() {
     case Arpeggiator::Mode::Down:
     case Arpeggiator::Mode::DownUp:
     case Arpeggiator::Mode::DownAndUp:
-        _noteIndex = _noteCount - _noteIndex - 1;
+        _noteIndex = noteCount() - _noteIndex - 1;
         break;
     default:
         break;
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "SortedQueue.h"
+#include "EventScheduler.h"
+#include "NoteSet.h"
 
 #include "model/Arpeggiator.h"
 
@@ -31,6 +32,8 @@ public:
 
     bool getEvent(uint32_t tick, Event &event);
 
+    uint32_t eventOverflowCount() const { return _eventQueue.overflowCount(); }
+
 private:
     void addNote(int note);
     void removeNote(int note);
@@ -40,6 +43,8 @@ private:
     void advanceStep();
     void advanceOctave();
 
+    int noteCount() const { return int(_notes.size()); }
+
     static constexpr int MaxNotes = 8;
 
     const Arpeggiator &_arpeggiator;
@@ -55,15 +60,8 @@ private:
         uint32_t order;
     };
 
-    std::array<Note, MaxNotes> _notes;
-    int8_t _noteCount;
+    NoteSet<Note, MaxNotes> _notes;
     int8_t _noteHoldCount;
 
-    struct EventCompare {
-        bool operator()(const Event &a, const Event &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Event, 16, EventCompare> _eventQueue;
+    EventScheduler<Event, 16> _eventQueue;
 };
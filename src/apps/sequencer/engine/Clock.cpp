@@ -296,6 +296,32 @@ Clock::Event Clock::checkEvent() {
 
 #undef CHECK
 
+uint32_t Clock::tickAt(uint32_t us, float *fraction) const {
+    uint32_t tick;
+    uint32_t tickUs;
+    {
+        os::InterruptLock lock;
+        tick = _tick;
+        tickUs = _tickUs;
+    }
+
+    *fraction = 0.f;
+    if (tick == 0) {
+        return 0;
+    }
+    if (!isRunning()) {
+        return tick - 1;
+    }
+
+    // ticks relative to the last output tick (tick - 1), bounded by the start of the clock and the next tick
+    float ticks = int32_t(us - tickUs) / (tickDuration() * 1000000.f);
+    ticks = clamp(ticks, -float(tick - 1), 0.999f);
+
+    float whole = std::floor(ticks);
+    *fraction = ticks - whole;
+    return tick - 1 + int32_t(whole);
+}
+
 bool Clock::checkTick(uint32_t *tick) {
     os::InterruptLock lock;
 
@@ -316,6 +342,7 @@ void Clock::onClockTimerTick() {
     case State::MasterRunning: {
         outputTick(_tick);
         ++_tick;
+        _tickUs = ClockTimer::us();
         _elapsedUs += _timer.period();
         break;
     }
@@ -325,6 +352,7 @@ void Clock::onClockTimerTick() {
         if (_slaveSubTicksPending > 0 && _elapsedUs >= _nextSlaveSubTickUs) {
             outputTick(_tick);
             ++_tick;
+            _tickUs = ClockTimer::us();
             --_slaveSubTicksPending;
             _nextSlaveSubTickUs += _slaveSubTickPeriodUs;
         }
@@ -342,6 +370,7 @@ void Clock::onClockTimerTick() {
 void Clock::resetTicks() {
     _tick = 0;
     _tickProcessed = 0;
+    _tickUs = 0;
     _slaveSubTicksPending = 0;
     _output.nextTick = 0;
 }
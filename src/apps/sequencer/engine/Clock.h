@@ -56,6 +56,9 @@ public:
     uint32_t tick() const { return _tick; }
     float tickDuration() const { return 60.f / (bpm() * _ppqn); }
 
+    // convert a time (ClockTimer::us()) to a clock tick, returns the fractional part of the tick in fraction
+    uint32_t tickAt(uint32_t us, float *fraction) const;
+
     // Master clock control
     void masterStart();
     void masterStop();
@@ -148,6 +151,7 @@ private:
 
     volatile uint32_t _tick;
     volatile uint32_t _tickProcessed;
+    volatile uint32_t _tickUs; // time of last tick (ClockTimer::us())
 
     volatile int32_t _activeSlave = -1;
 
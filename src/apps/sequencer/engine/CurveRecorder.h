@@ -65,7 +65,7 @@ public:
             float x = 0.f;
             for (uint32_t i = 0; i < RecordBufferLength; ++i) {
                 float yn = (_buffer[i] - curveMin) / (curveMax - curveMin);
-                float y = Curve::eval(type, x);
+                float y = Curve::evalTable(type, x);
                 error += (yn - y) * (yn - y);
                 x += (1.f / RecordBufferLength);
             }
@@ -14,18 +14,9 @@
 
 static Random rng;
 
-static float evalStepShape(const CurveSequence::Step &step, bool variation, bool invert, float fraction, int direction) {
-    auto function = Curve::function(Curve::Type(variation ? step.shapeVariation() : step.shape()));
-    if (direction == -1) {
-        function = Curve::function(Curve::Type(variation ? step.shapeVariation() : Curve::revAt(step.shape())));
-    }
-    float value = function(fraction);
-    if (invert) {
-        value = 1.f - value;
-    }
-    float min = float(step.min()) / CurveSequence::Min::Max;
-    float max = float(step.max()) / CurveSequence::Max::Max;
-    return min + value * (max - min);
+// step parameters affecting the output of a step
+static uint32_t stepKey(const CurveSequence::Step &step) {
+    return step.shape() | (step.shapeVariation() << 6) | (step.min() << 12) | (step.max() << 20);
 }
 
 static bool evalShapeVariation(const CurveSequence::Step &step, int probabilityBias) {
@@ -46,6 +37,7 @@ void CurveTrackEngine::reset() {
     _fillMode = CurveTrack::FillMode::None;
     _activity = false;
     _gateOutput = false;
+    _segment.step = nullptr;
 
     _recorder.reset();
     _gateQueue.clear();
@@ -117,12 +109,11 @@ TrackEngine::TickResult CurveTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         result |= TickResult::GateUpdate;
-        _activity = _gateQueue.front().gate;
+        _activity = gate.gate;
         _gateOutput = (!mute() || fill()) && _activity;
-        _gateQueue.pop();
-
         _engine.midiOutputEngine().sendGate(_track.trackIndex(), _gateOutput);
     }
 
@@ -179,6 +170,9 @@ void CurveTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     bool fillStep = fill() && (rng.nextRange(100) < uint32_t(fillAmount()));
     _fillMode = fillStep ? _curveTrack.fillMode() : CurveTrack::FillMode::None;
 
+    // invalidate segment, it is computed with the next output update
+    _segment.step = nullptr;
+
     // Trigger gate pattern
     int gate = step.gate();
     for (int i = 0; i < 4; ++i) {
@@ -197,11 +191,12 @@ void CurveTrackEngine::updateOutput(uint32_t relativeTick, uint32_t divisor) {
     }
 
     const auto &sequence = *_sequence;
-    const auto &range = Types::voltageRangeInfo(sequence.range());
 
-    _currentStepFraction = float(relativeTick % divisor) / divisor;
+    uint32_t stepTick = relativeTick % divisor;
+    _currentStepFraction = float(stepTick) / divisor;
 
     if (mute()) {
+        const auto &range = Types::voltageRangeInfo(sequence.range());
         switch (_curveTrack.muteMode()) {
         case CurveTrack::MuteMode::LastValue:
             // keep value
@@ -219,26 +214,63 @@ void CurveTrackEngine::updateOutput(uint32_t relativeTick, uint32_t divisor) {
             break;
         }
     } else {
-        bool fillVariation = _fillMode == CurveTrack::FillMode::Variation;
         bool fillNextPattern = _fillMode == CurveTrack::FillMode::NextPattern;
-        bool fillInvert = _fillMode == CurveTrack::FillMode::Invert;
 
         const auto &evalSequence = fillNextPattern ? *_fillSequence : *_sequence;
         const auto &step = evalSequence.step(_currentStep);
 
-        float value = evalStepShape(step, _shapeVariation || fillVariation, fillInvert, _currentStepFraction, _sequenceState.direction());
-        value = range.denormalize(value);
-
-        float min = float(_curveTrack.min()) / CurveSequence::Min::Max;
-        float max = float(_curveTrack.max()) / CurveSequence::Max::Max;
+        float trackMin = _curveTrack.min();
+        float trackMax = _curveTrack.max();
+        auto range = sequence.range();
 
+        if (_segment.step != &step || _segment.stepKey != stepKey(step) ||
+            _segment.trackMin != trackMin || _segment.trackMax != trackMax || _segment.range != range) {
+            updateSegment(step, trackMin, trackMax, range);
+        }
 
-        _cvOutputTarget = min + value * (max - min);
+        uint32_t fraction = (stepTick << 16) / divisor;
+        _cvOutputTarget = Curve::evalFixed(_segment.shape, fraction) * _segment.scale + _segment.offset;
     }
 
     _engine.midiOutputEngine().sendCv(_track.trackIndex(), _cvOutputTarget);
 }
 
+void CurveTrackEngine::updateSegment(const CurveSequence::Step &step, float trackMin, float trackMax, Types::VoltageRange range) {
+    bool variation = _shapeVariation || _fillMode == CurveTrack::FillMode::Variation;
+    bool invert = _fillMode == CurveTrack::FillMode::Invert;
+    bool reverse = _sequenceState.direction() == -1;
+
+    auto shape = Curve::Type(variation ? step.shapeVariation() : step.shape());
+    if (reverse && !variation) {
+        shape = Curve::revAt(step.shape());
+    }
+
+    // map shape value to step min/max, voltage range and track min/max
+    const auto &rangeInfo = Types::voltageRangeInfo(range);
+    float stepMin = step.minNormalized();
+    float stepMax = step.maxNormalized();
+    float trackMinNormalized = trackMin / CurveSequence::Min::Max;
+    float trackMaxNormalized = trackMax / CurveSequence::Max::Max;
+    float trackScale = trackMaxNormalized - trackMinNormalized;
+    float rangeScale = rangeInfo.hi - rangeInfo.lo;
+
+    float scale = (stepMax - stepMin) * rangeScale * trackScale;
+    float offset = trackMinNormalized + (rangeInfo.lo + stepMin * rangeScale) * trackScale;
+    if (invert) {
+        offset += scale;
+        scale = -scale;
+    }
+
+    _segment.shape = shape;
+    _segment.scale = scale * (1.f / Curve::FixedOne);
+    _segment.offset = offset;
+    _segment.step = &step;
+    _segment.stepKey = stepKey(step);
+    _segment.trackMin = trackMin;
+    _segment.trackMax = trackMax;
+    _segment.range = range;
+}
+
 bool CurveTrackEngine::isRecording() const {
     bool val =
         _engine.state().recording() &&
@@ -2,9 +2,10 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "EventScheduler.h"
 #include "CurveRecorder.h"
 
+#include "model/Curve.h"
 #include "model/Track.h"
 
 class CurveTrackEngine : public TrackEngine {
@@ -27,6 +28,8 @@ public:
 
     virtual const TrackLinkData *linkData() const override { return &_linkData; }
 
+    virtual uint32_t eventOverflowCount() const override { return _gateQueue.overflowCount(); }
+
     virtual bool activity() const override { return _activity; }
     virtual bool gateOutput(int index) const override { return _gateOutput; }
     virtual float cvOutput(int index) const override { return _cvOutput; }
@@ -52,6 +55,7 @@ public:
 private:
     void triggerStep(uint32_t tick, uint32_t divisor);
     void updateOutput(uint32_t relativeTick, uint32_t divisor);
+    void updateSegment(const CurveSequence::Step &step, float trackMin, float trackMax, Types::VoltageRange range);
 
     bool isRecording() const;
     void updateRecordValue();
@@ -75,6 +79,24 @@ private:
     bool _shapeVariation;
     CurveTrack::FillMode _fillMode;
 
+    // Output mapping of the current step, output = Curve::evalFixed(shape, fraction) * scale + offset.
+    // Combines step min/max, voltage range and track min/max as well as the shape variation, invert and
+    // direction decisions taken when the step is triggered. Invalidated when a step is triggered and
+    // recomputed when the step or the track min/max and voltage range change.
+    struct Segment {
+        Curve::Type shape;
+        float scale;
+        float offset;
+        // inputs
+        const CurveSequence::Step *step;
+        uint32_t stepKey;
+        float trackMin;
+        float trackMax;
+        Types::VoltageRange range;
+    };
+
+    Segment _segment;
+
     bool _activity;
     bool _gateOutput;
     float _cvOutput = 0.f;
@@ -85,11 +107,5 @@ private:
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    EventScheduler<Gate, 32> _gateQueue;
 };
@@ -7,6 +7,7 @@
 #include "NoteTrackEngine.h"
 #include "core/Debug.h"
 #include "core/midi/MidiMessage.h"
+#include "core/profiler/Profiler.h"
 #include "ui/ControllerManager.h"
 
 #include "os/os.h"
@@ -31,6 +32,8 @@ Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &di
     _usbMidi.setConnectHandler([this] (uint16_t vendorId, uint16_t productId) { usbMidiConnect(vendorId, productId); });
     _usbMidi.setDisconnectHandler([this] () { usbMidiDisconnect(); });
 
+    _tickRoutingSetting = model.settings().userSettings().get<TickRoutingSetting>(SettingTickRouting);
+
     _midiMonitoring.inputChanged(_project);
 }
 
@@ -53,6 +56,8 @@ void Engine::init() {
     _lastSystemTicks = os::ticks();
 }
 
+PROFILER_INTERVAL(engineTick, "engine tick")
+
 void Engine::update() {
     // locking
     _locked = _requestLock;
@@ -68,6 +73,9 @@ void Engine::update() {
     if (_requestSuspend != _suspended) {
         if (_requestSuspend) {
             _clock.masterStop();
+        } else {
+            // model may have been changed while suspended (i.e. project loaded)
+            _routingEngine.invalidate();
         }
         _suspended = _requestSuspend;
     }
@@ -136,23 +144,43 @@ void Engine::update() {
     // update routings
     _routingEngine.update();
 
+    // cv output channels updated by ticks, resolved once for all ticks processed in this update
+    bool sampleAccurateRouting = _tickRoutingSetting->getValue();
+    uint8_t dirtyCvOutputs = 0;
+
+    PROFILER_INTERVAL_BEGIN(engineTick)
+
     uint32_t tick;
     while (_clock.checkTick(&tick)) {
         _tick = tick;
 
+        if (_tickListener) {
+            _tickListener->onTickBegin(tick);
+        }
+
         // update play state
         updatePlayState(true);
 
         // tick track engines
         for (size_t trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
             auto &trackEngine = _trackEngines[trackIndex];
+            if (_tickListener) {
+                _tickListener->onTrackTickBegin(trackIndex);
+            }
             uint32_t result = trackEngine->tick(tick);
+            if (_tickListener) {
+                _tickListener->onTrackTickEnd(trackIndex);
+            }
             // update track outputs and routings if tick results in updating the track's CV output
-            if (result &= TrackEngine::TickResult::CvUpdate && _trackUpdateReducers[trackIndex].update()) {
+            if ((result & TrackEngine::TickResult::CvUpdate) && _trackUpdateReducers[trackIndex].update()) {
                 trackEngine->update(0.f);
-                updateTrackOutputs();
-                updateOverrides();
-                _routingEngine.update();
+                if (sampleAccurateRouting) {
+                    updateTrackOutputs();
+                    updateOverrides();
+                    _routingEngine.update();
+                } else {
+                    dirtyCvOutputs |= cvOutputChannels(trackIndex);
+                }
             }
         }
 
@@ -160,8 +188,21 @@ void Engine::update() {
         if (tick == 0) {
             _midiOutputEngine.update(true);
         }
+
+        if (_tickListener) {
+            _tickListener->onTickEnd(tick);
+        }
+    }
+
+    // update dirty outputs and resolve routings once for all ticks processed in this update
+    if (dirtyCvOutputs) {
+        updateTrackOutputs(dirtyCvOutputs);
+        updateOverrides();
+        _routingEngine.update();
     }
 
+    PROFILER_INTERVAL_END(engineTick)
+
     for (auto trackEngine : _trackEngines) {
         trackEngine->update(dt);
     }
@@ -378,6 +419,30 @@ bool Engine::sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message)
     return false;
 }
 
+bool Engine::sendMidiLowPriority(MidiPort port, uint8_t cable, const MidiMessage &message) {
+    switch (port) {
+    case MidiPort::Midi:
+        return _midi.send(message);
+    case MidiPort::UsbMidi:
+        return _usbMidi.sendLowPriority(cable, message);
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    return false;
+}
+
+int Engine::midiTxPending(MidiPort port) const {
+    switch (port) {
+    case MidiPort::UsbMidi:
+        return _usbMidi.txPending();
+    case MidiPort::Midi:
+    case MidiPort::CvGate:
+        break;
+    }
+    return 0;
+}
+
 bool Engine::midiProgramChangesEnabled() {
     return _project.midiIntegrationProgramChangesEnabled()
         && trackPatternsConsistent()
@@ -416,10 +481,19 @@ void Engine::setMessageHandler(MessageHandler handler) {
 }
 
 Engine::Stats Engine::stats() const {
+    uint32_t eventOverflow = _retiredEventOverflow;
+    for (const auto trackEngine : _trackEngines) {
+        eventOverflow += trackEngine->eventOverflowCount();
+    }
+
     return {
         .uptime = os::ticks() / os::time::ms(1000),
-        .midiRxOverflow = _midi.rxOverflow(),
-        .usbMidiRxOverflow = _usbMidi.rxOverflow()
+        .midiRx = { _midi.rxHighWaterMark(), _midi.rxOverflow() },
+        .usbMidiRx = { _usbMidi.rxHighWaterMark(), _usbMidi.rxOverflow() },
+        .uiMidi = { _midiReceiveQueue.highWaterMark(), _midiReceiveQueue.overflowCount() },
+        .eventOverflow = eventOverflow,
+        .routesEvaluated = _routingEngine.stats().evaluated,
+        .routesSkipped = _routingEngine.stats().skipped
     };
 }
 
@@ -459,6 +533,11 @@ void Engine::updateTrackSetups() {
             auto &trackEngine = _trackEngines[trackIndex];
             auto &trackContainer = _trackEngineContainers[trackIndex];
 
+            // keep the overflow count of the replaced track engine
+            if (trackEngine) {
+                _retiredEventOverflow += trackEngine->eventOverflowCount();
+            }
+
             switch (track.trackMode()) {
             case Track::TrackMode::Note:
                 trackEngine = trackContainer.create<NoteTrackEngine>(*this, _model, track, linkedTrackEngine);
@@ -481,6 +560,9 @@ void Engine::updateTrackSetups() {
             case Track::TrackMode::Last:
                 break;
             }
+
+            // routed values of the new track need to be written
+            _routingEngine.invalidate();
         }
 
         // update linked track engine
@@ -488,7 +570,7 @@ void Engine::updateTrackSetups() {
     }
 }
 
-void Engine::updateTrackOutputs() {
+void Engine::updateTrackOutputs(uint8_t cvOutputs) {
     const auto &gateOutputTracks = _project.gateOutputTracks();
     const auto &cvOutputTracks = _project.cvOutputTracks();
 
@@ -506,12 +588,24 @@ void Engine::updateTrackOutputs() {
             _gateOutput.setGate(trackIndex, _trackEngines[gateOutputTrack]->gateOutput(trackGateIndex[gateOutputTrack]++));
         }
         int cvOutputTrack = cvOutputTracks[trackIndex];
-        if (!_cvOutputOverride) {
-            _cvOutput.setChannel(trackIndex, _trackEngines[cvOutputTrack]->cvOutput(trackCvIndex[cvOutputTrack]++));
+        int cvIndex = trackCvIndex[cvOutputTrack]++;
+        if (!_cvOutputOverride && (cvOutputs & (1 << trackIndex))) {
+            _cvOutput.setChannel(trackIndex, _trackEngines[cvOutputTrack]->cvOutput(cvIndex));
         }
     }
 }
 
+uint8_t Engine::cvOutputChannels(int trackIndex) const {
+    const auto &cvOutputTracks = _project.cvOutputTracks();
+    uint8_t channels = 0;
+    for (int channel = 0; channel < CONFIG_CV_OUTPUT_CHANNELS; ++channel) {
+        if (cvOutputTracks[channel] == trackIndex) {
+            channels |= 1 << channel;
+        }
+    }
+    return channels;
+}
+
 void Engine::reset() {
     for (auto trackEngine : _trackEngines) {
         trackEngine->reset();
@@ -774,14 +868,15 @@ void Engine::receiveMidi() {
 
     // receive MIDI messages from ports
     MidiMessage message;
-    while (_midi.recv(&message)) {
+    uint32_t timestamp;
+    while (_midi.recv(&message, &timestamp)) {
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::Midi, 0, message);
+        receiveMidi(MidiPort::Midi, 0, message, timestamp);
     }
     uint8_t cable;
-    while (_usbMidi.recv(&cable, &message)) {
+    while (_usbMidi.recv(&cable, &message, &timestamp)) {
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::UsbMidi, cable, message);
+        receiveMidi(MidiPort::UsbMidi, cable, message, timestamp);
     }
 
     // derive MIDI messages from CV/Gate input
@@ -791,12 +886,12 @@ void Engine::receiveMidi() {
         break;
     case Types::CvGateInput::Cv1Cv2:
         _cvGateToMidiConverter.convert(_cvInput.channel(0), _cvInput.channel(1), 0, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, 0, message);
+            receiveMidi(MidiPort::CvGate, 0, message, ClockTimer::us());
         });
         break;
     case Types::CvGateInput::Cv3Cv4:
         _cvGateToMidiConverter.convert(_cvInput.channel(2), _cvInput.channel(3), 1, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, 0, message);
+            receiveMidi(MidiPort::CvGate, 0, message, ClockTimer::us());
         });
         break;
     case Types::CvGateInput::Last:
@@ -804,14 +899,15 @@ void Engine::receiveMidi() {
     }
 }
 
-void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message) {
+void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message, uint32_t timestamp) {
     // filter out real-time and system messages
     if (message.isRealTimeMessage() || message.isSystemMessage()) {
         return;
     }
 
-    // let receive handler consume messages (controllers in UI task)
+    // forward messages to UI task and let receive handler consume messages (controllers in UI task)
     if (_midiReceiveHandler) {
+        _midiReceiveQueue.push({ port, cable, message });
         if (_midiReceiveHandler(port, cable, message)) {
             return;
         }
@@ -867,13 +963,17 @@ void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &messag
             return;
         }
     }
-    monitorMidi(message);
+    monitorMidi(message, timestamp);
 }
 
-void Engine::monitorMidi(const MidiMessage &message) {
+void Engine::monitorMidi(const MidiMessage &message, uint32_t timestamp) {
+    // time of reception in clock ticks
+    float fraction;
+    uint32_t tick = _clock.tickAt(timestamp, &fraction);
+
     // helper to send monitor message to a track engine
-    auto sendMidi = [this] (int trackIndex, const MidiMessage &message) {
-        _trackEngines[trackIndex]->monitorMidi(_tick, message);
+    auto sendMidi = [this, tick, fraction] (int trackIndex, const MidiMessage &message) {
+        _trackEngines[trackIndex]->monitorMidi(tick, fraction, message);
     };
 
     auto currentTrack = _project.selectedTrackIndex();
@@ -27,9 +27,12 @@
 #include "drivers/Dac.h"
 #include "drivers/Dio.h"
 #include "drivers/GateOutput.h"
+#include "drivers/HighResolutionTimer.h"
 #include "drivers/Midi.h"
 #include "drivers/UsbMidi.h"
 
+#include "core/utils/SpscQueue.h"
+
 #include <array>
 
 #include <cstdint>
@@ -43,21 +46,47 @@ public:
 
     typedef std::function<bool(MidiPort port, uint8_t cable, const MidiMessage &message)> MidiReceiveHandler;
 
+    struct MidiReceiveEvent {
+        MidiPort port;
+        uint8_t cable;
+        MidiMessage message;
+    };
+
+    // received messages forwarded to the UI task
+    typedef SpscQueue<MidiReceiveEvent, 32> MidiReceiveQueue;
+
     typedef std::function<void(uint16_t vendorId, uint16_t productId)> UsbMidiConnectHandler;
     typedef std::function<void()> UsbMidiDisconnectHandler;
 
     typedef std::function<void(const char *text, uint32_t duration)> MessageHandler;
 
+    // instrumentation hooks called around clock ticks (used for benchmarking)
+    struct TickListener {
+        virtual void onTickBegin(uint32_t tick) {}
+        virtual void onTickEnd(uint32_t tick) {}
+        virtual void onTrackTickBegin(int trackIndex) {}
+        virtual void onTrackTickEnd(int trackIndex) {}
+    };
+
     enum ClockSource {
         ClockSourceExternal,
         ClockSourceMidi,
         ClockSourceUsbMidi,
     };
 
+    struct MidiQueueStats {
+        uint32_t highWaterMark;
+        uint32_t overflow;
+    };
+
     struct Stats {
         uint32_t uptime;
-        uint32_t midiRxOverflow;
-        uint32_t usbMidiRxOverflow;
+        MidiQueueStats midiRx;
+        MidiQueueStats usbMidiRx;
+        MidiQueueStats uiMidi;
+        uint32_t eventOverflow;     // since startup, including replaced track engines
+        uint32_t routesEvaluated;
+        uint32_t routesSkipped;
     };
 
     Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi);
@@ -117,6 +146,12 @@ public:
     const CvOutput &cvOutput() const { return _cvOutput; }
     const uint8_t gateOutput() const { return _gateOutput.gates(); }
 
+    // tick processing
+    // by default, dirty outputs and routings are resolved once for all ticks processed in an update, sample accurate
+    // routing (the "Tick Routing" user setting) resolves outputs and routings after every tick that updates a track's
+    // CV output instead
+    bool sampleAccurateRouting() const { return _tickRoutingSetting->getValue(); }
+
     // gate overrides
     bool gateOutputOverride() const { return _gateOutputOverride; }
     void setGateOutputOverride(bool enabled) { _gateOutputOverride = enabled; }
@@ -154,7 +189,14 @@ public:
     bool trackPatternsConsistent() const;
 
     bool sendMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
+    // controller feedback, low priority messages are queued behind all messages sent with sendMidi()
+    bool sendMidiLowPriority(MidiPort port, uint8_t cable, const MidiMessage &message);
+    // number of messages waiting for transmission on the port
+    int midiTxPending(MidiPort port) const;
+    // the receive handler is called in the engine task and allows to consume messages,
+    // all messages are forwarded to the UI task through the receive queue when a handler is set
     void setMidiReceiveHandler(MidiReceiveHandler handler) { _midiReceiveHandler = handler; }
+    MidiReceiveQueue &midiReceiveQueue() { return _midiReceiveQueue; }
     void setUsbMidiConnectHandler(UsbMidiConnectHandler handler) { _usbMidiConnectHandler = handler; }
     void setUsbMidiDisconnectHandler(UsbMidiDisconnectHandler handler) { _usbMidiDisconnectHandler = handler; }
     bool midiProgramChangesEnabled();
@@ -165,6 +207,9 @@ public:
     void showMessage(const char *text, uint32_t duration = 1000);
     void setMessageHandler(MessageHandler handler);
 
+    // tick instrumentation
+    void setTickListener(TickListener *listener) { _tickListener = listener; }
+
     Stats stats() const;
 
      bool isLaunchpadConnected();
@@ -176,7 +221,10 @@ private:
     virtual void onClockMidi(uint8_t data) override;
 
     void updateTrackSetups();
-    void updateTrackOutputs();
+    // updates gate outputs and the given cv output channels from the track engines
+    void updateTrackOutputs(uint8_t cvOutputs = 0xff);
+    // cv output channels driven by a track
+    uint8_t cvOutputChannels(int trackIndex) const;
     void reset();
     void updatePlayState(bool ticked);
     void updateOverrides();
@@ -185,8 +233,8 @@ private:
     void usbMidiDisconnect();
    
     void receiveMidi();
-    void receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message);
-    void monitorMidi(const MidiMessage &message);
+    void receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &message, uint32_t timestamp);
+    void monitorMidi(const MidiMessage &message, uint32_t timestamp);
 
     void initClock();
     void updateClockSetup();
@@ -216,6 +264,7 @@ private:
     RoutingEngine _routingEngine;
     MidiLearn _midiLearn;
     MidiReceiveHandler _midiReceiveHandler;
+    MidiReceiveQueue _midiReceiveQueue;
     UsbMidiConnectHandler _usbMidiConnectHandler;
     UsbMidiDisconnectHandler _usbMidiDisconnectHandler;
 
@@ -231,6 +280,11 @@ private:
 
     uint32_t _tick = 0;
 
+    const TickRoutingSetting *_tickRoutingSetting;
+
+    // event queue overflows of track engines replaced on track mode changes
+    uint32_t _retiredEventOverflow = 0;
+
     uint32_t _lastSystemTicks = 0;
 
     // midi monitoring
@@ -280,5 +334,7 @@ private:
 
     MessageHandler _messageHandler;
 
+    TickListener *_tickListener = nullptr;
+
     bool _deviceConnected = false;
 };
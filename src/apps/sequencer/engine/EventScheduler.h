@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstddef>
+
+// Fixed capacity event scheduler based on a hierarchical timing wheel keyed on engine ticks.
+//
+// Events (T needs a uint32_t tick member) are stored in a pool of Capacity nodes and linked into one of three levels:
+// - level 0 holds events of the current block of 2^SlotBits ticks (one slot per tick)
+// - level 1 holds events of the current span of 2^(2*SlotBits) ticks (one slot per block)
+// - events beyond the current span are kept in an overflow list which is only revisited when entering a new span
+//
+// Inserting and popping events is O(1) (amortized when moving to a new block or span).
+// Events with the same tick are returned in insertion order. If the pool is exhausted, new events are dropped
+// and counted in overflowCount().
+template<typename T, size_t Capacity, size_t SlotBits = 5>
+class EventScheduler {
+    static_assert(Capacity > 0 && Capacity < 255, "invalid capacity");
+    static_assert(SlotBits > 0 && SlotBits <= 5, "invalid slot bits");
+public:
+    EventScheduler() {
+        clear();
+    }
+
+    void clear() {
+        for (auto &list : _lists) {
+            list.head = list.tail = Null;
+        }
+        _mask[0] = _mask[1] = 0;
+        for (size_t i = 0; i < Capacity; ++i) {
+            _nodes[i].next = i + 1 < Capacity ? i + 1 : Null;
+        }
+        _free = 0;
+        _size = 0;
+        _time = 0;
+        _latest = 0;
+    }
+
+    size_t capacity() const { return Capacity; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // number of events dropped due to the scheduler being full (not reset by clear())
+    uint32_t overflowCount() const { return _overflowCount; }
+
+    void push(const T &event) {
+        if (_free == Null) {
+            ++_overflowCount;
+            return;
+        }
+
+        uint8_t index = _free;
+        _free = _nodes[index].next;
+        _nodes[index].event = event;
+
+        _latest = _size == 0 ? event.tick : std::max(_latest, event.tick);
+        ++_size;
+
+        insert(index);
+    }
+
+    // push event and drop all events scheduled after it
+    void pushReplace(const T &event) {
+        if (_size > 0 && event.tick < _latest) {
+            dropAfter(event.tick);
+        }
+        push(event);
+    }
+
+    // pop the next event that is due at the given tick
+    bool pop(uint32_t tick, T &event) {
+        while (true) {
+            if (_mask[0]) {
+                int slot = ctz(_mask[0]);
+                uint32_t slotTick = (_time & ~BlockMask) | slot;
+                if (slotTick > tick) {
+                    return false;
+                }
+                _time = std::max(_time, slotTick);
+                uint8_t index = unlink(slot);
+                event = _nodes[index].event;
+                _nodes[index].next = _free;
+                _free = index;
+                --_size;
+                return true;
+            }
+
+            // current block is exhausted, move on to the next block with events or to the given tick
+            uint32_t nextTick = nextBlockTick();
+            if (nextTick > tick) {
+                moveTo(tick);
+                return false;
+            }
+            moveTo(nextTick);
+        }
+    }
+
+private:
+    static constexpr uint8_t Null = 0xff;
+    static constexpr int Slots = 1 << SlotBits;
+    static constexpr uint32_t BlockMask = Slots - 1;
+    static constexpr uint32_t SpanMask = (1 << (2 * SlotBits)) - 1;
+    static constexpr int OverflowList = 2 * Slots;
+
+    static int ctz(uint32_t mask) { return __builtin_ctz(mask); }
+
+    static uint32_t block(uint32_t tick) { return tick >> SlotBits; }
+    static uint32_t span(uint32_t tick) { return tick >> (2 * SlotBits); }
+
+    void insert(uint8_t index) {
+        uint32_t tick = std::max(_nodes[index].event.tick, _time);
+        if (block(tick) == block(_time)) {
+            append(tick & BlockMask, index);
+        } else if (span(tick) == span(_time)) {
+            append(Slots + (block(tick) & BlockMask), index);
+        } else {
+            append(OverflowList, index);
+        }
+    }
+
+    void append(int list, uint8_t index) {
+        auto &l = _lists[list];
+        _nodes[index].next = Null;
+        if (l.tail == Null) {
+            l.head = index;
+        } else {
+            _nodes[l.tail].next = index;
+        }
+        l.tail = index;
+        if (list < OverflowList) {
+            _mask[list / Slots] |= (1u << (list % Slots));
+        }
+    }
+
+    uint8_t unlink(int list) {
+        auto &l = _lists[list];
+        uint8_t index = l.head;
+        l.head = _nodes[index].next;
+        if (l.head == Null) {
+            l.tail = Null;
+            if (list < OverflowList) {
+                _mask[list / Slots] &= ~(1u << (list % Slots));
+            }
+        }
+        return index;
+    }
+
+    uint32_t nextBlockTick() const {
+        if (_mask[1]) {
+            return (_time & ~SpanMask) | (ctz(_mask[1]) << SlotBits);
+        }
+        if (_lists[OverflowList].head != Null) {
+            uint32_t minTick = _nodes[_lists[OverflowList].head].event.tick;
+            for (uint8_t index = _lists[OverflowList].head; index != Null; index = _nodes[index].next) {
+                minTick = std::min(minTick, _nodes[index].event.tick);
+            }
+            return minTick & ~BlockMask;
+        }
+        return UINT32_MAX;
+    }
+
+    // move time forward, level 0 is empty and no events are scheduled before the block of the new time
+    void moveTo(uint32_t tick) {
+        if (tick <= _time) {
+            return;
+        }
+        bool newSpan = span(tick) != span(_time);
+        _time = tick;
+        if (newSpan) {
+            // redistribute overflow list, level 1 is empty at this point
+            uint8_t index = _lists[OverflowList].head;
+            _lists[OverflowList].head = _lists[OverflowList].tail = Null;
+            while (index != Null) {
+                uint8_t next = _nodes[index].next;
+                insert(index);
+                index = next;
+            }
+        } else {
+            // cascade block from level 1 to level 0
+            int list = Slots + (block(tick) & BlockMask);
+            while (_lists[list].head != Null) {
+                insert(unlink(list));
+            }
+        }
+    }
+
+    void dropAfter(uint32_t tick) {
+        for (int list = 0; list <= OverflowList; ++list) {
+            auto &l = _lists[list];
+            uint8_t index = l.head;
+            l.head = l.tail = Null;
+            while (index != Null) {
+                uint8_t next = _nodes[index].next;
+                if (_nodes[index].event.tick > tick) {
+                    _nodes[index].next = _free;
+                    _free = index;
+                    --_size;
+                } else {
+                    _nodes[index].next = Null;
+                    if (l.tail == Null) {
+                        l.head = index;
+                    } else {
+                        _nodes[l.tail].next = index;
+                    }
+                    l.tail = index;
+                }
+                index = next;
+            }
+            if (list < OverflowList && l.head == Null) {
+                _mask[list / Slots] &= ~(1u << (list % Slots));
+            }
+        }
+        _latest = tick;
+    }
+
+    struct Node {
+        T event;
+        uint8_t next;
+    };
+
+    struct List {
+        uint8_t head;
+        uint8_t tail;
+    };
+
+    std::array<Node, Capacity> _nodes;
+    std::array<List, 2 * Slots + 1> _lists;
+    uint32_t _mask[2];
+    uint8_t _free;
+    uint8_t _size;
+    uint32_t _time;
+    uint32_t _latest;
+    uint32_t _overflowCount = 0;
+};
@@ -11,6 +11,7 @@
 #include "core/math/Math.h"
 
 #include "model/LogicSequence.h"
+#include "model/QuantizerTable.h"
 #include "model/Scale.h"
 #include "ui/MatrixMap.h"
 #include <algorithm>
@@ -75,12 +76,12 @@ static int evalStepLength(const LogicSequence::Step &step, int lengthBias) {
 }
 
 // evaluate transposition
-static int evalTransposition(const Scale &scale, int octave, int transpose) {
-    return octave * scale.notesPerOctave() + transpose;
+static int evalTransposition(const QuantizerTable &quantizer, int octave, int transpose) {
+    return octave * quantizer.notesPerOctave() + transpose;
 }
 
 // evaluate note voltage
-static float evalStepNote(const LogicSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, int note1, int note2, bool useVariation = true) {
+static float evalStepNote(const LogicSequence::Step &step, int probabilityBias, const QuantizerTable &quantizer, int octave, int transpose, int note1, int note2, bool useVariation = true) {
 
     auto stepNote = step.note();
     switch (step.noteLogic()) {
@@ -148,7 +149,7 @@ static float evalStepNote(const LogicSequence::Step &step, int probabilityBias,
             break;
     }
 
-    int note =  stepNote + evalTransposition(scale, octave, transpose);
+    int note =  stepNote + evalTransposition(quantizer, octave, transpose);
     int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, LogicSequence::NoteVariationProbability::Max);
     if (useVariation && int(rng.nextRange(LogicSequence::NoteVariationProbability::Range)) <= probability) {
         int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
@@ -157,7 +158,7 @@ static float evalStepNote(const LogicSequence::Step &step, int probabilityBias,
         }
         note = LogicSequence::Note::clamp(note + offset);
     }
-    return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    return quantizer.noteToVolts(note);
     return 0.f;
 }
 
@@ -307,28 +308,27 @@ TrackEngine::TickResult LogicTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         if (!_monitorOverrideActive) {
             result |= TickResult::GateUpdate;
-            _activity = _gateQueue.front().gate;
+            _activity = gate.gate;
             _gateOutput = (!mute() || fill()) && _activity;
             midiOutputEngine.sendGate(_track.trackIndex(), _gateOutput);
         }
-        _gateQueue.pop();
-
     }
 
-    while (!_cvQueue.empty() && tick >= _cvQueue.front().tick) {
+    Cv cv;
+    while (_cvQueue.pop(tick, cv)) {
         if (!mute() || _logicTrack.cvUpdateMode() == LogicTrack::CvUpdateMode::Always) {
             if (!_monitorOverrideActive) {
                 result |= TickResult::CvUpdate;
-                _cvOutputTarget = _cvQueue.front().cv;
-                _slideActive = _cvQueue.front().slide;
+                _cvOutputTarget = cv.cv;
+                _slideActive = cv.slide;
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
         }
-        _cvQueue.pop();
     }
 
     return result;
@@ -338,8 +338,8 @@ void LogicTrackEngine::update(float dt) {
     bool running = _engine.state().running();
 
     const auto &sequence = *_sequence;
-    const auto &scale = sequence.selectedScale(_model.project().scale());
     int rootNote = sequence.selectedRootNote(_model.project().rootNote());
+    const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
     int octave = _logicTrack.octave();
     int transpose = _logicTrack.transpose();
 
@@ -393,10 +393,10 @@ void LogicTrackEngine::update(float dt) {
 
     if (stepMonitoring) {
         const auto &step = sequence.step(_monitorStepIndex);
-        setOverride(evalStepNote(step, 0, scale, rootNote, octave, transpose, false, 0, 0));
+        setOverride(evalStepNote(step, 0, quantizer, octave, transpose, false, 0, 0));
     } else if (liveMonitoring && _recordHistory.isNoteActive()) {
-        int note = evalTransposition(scale, octave, transpose);
-        setOverride(scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f));
+        int note = evalTransposition(quantizer, octave, transpose);
+        setOverride(quantizer.noteToVolts(note));
     } else {
         clearOverride();
     }
@@ -413,8 +413,8 @@ void LogicTrackEngine::changePattern() {
     _fillSequence = &_logicTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
-void LogicTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
-    _recordHistory.write(tick, message);
+void LogicTrackEngine::monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) {
+    _recordHistory.write(tick, fraction, message);
 
     if (_engine.recording() && _model.project().recordMode() == Types::RecordMode::StepRecord) {
        // _stepRecorder.process(message, *_sequence, [this] (int midiNote) { return noteFromMidiNote(midiNote); });
@@ -628,13 +628,12 @@ void LogicTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
     }
 
     if (stepGate || _logicTrack.cvUpdateMode() == LogicTrack::CvUpdateMode::Always) {
-        const auto &scale = evalSequence.selectedScale(_model.project().scale());
-        int rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
-
         if (_logicTrack.inputTrack1() == -1 || _logicTrack.inputTrack2() == -1) {
             return;
         }
-        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _logicTrack.noteProbabilityBias(), scale, rootNote, octave, transpose, inputSequence1.step(stepIndex1).note(), inputSequence2.step(stepIndex2).note()), step.slide() });
+        int rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
+        const auto &quantizer = QuantizerTable::get(evalSequence.selectedScale(_model.project().scale()), rootNote);
+        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _logicTrack.noteProbabilityBias(), quantizer, octave, transpose, inputSequence1.step(stepIndex1).note(), inputSequence2.step(stepIndex2).note()), step.slide() });
     }
 }
 
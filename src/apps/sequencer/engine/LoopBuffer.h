@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+
+#include <cstddef>
+
+// Fixed capacity buffer recording the steps of a loop, stored inline.
+// Windows into the buffer are returned as views without copying.
+template<typename T, size_t Capacity>
+class LoopBuffer {
+public:
+    class Window {
+    public:
+        Window(const T *data, int size) : _data(data), _size(size) {}
+
+        int size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        const T &operator[](int index) const { return _data[index]; }
+
+        const T *begin() const { return _data; }
+        const T *end() const { return _data + _size; }
+
+    private:
+        const T *_data;
+        int _size;
+    };
+
+    LoopBuffer() {
+        clear();
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size == int(Capacity); }
+
+    void clear() {
+        _size = 0;
+    }
+
+    // append an entry, returns false if the buffer is full
+    bool push(const T &value) {
+        if (full()) {
+            return false;
+        }
+        _items[_size++] = value;
+        return true;
+    }
+
+    // drop entries beyond the given size
+    void truncate(int size) {
+        _size = std::max(0, std::min(_size, size));
+    }
+
+    const T &operator[](int index) const { return _items[index]; }
+
+    // window of entries [first, last], clamped to the stored entries
+    Window window(int first, int last) const {
+        first = std::max(0, first);
+        last = std::min(last, _size - 1);
+        return Window(_items.data() + first, std::max(0, last - first + 1));
+    }
+
+    Window all() const { return Window(_items.data(), _size); }
+
+private:
+    std::array<T, Capacity> _items;
+    int _size;
+};
@@ -43,9 +43,15 @@ void MidiCvTrackEngine::update(float dt) {
         }
     }
 
+    updateVoices();
+
     // update monophonic portamento
     if (_midiCvTrack.voices() == 1) {
-        _pitchCvOutputTarget = noteToCv(_voices.front().note + _midiCvTrack.transpose()) + pitchBendToCv(_pitchBend);
+        auto voice = _voices.outputVoice(0);
+        if (voice) {
+            _monophonicNote = voice->note;
+        }
+        _pitchCvOutputTarget = noteToCv(_monophonicNote + _midiCvTrack.transpose()) + pitchBendToCv(_pitchBend);
         if (_slideActive && _midiCvTrack.slideTime() > 0) {
             _pitchCvOutput = Slide::applySlide(_pitchCvOutput, _pitchCvOutputTarget, _midiCvTrack.slideTime(), dt);
         } else {
@@ -81,7 +87,7 @@ bool MidiCvTrackEngine::receiveMidi(MidiPort port, const MidiMessage &message) {
                 removeVoice(message.note());
                 consumed = true;
             } else if (message.isKeyPressure()) {
-                auto voice = findVoice(message.note());
+                auto voice = _voices.findVoice(message.note());
                 if (voice) {
                     voice->pressure = message.keyPressure();
                 }
@@ -106,11 +112,10 @@ bool MidiCvTrackEngine::activity() const {
 }
 
 bool MidiCvTrackEngine::gateOutput(int index) const {
-    int voiceIndex = _voiceByOutput[index % _midiCvTrack.voices()];
-    if (voiceIndex != -1) {
-        const auto &voice = _voices[voiceIndex];
+    auto voice = _voices.outputVoice(index % _midiCvTrack.voices());
+    if (voice) {
         uint32_t delay = _midiCvTrack.retrigger() ? RetriggerDelay : 0;
-        return !mute() && voice.isActive() && (voice.ticks - os::ticks()) >= delay;
+        return !mute() && voice->isActive() && (voice->time - os::ticks()) >= delay;
     }
     return false;
 }
@@ -124,25 +129,22 @@ float MidiCvTrackEngine::cvOutput(int index) const {
     int voiceIndex = index % voices;
     int signalIndex = index / voices;
 
-    voiceIndex = _voiceByOutput[index % _midiCvTrack.voices()];
-    if (voiceIndex != -1) {
-        const auto &voice = _voices[voiceIndex];
+    auto voice = _voices.outputVoice(voiceIndex);
+    if (voice) {
         switch (_midiCvTrack.voiceSignalByIndex(signalIndex)) {
         case MidiCvTrack::VoiceSignal::Pitch:
-            return voices == 1 ? _pitchCvOutput : noteToCv(voice.note + transpose) + pitchBendToCv(_pitchBend);
+            return voices == 1 ? _pitchCvOutput : noteToCv(voice->note + transpose) + pitchBendToCv(_pitchBend);
         case MidiCvTrack::VoiceSignal::Velocity:
-            return valueToCv(voice.velocity);
+            return valueToCv(voice->velocity);
         case MidiCvTrack::VoiceSignal::Pressure:
-            return valueToCv(voice.pressure) + valueToCv(_channelPressure);
+            return valueToCv(voice->pressure) + valueToCv(_channelPressure);
         }
     }
     return 0.f;
 }
 
 void MidiCvTrackEngine::updateActivity() {
-    _activity = std::any_of(_voices.begin(), _voices.end(), [] (const Voice &voice) {
-        return voice.isActive();
-    });
+    _activity = _voices.activeCount() > 0;
 }
 
 void MidiCvTrackEngine::updateArpeggiator() {
@@ -190,143 +192,41 @@ float MidiCvTrackEngine::pitchBendToCv(int value) const {
 }
 
 void MidiCvTrackEngine::resetVoices() {
-    for (auto &voice : _voices) {
-        voice.reset();
-    }
-    _voiceByOutput.fill(-1);
-    _nextOutput = -1;
+    _voices.reset();
+    _monophonicNote = 60;
+    updateVoices();
 }
 
-void MidiCvTrackEngine::addVoice(int note, int velocity) {
-    // activate slide if there already are active voices
-    _slideActive = _midiCvTrack.voices() == 1 && std::any_of(_voices.begin(), _voices.end(), [] (const Voice &voice) {
-        return voice.isActive();
-    });
-
-    // find a free voice
-    const auto it = std::find_if(_voices.begin(), _voices.end(), [] (const Voice &voice) {
-        return !voice.isActive() && !voice.isAllocated();
-    });
-
-    // override last voice (lowest priority) if all are used
-    auto &voice = it == _voices.end() ? _voices.back() : *it;
-
-    voice.reset();
-    voice.ticks = os::ticks();
-    voice.note = note;
-    voice.velocity = velocity;
-    voice.pressure = 0;
-
-    sortVoices();
+void MidiCvTrackEngine::updateVoices() {
+    _voices.setPriority(Voices::Priority(_midiCvTrack.notePriority()));
+    _voices.setOutputCount(_midiCvTrack.voices());
 }
 
-void MidiCvTrackEngine::removeVoice(int note) {
-    auto voice = findVoice(note);
-    if (voice) {
-        voice->release();
-    }
+void MidiCvTrackEngine::addVoice(int note, int velocity) {
+    updateVoices();
 
-    sortVoices();
-}
+    // activate slide if there already are active voices
+    _slideActive = _midiCvTrack.voices() == 1 && _voices.activeCount() > 0;
 
-MidiCvTrackEngine::Voice *MidiCvTrackEngine::findVoice(int note) {
-    auto it = std::find_if(_voices.begin(), _voices.end(), [note] (const Voice &voice) {
-        return voice.isActive() && voice.note == note;
-    });
+    _voices.noteOn(note, velocity, os::ticks());
 
-    return it == _voices.end() ? nullptr : it;
+    // printVoices();
 }
 
-void MidiCvTrackEngine::sortVoices() {
-    // move all active voices to front of array
-    auto activeEnd = std::stable_partition(_voices.begin(), _voices.end(), [] (const Voice &voice) {
-        return voice.isActive();
-    });
-
-    // sort based on note priority
-    auto notePriority = _midiCvTrack.notePriority();
-    std::sort(_voices.begin(), activeEnd, [notePriority] (const Voice &a, const Voice &b) {
-        switch (notePriority) {
-        case MidiCvTrack::NotePriority::LastNote:
-            return a.ticks > b.ticks;
-        case MidiCvTrack::NotePriority::FirstNote:
-            return a.ticks < b.ticks;
-        case MidiCvTrack::NotePriority::LowestNote:
-            return a.note < b.note;
-        case MidiCvTrack::NotePriority::HighestNote:
-            return a.note > b.note;
-        case MidiCvTrack::NotePriority::Last:
-            break;
-        }
-        return false;
-    });
-
-    // update voice allocation
-    int voices = _midiCvTrack.voices();
-
-    // reset excess voices
-    for (int i = 0; i < int(_voices.size()); ++i) {
-        auto &voice = _voices[i];
-        if (voice.output >= voices) {
-            voice.reset();
-        }
-    }
-
-    // helper to allocate a new voice output
-    auto allocateOutput = [this, voices] () -> int {
-        // try to allocate output in round-fashion, either a new output or released voice
-        for (int i = 0; i < int(VoiceCount); ++i) {
-            ++_nextOutput;
-            _nextOutput = _nextOutput >= voices ? 0 : _nextOutput;
-            bool isFree = std::none_of(_voices.begin(), _voices.end(), [this] (const Voice &v) {
-                return v.isActive() && v.output == _nextOutput;
-            });
-            if (isFree) {
-                for (auto &voice : _voices) {
-                    if (voice.output == _nextOutput) {
-                        voice.output = -1;
-                    }
-                }
-                return _nextOutput;
-            }
-        }
-
-        // otherwise steal lowest priority output
-        for (int i = int(_voices.size()) - 1; i >= 0; --i) {
-            auto &voice = _voices[i];
-            if (voice.isAllocated()) {
-                int output = voice.output;
-                voice.output = -1;
-                return output;
-            }
-        }
-
-        return -1;
-    };
-
-    // allocate new voices in round-robin fashion
-    for (int i = 0; i < voices; ++i) {
-        auto &voice = _voices[i];
-        if (voice.isActive() && !voice.isAllocated()) {
-            voice.output = allocateOutput();
-        }
-    }
+void MidiCvTrackEngine::removeVoice(int note) {
+    updateVoices();
 
-    // update allocation map
-    _voiceByOutput.fill(-1);
-    for (int i = 0; i < int(_voices.size()); ++i) {
-        const auto &voice = _voices[i];
-        if (voice.isAllocated()) {
-            _voiceByOutput[voice.output] = i;
-        }
-    }
+    _voices.noteOff(note);
 
     // printVoices();
 }
 
 void MidiCvTrackEngine::printVoices() {
     DBG("voices");
-    for (auto voice : _voices) {
-        DBG("%" PRIu32 " %d %d", voice.ticks, int(voice.note), int(voice.output));
+    for (int output = 0; output < _voices.outputCount(); ++output) {
+        auto voice = _voices.outputVoice(output);
+        if (voice) {
+            DBG("%d: %" PRIu32 " %d %s", output, voice->time, int(voice->note), voice->isActive() ? "held" : "released");
+        }
     }
 }
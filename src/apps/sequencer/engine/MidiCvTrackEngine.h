@@ -2,6 +2,7 @@
 
 #include "TrackEngine.h"
 #include "ArpeggiatorEngine.h"
+#include "VoiceAllocator.h"
 
 #include "model/Track.h"
 
@@ -24,6 +25,8 @@ public:
 
     virtual bool receiveMidi(MidiPort port, const MidiMessage &message) override;
 
+    virtual uint32_t eventOverflowCount() const override { return _arpeggiatorEngine.eventOverflowCount(); }
+
     virtual bool activity() const override;
     virtual bool gateOutput(int index) const override;
     virtual float cvOutput(int index) const override;
@@ -32,23 +35,7 @@ private:
     static constexpr size_t VoiceCount = 8;
     static constexpr int RetriggerDelay = 2;
 
-    struct Voice {
-        uint32_t ticks = 0;
-        uint8_t note = 60;
-        uint8_t velocity = 0;
-        uint8_t pressure = 0;
-        int8_t output = -1;
-
-        void reset() {
-            ticks = 0;
-            output = -1;
-        }
-
-        void release() { ticks = 0; }
-
-        bool isActive() const { return ticks != 0; }
-        bool isAllocated() const { return output != -1; }
-    };
+    typedef VoiceAllocator<VoiceCount> Voices;
 
     void updateActivity();
 
@@ -60,12 +47,11 @@ private:
     float pitchBendToCv(int value) const;
 
     void resetVoices();
+    void updateVoices();
 
     void addVoice(int note, int velocity);
     void removeVoice(int note);
-    Voice *findVoice(int note);
 
-    void sortVoices();
     void printVoices();
 
     const MidiCvTrack &_midiCvTrack;
@@ -75,9 +61,8 @@ private:
     float _arpeggiatorTime;
     uint32_t _arpeggiatorTick;
 
-    std::array<Voice, VoiceCount> _voices;
-    std::array<int8_t, VoiceCount> _voiceByOutput;
-    int8_t _nextOutput;
+    Voices _voices;
+    uint8_t _monophonicNote;
 
     bool _activity;
 
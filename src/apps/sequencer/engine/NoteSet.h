@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include <cstdint>
+#include <cstddef>
+
+// Set of 128 keys (MIDI notes) stored as a bitmap.
+// Keys outside of 0..127 are wrapped, which keeps any range of 128 consecutive keys (e.g. scale notes derived from
+// MIDI notes) distinct.
+class KeySet {
+public:
+    static constexpr int Size = 128;
+
+    KeySet() { clear(); }
+
+    void clear() { _bits.fill(0); }
+
+    bool test(int key) const {
+        key &= Size - 1;
+        return (_bits[key >> 5] & (1u << (key & 31))) != 0;
+    }
+
+    void set(int key, bool value = true) {
+        key &= Size - 1;
+        uint32_t mask = 1u << (key & 31);
+        _bits[key >> 5] = value ? (_bits[key >> 5] | mask) : (_bits[key >> 5] & ~mask);
+    }
+
+    void reset(int key) { set(key, false); }
+
+    bool any() const { return (_bits[0] | _bits[1] | _bits[2] | _bits[3]) != 0; }
+
+    int count() const {
+        return __builtin_popcount(_bits[0]) + __builtin_popcount(_bits[1]) + __builtin_popcount(_bits[2]) + __builtin_popcount(_bits[3]);
+    }
+
+    // lowest key above the given key or -1
+    int nextAbove(int key) const {
+        if (key >= Size - 1) {
+            return -1;
+        }
+        key = key < 0 ? 0 : key + 1;
+        for (int word = key >> 5, bit = key & 31; word < 4; ++word, bit = 0) {
+            uint32_t bits = _bits[word] & (~0u << bit);
+            if (bits) {
+                return (word << 5) + __builtin_ctz(bits);
+            }
+        }
+        return -1;
+    }
+
+    // highest key below the given key or -1
+    int nextBelow(int key) const {
+        if (key <= 0) {
+            return -1;
+        }
+        key = key > Size ? Size - 1 : key - 1;
+        for (int word = key >> 5, bit = key & 31; word >= 0; --word, bit = 31) {
+            uint32_t bits = _bits[word] & (~0u >> (31 - bit));
+            if (bits) {
+                return (word << 5) + 31 - __builtin_clz(bits);
+            }
+        }
+        return -1;
+    }
+
+private:
+    std::array<uint32_t, Size / 32> _bits;
+};
+
+// Fixed capacity set of notes ordered by ascending note number.
+// Note is a struct with a `note` member used as the key, inserting and removing uses a binary search and moves
+// the following notes in place, so no memory is allocated when notes are played.
+template<typename Note, size_t Capacity>
+class NoteSet {
+public:
+    typedef decltype(Note::note) Key;
+
+    size_t capacity() const { return Capacity; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size >= Capacity; }
+
+    void clear() { _size = 0; }
+
+    const Note &operator[](size_t index) const { return _notes[index]; }
+          Note &operator[](size_t index)       { return _notes[index]; }
+
+    const Note *begin() const { return _notes.data(); }
+    const Note *end() const { return _notes.data() + _size; }
+
+    // index of the note or -1 if not in set
+    int find(Key note) const {
+        size_t index = lowerBound(note);
+        return (index < _size && _notes[index].note == note) ? int(index) : -1;
+    }
+
+    bool contains(Key note) const { return find(note) != -1; }
+
+    // insert a note, returns the index of the inserted note or -1 if the note is already in the set or the set is full
+    int insert(const Note &note) {
+        size_t index = lowerBound(note.note);
+        if (_size >= Capacity || (index < _size && _notes[index].note == note.note)) {
+            return -1;
+        }
+        std::copy_backward(_notes.begin() + index, _notes.begin() + _size, _notes.begin() + _size + 1);
+        _notes[index] = note;
+        ++_size;
+        return int(index);
+    }
+
+    // remove the note at the given index
+    void erase(size_t index) {
+        std::copy(_notes.begin() + index + 1, _notes.begin() + _size, _notes.begin() + index);
+        --_size;
+    }
+
+    // remove a note, returns false if the note is not in the set
+    bool remove(Key note) {
+        int index = find(note);
+        if (index == -1) {
+            return false;
+        }
+        erase(index);
+        return true;
+    }
+
+private:
+    size_t lowerBound(Key note) const {
+        return std::lower_bound(_notes.begin(), _notes.begin() + _size, note, [] (const Note &a, Key b) { return a.note < b; }) - _notes.begin();
+    }
+
+    std::array<Note, Capacity> _notes;
+    size_t _size = 0;
+};
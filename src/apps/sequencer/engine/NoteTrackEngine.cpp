@@ -10,6 +10,7 @@
 #include "core/math/Math.h"
 
 #include "model/NoteSequence.h"
+#include "model/QuantizerTable.h"
 #include "model/Scale.h"
 #include "ui/MatrixMap.h"
 #include <climits>
@@ -68,17 +69,18 @@ static int evalStepLength(const NoteSequence::Step &step, int lengthBias) {
 }
 
 // evaluate transposition
-static int evalTransposition(const Scale &scale, int octave, int transpose) {
-    return octave * scale.notesPerOctave() + transpose;
+static int evalTransposition(const QuantizerTable &quantizer, int octave, int transpose) {
+    return octave * quantizer.notesPerOctave() + transpose;
 }
 
 // evaluate note voltage
-static float evalStepNote(const NoteSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, bool useVariation = true) {
+static float evalStepNote(const NoteSequence::Step &step, int probabilityBias, const QuantizerTable &quantizer, int rootNote, int octave, int transpose, bool useVariation = true) {
 
 
     if (step.bypassScale()) {
+        // bypassing the scale quantizes to semitones, which does not need a (cached) quantizer table
         const Scale &bypassScale = Scale::get(0);
-        int note = step.note() + evalTransposition(bypassScale, octave, transpose);
+        int note = step.note() + octave * bypassScale.notesPerOctave() + transpose;
         int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, NoteSequence::NoteVariationProbability::Max);
         if (useVariation && int(rng.nextRange(NoteSequence::NoteVariationProbability::Range)) <= probability) {
             int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
@@ -89,7 +91,7 @@ static float evalStepNote(const NoteSequence::Step &step, int probabilityBias, c
         }
         return bypassScale.noteToVolts(note) + (bypassScale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
     }
-    int note = step.note() + evalTransposition(scale, octave, transpose);
+    int note = step.note() + evalTransposition(quantizer, octave, transpose);
     int probability = clamp(step.noteVariationProbability() + probabilityBias, -1, NoteSequence::NoteVariationProbability::Max);
     if (useVariation && int(rng.nextRange(NoteSequence::NoteVariationProbability::Range)) <= probability) {
         int offset = step.noteVariationRange() == 0 ? 0 : rng.nextRange(std::abs(step.noteVariationRange()) + 1);
@@ -98,7 +100,7 @@ static float evalStepNote(const NoteSequence::Step &step, int probabilityBias, c
         }
         note = NoteSequence::Note::clamp(note + offset);
     }
-    return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    return quantizer.noteToVolts(note);
 }
 
 void NoteTrackEngine::reset() {
@@ -236,28 +238,27 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         if (!_monitorOverrideActive) {
             result |= TickResult::GateUpdate;
-            _activity = _gateQueue.front().gate;
+            _activity = gate.gate;
             _gateOutput = (!mute() || fill()) && _activity;
             midiOutputEngine.sendGate(_track.trackIndex(), _gateOutput);
         }
-        _gateQueue.pop();
-
     }
 
-    while (!_cvQueue.empty() && tick >= _cvQueue.front().tick) {
+    Cv cv;
+    while (_cvQueue.pop(tick, cv)) {
         if (!mute() || _noteTrack.cvUpdateMode() == NoteTrack::CvUpdateMode::Always) {
             if (!_monitorOverrideActive) {
                 result |= TickResult::CvUpdate;
-                _cvOutputTarget = _cvQueue.front().cv;
-                _slideActive = _cvQueue.front().slide;
+                _cvOutputTarget = cv.cv;
+                _slideActive = cv.slide;
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
         }
-        _cvQueue.pop();
     }
 
     return result;
@@ -268,8 +269,8 @@ void NoteTrackEngine::update(float dt) {
     bool recording = _engine.state().recording();
 
     const auto &sequence = *_sequence;
-    const auto &scale = sequence.selectedScale(_model.project().scale());
     int rootNote = sequence.selectedRootNote(_model.project().rootNote());
+    const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
     int octave = _noteTrack.octave();
     int transpose = _noteTrack.transpose();
 
@@ -323,10 +324,10 @@ void NoteTrackEngine::update(float dt) {
 
     if (stepMonitoring) {
         const auto &step = sequence.step(_monitorStepIndex);
-        setOverride(evalStepNote(step, 0, scale, rootNote, octave, transpose, false));
+        setOverride(evalStepNote(step, 0, quantizer, rootNote, octave, transpose, false));
     } else if (liveMonitoring && _recordHistory.isNoteActive()) {
-        int note = noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(scale, octave, transpose);
-        setOverride(scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f));
+        int note = quantizer.noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(quantizer, octave, transpose);
+        setOverride(quantizer.noteToVolts(note));
     } else {
         clearOverride();
     }
@@ -343,8 +344,8 @@ void NoteTrackEngine::changePattern() {
     _fillSequence = &_noteTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
-void NoteTrackEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
-    _recordHistory.write(tick, message);
+void NoteTrackEngine::monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) {
+    _recordHistory.write(tick, fraction, message);
 
     if (_engine.recording() && _model.project().recordMode() == Types::RecordMode::StepRecord) {
         _stepRecorder.process(message, *_sequence, [this] (int midiNote) { return noteFromMidiNote(midiNote); });
@@ -470,9 +471,9 @@ void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNextS
     }
 
     if (stepGate || _noteTrack.cvUpdateMode() == NoteTrack::CvUpdateMode::Always) {
-        const auto &scale = evalSequence.selectedScale(_model.project().scale());
         int rootNote = evalSequence.selectedRootNote(_model.project().rootNote());
-        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _noteTrack.noteProbabilityBias(), scale, rootNote, octave, transpose), step.slide() });
+        const auto &quantizer = QuantizerTable::get(evalSequence.selectedScale(_model.project().scale()), rootNote);
+        _cvQueue.push({ Groove::applySwing(stepTick, swing()), evalStepNote(step, _noteTrack.noteProbabilityBias(), quantizer, rootNote, octave, transpose), step.slide() });
     }
 }
 
@@ -488,9 +489,9 @@ void NoteTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
 
     bool stepWritten = false;
 
-    auto writeStep = [this, divisor, &stepWritten] (int stepIndex, int note, int lengthTicks) {
+    auto writeStep = [this, divisor, &stepWritten] (int stepIndex, int note, float lengthTicks) {
         auto &step = _sequence->step(stepIndex);
-        int length = (lengthTicks * NoteSequence::Length::Range) / divisor;
+        int length = int((lengthTicks * NoteSequence::Length::Range) / divisor);
 
         step.setGate(true);
         step.setGateProbability(NoteSequence::GateProbability::Max);
@@ -514,9 +515,10 @@ void NoteTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
         step.clear();
     };
 
+    // note times are in (fractional) ticks relative to the step start
     uint32_t stepStart = tick - divisor;
-    uint32_t stepEnd = tick;
-    uint32_t margin = divisor / 2;
+    float stepEnd = divisor;
+    float margin = divisor / 2;
 
     for (size_t i = 0; i < _recordHistory.size(); ++i) {
         if (_recordHistory[i].type != RecordHistory::Type::NoteOn) {
@@ -524,23 +526,23 @@ void NoteTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
         }
 
         int note = _recordHistory[i].note;
-        uint32_t noteStart = _recordHistory[i].tick;
-        uint32_t noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].tick : tick;
+        float noteStart = _recordHistory[i].offset(stepStart);
+        float noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].offset(stepStart) : stepEnd;
 
-        if (noteStart >= stepStart - margin && noteStart < stepStart + margin) {
+        if (noteStart >= -margin && noteStart < margin) {
             // note on during step start phase
             if (noteEnd >= stepEnd) {
                 // note hold during step
-                int length = std::min(noteEnd, stepEnd) - stepStart;
+                float length = std::min(noteEnd, stepEnd);
                 writeStep(_sequenceState.prevStep(), note, length);
             } else {
                 // note released during step
-                int length = noteEnd - noteStart;
+                float length = noteEnd - noteStart;
                 writeStep(_sequenceState.prevStep(), note, length);
             }
-        } else if (noteStart < stepStart && noteEnd > stepStart) {
+        } else if (noteStart < 0.f && noteEnd > 0.f) {
             // note on during previous step
-            int length = std::min(noteEnd, stepEnd) - stepStart;
+            float length = std::min(noteEnd, stepEnd);
             writeStep(_sequenceState.prevStep(), note, length);
         }
     }
@@ -554,9 +556,5 @@ int NoteTrackEngine::noteFromMidiNote(uint8_t midiNote) const {
     const auto &scale = _sequence->selectedScale(_model.project().scale());
     int rootNote = _sequence->selectedRootNote(_model.project().rootNote());
 
-    if (scale.isChromatic()) {
-        return scale.noteFromVolts((midiNote - 60 - rootNote) * (1.f / 12.f));
-    } else {
-        return scale.noteFromVolts((midiNote - 60) * (1.f / 12.f));
-    }
+    return QuantizerTable::get(scale, rootNote).noteFromMidiNote(midiNote);
 }
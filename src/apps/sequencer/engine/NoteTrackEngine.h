@@ -2,7 +2,7 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "EventScheduler.h"
 #include "Groove.h"
 #include "RecordHistory.h"
 #include "model/NoteSequence.h"
@@ -26,11 +26,13 @@ public:
 
     virtual void changePattern() override;
 
-    virtual void monitorMidi(uint32_t tick, const MidiMessage &message) override;
+    virtual void monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) override;
     virtual void clearMidiMonitoring() override;
 
     virtual const TrackLinkData *linkData() const override { return &_linkData; }
 
+    virtual uint32_t eventOverflowCount() const override { return _gateQueue.overflowCount() + _cvQueue.overflowCount(); }
+
     virtual bool activity() const override { return _activity; }
     virtual bool gateOutput(int index) const override { return _gateOutput; }
     virtual float cvOutput(int index) const override { return _cvOutput; }
@@ -96,13 +98,7 @@ private:
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    EventScheduler<Gate, 32> _gateQueue;
 
     struct Cv {
         uint32_t tick;
@@ -110,11 +106,5 @@ private:
         bool slide;
     };
 
-    struct CvCompare {
-        bool operator()(const Cv &a, const Cv &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Cv, 16, CvCompare> _cvQueue;
+    EventScheduler<Cv, 16> _cvQueue;
 };
@@ -18,8 +18,14 @@ public:
 
     struct Event {
         uint32_t tick;
+        uint8_t fraction; // fractional tick in 1/256 ticks
         Type type;
         int8_t note;
+
+        // time of the event in ticks relative to the given tick
+        float offset(uint32_t reference) const {
+            return int32_t(tick - reference) + fraction * (1.f / 256.f);
+        }
     };
 
     RecordHistory() {
@@ -34,33 +40,36 @@ public:
 
     size_t size() const { return _size; }
 
-    void write(uint32_t tick, Type type, int note) {
+    // write event at the given tick and fractional tick [0..1)
+    void write(uint32_t tick, float fraction, Type type, int note) {
         if (note < 0 || note > 127) {
             return;
         }
 
+        uint8_t fixedFraction = std::min(255, std::max(0, int(fraction * 256.f)));
+
         switch (type) {
         case Type::NoteOn:
             if (_activeNote >= 0 && _activeNote != note) {
-                write({ tick, Type::NoteOff, _activeNote });
+                write({ tick, fixedFraction, Type::NoteOff, _activeNote });
             }
             _activeNote = note;
-            write({ tick, Type::NoteOn, int8_t(note) });
+            write({ tick, fixedFraction, Type::NoteOn, int8_t(note) });
             break;
         case Type::NoteOff:
             if (_activeNote == note) {
                 _activeNote = -1;
-                write({ tick, Type::NoteOff, int8_t(note) });
+                write({ tick, fixedFraction, Type::NoteOff, int8_t(note) });
             }
             break;
         }
     }
 
-    void write(uint32_t tick, const MidiMessage &message) {
+    void write(uint32_t tick, float fraction, const MidiMessage &message) {
         if (message.isNoteOn()) {
-            write(tick, Type::NoteOn, message.note());
+            write(tick, fraction, Type::NoteOn, message.note());
         } else if (message.isNoteOff()) {
-            write(tick, Type::NoteOff, message.note());
+            write(tick, fraction, Type::NoteOff, message.note());
         }
     }
 
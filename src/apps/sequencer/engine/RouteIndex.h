@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+
+#include <cstdint>
+#include <cstddef>
+
+// Dispatch index mapping route sources to the routes listening to them.
+//
+// MIDI routes are keyed on port, channel (or omni), message kind and controller/note number and stored in a hash
+// table with buckets laid out contiguously (rebuilt with a counting sort), so looking up the routes of an incoming
+// message only visits the routes listening to that exact key, independent of the number of routes.
+// Note range routes cannot be keyed on a single note and are stored under a shared key per port and channel.
+// CV routes are grouped by CV source, so each source only needs to be read once per update.
+template<size_t RouteCount, size_t CvSourceCount>
+class RouteIndex {
+    static_assert(RouteCount > 0 && RouteCount < 256, "invalid route count");
+public:
+    enum class MidiKind : uint8_t {
+        ControlChange,
+        Note,
+        NoteRange,
+        PitchBend,
+    };
+
+    static constexpr int Omni = -1; // same as omni channel in MidiSourceConfig
+
+    RouteIndex() {
+        clear();
+        build();
+    }
+
+    // start collecting routes for a new index
+    void clear() {
+        _midiCount = 0;
+        _cvCount = 0;
+    }
+
+    // add a MIDI route, channel is Omni to match all channels, number is ignored for note range and pitch bend
+    void addMidiRoute(int port, int channel, MidiKind kind, int number, int routeIndex) {
+        if (_midiCount >= RouteCount) {
+            return;
+        }
+        if (kind == MidiKind::NoteRange || kind == MidiKind::PitchBend) {
+            number = 0;
+        }
+        _pending[_midiCount++] = { midiKey(port, channel, kind, number), uint8_t(routeIndex) };
+    }
+
+    void addCvRoute(int cvSource, int routeIndex) {
+        if (_cvCount >= RouteCount || cvSource < 0 || cvSource >= int(CvSourceCount)) {
+            return;
+        }
+        _cvPending[_cvCount++] = { uint8_t(cvSource), uint8_t(routeIndex) };
+    }
+
+    // build the index from the collected routes
+    void build() {
+        // MIDI routes, counting sort into buckets (keeps route order within buckets)
+        _bucketStart.fill(0);
+        for (size_t i = 0; i < _midiCount; ++i) {
+            ++_bucketStart[bucket(_pending[i].key) + 1];
+        }
+        for (size_t i = 0; i < MidiBuckets; ++i) {
+            _bucketStart[i + 1] += _bucketStart[i];
+        }
+        std::array<uint8_t, MidiBuckets> fill;
+        for (size_t i = 0; i < MidiBuckets; ++i) {
+            fill[i] = _bucketStart[i];
+        }
+        for (size_t i = 0; i < _midiCount; ++i) {
+            _midiEntries[fill[bucket(_pending[i].key)]++] = _pending[i];
+        }
+
+        // CV routes, counting sort by source
+        _cvStart.fill(0);
+        for (size_t i = 0; i < _cvCount; ++i) {
+            ++_cvStart[_cvPending[i].source + 1];
+        }
+        for (size_t i = 0; i < CvSourceCount; ++i) {
+            _cvStart[i + 1] += _cvStart[i];
+        }
+        std::array<uint8_t, CvSourceCount> cvFill;
+        for (size_t i = 0; i < CvSourceCount; ++i) {
+            cvFill[i] = _cvStart[i];
+        }
+        for (size_t i = 0; i < _cvCount; ++i) {
+            _cvRoutes[cvFill[_cvPending[i].source]++] = _cvPending[i].route;
+        }
+    }
+
+    size_t midiRouteCount() const { return _midiCount; }
+    size_t cvRouteCount() const { return _cvCount; }
+
+    // call f(routeIndex) for all routes listening to the given MIDI key on the exact channel or omni
+    template<typename F>
+    void forEachMidiRoute(int port, int channel, MidiKind kind, int number, F f) const {
+        forEachMidiKey(midiKey(port, channel, kind, number), f);
+        forEachMidiKey(midiKey(port, Omni, kind, number), f);
+    }
+
+    // call f(routeIndex) for all routes listening to the given CV source
+    template<typename F>
+    void forEachCvRoute(int cvSource, F f) const {
+        for (int i = _cvStart[cvSource]; i < _cvStart[cvSource + 1]; ++i) {
+            f(_cvRoutes[i]);
+        }
+    }
+
+private:
+    static constexpr size_t MidiBucketBits = RouteCount <= 16 ? 5 : RouteCount <= 64 ? 7 : 8;
+    static constexpr size_t MidiBuckets = 1 << MidiBucketBits;
+
+    // key layout: number (7 bits) | kind (2 bits) | channel + 1 (5 bits) | port (1 bit)
+    static uint16_t midiKey(int port, int channel, MidiKind kind, int number) {
+        return (number & 0x7f) | (int(kind) << 7) | ((channel + 1) << 9) | ((port & 1) << 14);
+    }
+
+    static size_t bucket(uint16_t key) {
+        return (uint32_t(key) * 2654435761u) >> (32 - MidiBucketBits);
+    }
+
+    template<typename F>
+    void forEachMidiKey(uint16_t key, F f) const {
+        size_t b = bucket(key);
+        for (int i = _bucketStart[b]; i < _bucketStart[b + 1]; ++i) {
+            if (_midiEntries[i].key == key) {
+                f(_midiEntries[i].route);
+            }
+        }
+    }
+
+    struct MidiEntry {
+        uint16_t key;
+        uint8_t route;
+    };
+
+    struct CvEntry {
+        uint8_t source;
+        uint8_t route;
+    };
+
+    std::array<MidiEntry, RouteCount> _pending;
+    std::array<MidiEntry, RouteCount> _midiEntries;
+    std::array<uint8_t, MidiBuckets + 1> _bucketStart;
+    size_t _midiCount;
+
+    std::array<CvEntry, RouteCount> _cvPending;
+    std::array<uint8_t, RouteCount> _cvRoutes;
+    std::array<uint8_t, CvSourceCount + 1> _cvStart;
+    size_t _cvCount;
+};
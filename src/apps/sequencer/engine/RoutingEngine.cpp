@@ -3,6 +3,10 @@
 #include "Engine.h"
 #include "MidiUtils.h"
 
+#include "core/profiler/Profiler.h"
+
+#include <cmath>
+
 // for allowing direct mapping
 static_assert(int(MidiPort::Midi) == int(Types::MidiPort::Midi), "invalid mapping");
 static_assert(int(MidiPort::UsbMidi) == int(Types::MidiPort::UsbMidi), "invalid mapping");
@@ -12,121 +16,193 @@ RoutingEngine::RoutingEngine(Engine &engine, Model &model) :
     _routing(model.project().routing())
 {}
 
+PROFILER_INTERVAL(routingUpdate, "routing update")
+
 void RoutingEngine::update() {
+    PROFILER_INTERVAL_BEGIN(routingUpdate)
+    updateIndex();
     updateSources();
     updateSinks();
+    PROFILER_INTERVAL_END(routingUpdate)
 }
 
 bool RoutingEngine::receiveMidi(MidiPort port, const MidiMessage &message) {
+    // routes only listen to the hardware MIDI ports
+    if (port != MidiPort::Midi && port != MidiPort::UsbMidi) {
+        return false;
+    }
+
+    typedef Index::MidiKind MidiKind;
+
     bool consumed = false;
+    auto dispatch = [&] (MidiKind kind, int number) {
+        _routeIndex.forEachMidiRoute(int(port), message.channel(), kind, number, [&] (int routeIndex) {
+            consumed |= receiveMidiRoute(routeIndex, message);
+        });
+    };
+
+    if (message.isControlChange()) {
+        dispatch(MidiKind::ControlChange, message.controlNumber());
+    } else if (message.isNoteOn() || message.isNoteOff()) {
+        dispatch(MidiKind::Note, message.note());
+        dispatch(MidiKind::NoteRange, 0);
+    } else if (message.isPitchBend()) {
+        dispatch(MidiKind::PitchBend, 0);
+    }
+
+    return consumed;
+}
 
+void RoutingEngine::updateIndex() {
+    bool changed = !_indexValid;
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        uint32_t indexedSource = sourceKey(_routing.route(routeIndex));
+        if (indexedSource != _indexedSources[routeIndex]) {
+            _indexedSources[routeIndex] = indexedSource;
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    typedef Index::MidiKind MidiKind;
+
+    _routeIndex.clear();
     for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
         const auto &route = _routing.route(routeIndex);
-        if (route.active() &&
-            route.source() == Routing::Source::Midi &&
-            MidiUtils::matchSource(port, message, route.midiSource().source())
-        ) {
+        if (!route.active()) {
+            continue;
+        }
+        if (Routing::isCvSource(route.source())) {
+            _routeIndex.addCvRoute(int(route.source()) - int(Routing::Source::CvFirst), routeIndex);
+        } else if (Routing::isMidiSource(route.source())) {
             const auto &midiSource = route.midiSource();
-            auto &sourceValue = _sourceValues[routeIndex];
+            int port = int(midiSource.source().port());
+            int channel = midiSource.source().channel(); // omni channel maps to Index::Omni
             switch (midiSource.event()) {
             case Routing::MidiSource::Event::ControlAbsolute:
-                if (message.controlNumber() == midiSource.controlNumber()) {
-                    sourceValue = message.controlValue() * (1.f / 127.f);
-                    consumed = true;
-                }
-                break;
             case Routing::MidiSource::Event::ControlRelative:
-                if (message.controlNumber() == midiSource.controlNumber()) {
-                    int value = message.controlValue();
-                    value = value >= 64 ? 64 - value : value;
-                    sourceValue = clamp(sourceValue + value * (1.f / 127.f), 0.f, 1.f);
-                    consumed = true;
-                }
+                _routeIndex.addMidiRoute(port, channel, MidiKind::ControlChange, midiSource.controlNumber(), routeIndex);
                 break;
             case Routing::MidiSource::Event::PitchBend:
-                if (message.isPitchBend()) {
-                    sourceValue = (message.pitchBend() + 0x2000) * (1.f / 16383.f);
-                    consumed = true;
-                }
+                _routeIndex.addMidiRoute(port, channel, MidiKind::PitchBend, 0, routeIndex);
                 break;
             case Routing::MidiSource::Event::NoteMomentary:
-                if (message.isNoteOn() && message.note() == midiSource.note()) {
-                    sourceValue = 1.f;
-                    consumed = true;
-                } else if (message.isNoteOff() && message.note() == midiSource.note()) {
-                    sourceValue = 0.f;
-                    consumed = true;
-                }
-                break;
             case Routing::MidiSource::Event::NoteToggle:
-                if (message.isNoteOn() && message.note() == midiSource.note()) {
-                    sourceValue = sourceValue < 0.5f ? 1.f : 0.f;
-                    consumed = true;
-                }
-                break;
             case Routing::MidiSource::Event::NoteVelocity:
-                if (message.isNoteOn() && message.note() == midiSource.note()) {
-                    sourceValue = message.velocity() * (1.f / 127.f);
-                    consumed = true;
-                }
+                _routeIndex.addMidiRoute(port, channel, MidiKind::Note, midiSource.note(), routeIndex);
                 break;
             case Routing::MidiSource::Event::NoteRange:
-                if (message.isNoteOn() && message.note() >= midiSource.note() && message.note() < midiSource.note() + midiSource.noteRange()) {
-                    sourceValue = (message.note() - midiSource.note()) / float(midiSource.noteRange() - 1);
-                    consumed = true;
-                }
+                _routeIndex.addMidiRoute(port, channel, MidiKind::NoteRange, 0, routeIndex);
                 break;
             case Routing::MidiSource::Event::Last:
                 break;
             }
+        } else {
+            _sourceValues[routeIndex] = 0.f;
         }
     }
+    _routeIndex.build();
 
-    return consumed;
+    _indexValid = true;
+}
+
+uint32_t RoutingEngine::sourceKey(const Routing::Route &route) {
+    if (!route.active()) {
+        return 0;
+    }
+    uint32_t key = 1 | (uint32_t(route.source()) << 1);
+    if (Routing::isMidiSource(route.source())) {
+        const auto &midiSource = route.midiSource();
+        key |= (uint32_t(midiSource.source().port()) << 8) |
+               (uint32_t(midiSource.source().channel() + 1) << 9) |
+               (uint32_t(midiSource.event()) << 14) |
+               (uint32_t(midiSource.controlNumber()) << 17);
+    }
+    return key;
+}
+
+bool RoutingEngine::receiveMidiRoute(int routeIndex, const MidiMessage &message) {
+    const auto &midiSource = _routing.route(routeIndex).midiSource();
+    auto &sourceValue = _sourceValues[routeIndex];
+
+    // messages are already matched on port, channel, message kind and controller/note number by the route index
+    switch (midiSource.event()) {
+    case Routing::MidiSource::Event::ControlAbsolute:
+        sourceValue = message.controlValue() * (1.f / 127.f);
+        return true;
+    case Routing::MidiSource::Event::ControlRelative: {
+        int value = message.controlValue();
+        value = value >= 64 ? 64 - value : value;
+        sourceValue = clamp(sourceValue + value * (1.f / 127.f), 0.f, 1.f);
+        return true;
+    }
+    case Routing::MidiSource::Event::PitchBend:
+        sourceValue = (message.pitchBend() + 0x2000) * (1.f / 16383.f);
+        return true;
+    case Routing::MidiSource::Event::NoteMomentary:
+        sourceValue = message.isNoteOn() ? 1.f : 0.f;
+        return true;
+    case Routing::MidiSource::Event::NoteToggle:
+        if (message.isNoteOn()) {
+            sourceValue = sourceValue < 0.5f ? 1.f : 0.f;
+            return true;
+        }
+        break;
+    case Routing::MidiSource::Event::NoteVelocity:
+        if (message.isNoteOn()) {
+            sourceValue = message.velocity() * (1.f / 127.f);
+            return true;
+        }
+        break;
+    case Routing::MidiSource::Event::NoteRange:
+        if (message.isNoteOn() && message.note() >= midiSource.note() && message.note() < midiSource.note() + midiSource.noteRange()) {
+            sourceValue = (message.note() - midiSource.note()) / float(midiSource.noteRange() - 1);
+            return true;
+        }
+        break;
+    case Routing::MidiSource::Event::Last:
+        break;
+    }
+
+    return false;
 }
 
 void RoutingEngine::updateSources() {
-    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
-        const auto &route = _routing.route(routeIndex);
-        if (route.active()) {
-            auto &sourceValue = _sourceValues[routeIndex];
-            switch (route.source()) {
-            case Routing::Source::None:
-                sourceValue = 0.f;
-                break;
-            case Routing::Source::CvIn1:
-            case Routing::Source::CvIn2:
-            case Routing::Source::CvIn3:
-            case Routing::Source::CvIn4: {
-                const auto &range = Types::voltageRangeInfo(route.cvSource().range());
-                int index = int(route.source()) - int(Routing::Source::CvIn1);
-                sourceValue = range.normalize(_engine.cvInput().channel(index));
-                break;
-            }
-            case Routing::Source::CvOut1:
-            case Routing::Source::CvOut2:
-            case Routing::Source::CvOut3:
-            case Routing::Source::CvOut4:
-            case Routing::Source::CvOut5:
-            case Routing::Source::CvOut6:
-            case Routing::Source::CvOut7:
-            case Routing::Source::CvOut8: {
-                const auto &range = Types::voltageRangeInfo(route.cvSource().range());
-                int index = int(route.source()) - int(Routing::Source::CvOut1);
-                sourceValue = range.normalize(_engine.cvOutput().channel(index));
-                break;
-            }
-            case Routing::Source::Midi:
-                // handled in receiveMidi
-                break;
-            case Routing::Source::Last:
-                break;
-            }
+    // read each CV source once and update all routes listening to it
+    for (int cvSource = 0; cvSource < CvSourceCount; ++cvSource) {
+        auto source = Routing::Source(int(Routing::Source::CvFirst) + cvSource);
+        float voltage;
+        if (source <= Routing::Source::CvIn4) {
+            voltage = _engine.cvInput().channel(int(source) - int(Routing::Source::CvIn1));
+        } else {
+            voltage = _engine.cvOutput().channel(int(source) - int(Routing::Source::CvOut1));
         }
+        _routeIndex.forEachCvRoute(cvSource, [&] (int routeIndex) {
+            const auto &range = Types::voltageRangeInfo(_routing.route(routeIndex).cvSource().range());
+            _sourceValues[routeIndex] = range.normalize(voltage);
+        });
     }
 }
 
 void RoutingEngine::updateSinks() {
+    // periodically write all targets to pick up model changes outside of routing (e.g. pasted sequences)
+    bool refresh = _invalidated || ++_refreshCounter >= CONFIG_ROUTING_REFRESH_INTERVAL;
+    if (refresh) {
+        _invalidated = false;
+        _refreshCounter = 0;
+    }
+
+    _pendingTracks.fill(0);
+    _writtenTracks.fill(0);
+
+    auto targetTracks = [] (const Routing::Route &route) -> uint8_t {
+        return Routing::isPerTrackTarget(route.target()) ? route.tracks() : 0xff;
+    };
+
+    // disable changed routings, write engine targets and collect pending targets
     for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
         const auto &route = _routing.route(routeIndex);
         auto &routeState = _routeStates[routeIndex];
@@ -145,17 +221,71 @@ void RoutingEngine::updateSinks() {
             }
         }
 
-        if (route.active()) {
-            auto target = route.target();
-            float value = route.min() + _sourceValues[routeIndex] * (route.max() - route.min());
-            if (Routing::isEngineTarget(target)) {
-                writeEngineTarget(target, value);
-            } else {
-                _routing.writeTarget(target, route.tracks(), value);
-            }
+        if (!route.active()) {
+            continue;
         }
 
-        if (routeChanged) {
+        auto target = route.target();
+        float sourceValue = _sourceValues[routeIndex];
+
+        if (Routing::isEngineTarget(target)) {
+            writeEngineTarget(target, route.min() + sourceValue * (route.max() - route.min()));
+            ++_stats.evaluated;
+            continue;
+        }
+
+        // play state targets are compared against the current play state when written, so always write them
+        routeState.pending =
+            refresh ||
+            routeChanged ||
+            Routing::isPlayStateTarget(target) ||
+            route.source() != routeState.source ||
+            route.min() != routeState.min ||
+            route.max() != routeState.max ||
+            std::abs(sourceValue - routeState.sourceValue) >= _epsilon;
+
+        if (routeState.pending) {
+            _pendingTracks[size_t(target)] |= targetTracks(route);
+        }
+    }
+
+    // write pending targets, later routes take precedence over earlier routes on the same target and track
+    for (int routeIndex = CONFIG_ROUTE_COUNT - 1; routeIndex >= 0; --routeIndex) {
+        const auto &route = _routing.route(routeIndex);
+        auto &routeState = _routeStates[routeIndex];
+
+        auto target = route.target();
+        if (!route.active() || Routing::isEngineTarget(target)) {
+            continue;
+        }
+
+        uint8_t tracks = targetTracks(route);
+        uint8_t writeTracks = tracks & _pendingTracks[size_t(target)] & ~_writtenTracks[size_t(target)];
+        _writtenTracks[size_t(target)] |= tracks;
+
+        float sourceValue = _sourceValues[routeIndex];
+
+        if (writeTracks) {
+            _routing.writeTarget(target, writeTracks, route.min() + sourceValue * (route.max() - route.min()));
+            ++_stats.evaluated;
+        } else {
+            ++_stats.skipped;
+        }
+
+        if (writeTracks || routeState.pending) {
+            routeState.source = route.source();
+            routeState.min = route.min();
+            routeState.max = route.max();
+            routeState.sourceValue = sourceValue;
+        }
+    }
+
+    // enable changed routings
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        const auto &route = _routing.route(routeIndex);
+        auto &routeState = _routeStates[routeIndex];
+
+        if (route.target() != routeState.target || route.tracks() != routeState.tracks) {
             // enable new routing
             Routing::setRouted(route.target(), route.tracks(), true);
             // save state
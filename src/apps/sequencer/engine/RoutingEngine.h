@@ -3,6 +3,7 @@
 #include "Config.h"
 
 #include "MidiPort.h"
+#include "RouteIndex.h"
 
 #include "model/Model.h"
 
@@ -16,13 +17,34 @@ class Engine;
 
 class RoutingEngine {
 public:
+    struct Stats {
+        uint32_t evaluated;
+        uint32_t skipped;
+    };
+
     RoutingEngine(Engine &engine, Model &model);
 
     void update();
 
     bool receiveMidi(MidiPort port, const MidiMessage &message);
 
+    // minimum change of a normalized source value to update the route target
+    float epsilon() const { return _epsilon; }
+    void setEpsilon(float epsilon) { _epsilon = epsilon; }
+
+    // force writing all route targets on next update
+    void invalidate() { _invalidated = true; }
+
+    const Stats &stats() const { return _stats; }
+
 private:
+    static constexpr int CvSourceCount = int(Routing::Source::CvLast) - int(Routing::Source::CvFirst) + 1;
+
+    typedef RouteIndex<CONFIG_ROUTE_COUNT, CvSourceCount> Index;
+
+    void updateIndex();
+    static uint32_t sourceKey(const Routing::Route &route);
+    bool receiveMidiRoute(int routeIndex, const MidiMessage &message);
     void updateSources();
     void updateSinks();
 
@@ -33,13 +55,32 @@ private:
 
     std::array<float, CONFIG_ROUTE_COUNT> _sourceValues;
 
+    // route sources the index was built from, the index is rebuilt when any of them changes
+    std::array<uint32_t, CONFIG_ROUTE_COUNT> _indexedSources;
+    bool _indexValid = false;
+    Index _routeIndex;
+
     struct RouteState {
         Routing::Target target = Routing::Target::None;
         uint8_t tracks = 0;
+        Routing::Source source = Routing::Source::None;
+        float min = 0.f;
+        float max = 0.f;
+        float sourceValue = 0.f;
+        bool pending = true;
     };
 
     std::array<RouteState, CONFIG_ROUTE_COUNT> _routeStates;
 
+    // per target track masks used to coalesce writes of multiple routes
+    std::array<uint8_t, size_t(Routing::Target::Last)> _pendingTracks;
+    std::array<uint8_t, size_t(Routing::Target::Last)> _writtenTracks;
+
+    float _epsilon = CONFIG_ROUTING_EPSILON;
+    bool _invalidated = true;
+    uint32_t _refreshCounter = 0;
+    Stats _stats = { 0, 0 };
+
     uint8_t _lastPlayToggleActive = false;
     uint8_t _lastRecordToggleActive = false;
 };
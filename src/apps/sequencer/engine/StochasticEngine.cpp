@@ -7,10 +7,12 @@
 #include "SequenceUtils.h"
 
 #include "core/Debug.h"
+#include "core/profiler/Profiler.h"
 #include "core/utils/Random.h"
 #include "core/math/Math.h"
 
 #include "model/StochasticSequence.h"
+#include "model/QuantizerTable.h"
 #include "model/Scale.h"
 #include "ui/MatrixMap.h"
 #include <algorithm>
@@ -26,9 +28,27 @@
 
 static Random rng;
 
-bool sortTaskByProbRev(const StochasticStep& lhs, const StochasticStep& rhs) {
-    return lhs.probability() > rhs.probability();
+#if CONFIG_ENABLE_PROFILER
+PROFILER_MEMORY(lockedSteps, "stochastic locked steps (all tracks)")
+
+// locked steps are accounted per track, the profiler reports the sum over all stochastic tracks
+static uint32_t lockedStepsUsed[CONFIG_TRACK_COUNT];
+static uint32_t lockedStepsReserved[CONFIG_TRACK_COUNT];
+
+static void accountLockedSteps(int trackIndex, uint32_t used, uint32_t reserved) {
+    lockedStepsUsed[trackIndex] = used;
+    lockedStepsReserved[trackIndex] = reserved;
+    uint32_t totalUsed = 0;
+    uint32_t totalReserved = 0;
+    for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
+        totalUsed += lockedStepsUsed[i];
+        totalReserved += lockedStepsReserved[i];
+    }
+    PROFILER_MEMORY_USE(lockedSteps, totalUsed, totalReserved);
 }
+#else // CONFIG_ENABLE_PROFILER
+static void accountLockedSteps(int trackIndex, uint32_t used, uint32_t reserved) {}
+#endif // CONFIG_ENABLE_PROFILER
 
 // evaluate if step gate is active
 static bool evalStepGate(const StochasticSequence::Step &step, int probabilityBias) {
@@ -41,36 +61,15 @@ static bool evalStepGate(const StochasticSequence::Step &step, int probabilityBi
 
 // evaluate if step gate is active
  int StochasticEngine::evalRestProbability(StochasticSequence &sequence) {
-    int sum = 0;
-    std::vector<StochasticStep> probability;
-    for (int i = 0; i < 4; i++) {
-
-        switch (i) {
-            case 0: {
-                probability.insert(probability.end(), StochasticStep(i, sequence.restProbability()));
-            }
-                break;
-            case 1: {
-                probability.insert(probability.end(), StochasticStep(i, sequence.restProbability2()));
-                break;
-            }
-            case 2: {
-                probability.insert(probability.end(), StochasticStep(i, sequence.restProbability4()));
-                break;
-            }
-            case 3: {
-                probability.insert(probability.end(), StochasticStep(i, sequence.restProbability8()));
-                break;
-            }
-            default:
-                break;
-        }
-
-        sum = sum + probability.at(i).probability();
-    }
-    if (sum==0) { return -1;}
-    std::sort (std::begin(probability), std::end(probability), sortTaskByProbRev);
-    int stepIndex = getNextWeightedPitch(probability, probability.size());
+    int probabilities[4] = {
+        sequence.restProbability(),
+        sequence.restProbability2(),
+        sequence.restProbability4(),
+        sequence.restProbability8()
+    };
+    _restSampler.setWeights(probabilities, 4);
+    if (_restSampler.total() == 0) { return -1;}
+    int stepIndex = _restSampler.sample(rng);
     switch (stepIndex) {
         case 0:
             return 0;
@@ -128,15 +127,16 @@ static int evalStepLength(const StochasticSequence::Step &step, int lengthBias)
 }
 
 // evaluate transposition
-static int evalTransposition(const Scale &scale, int octave, int transpose) {
-    return octave * scale.notesPerOctave() + transpose;
+static int evalTransposition(const QuantizerTable &quantizer, int octave, int transpose) {
+    return octave * quantizer.notesPerOctave() + transpose;
 }
 
 // evaluate note voltage
-static float evalStepNote(const StochasticSequence::Step &step, int probabilityBias, const Scale &scale, int rootNote, int octave, int transpose, StochasticSequence sequence, bool useVariation = true) {
+static float evalStepNote(const StochasticSequence::Step &step, int probabilityBias, const QuantizerTable &quantizer, int rootNote, int octave, int transpose, StochasticSequence sequence, bool useVariation = true) {
     if (step.bypassScale()) {
+        // bypassing the scale quantizes to semitones, which does not need a (cached) quantizer table
         const Scale &bypassScale = Scale::get(0);
-        int note = step.note() + evalTransposition(bypassScale, octave, transpose);
+        int note = step.note() + octave * bypassScale.notesPerOctave() + transpose;
         int probability = clamp(step.noteOctaveProbability() + probabilityBias, -1, StochasticSequence::NoteOctaveProbability::Max);
         if (step.noteOctaveProbability()==0) {
             probability = 0;
@@ -147,13 +147,13 @@ static float evalStepNote(const StochasticSequence::Step &step, int probabilityB
         }
         return bypassScale.noteToVolts(note) + (bypassScale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
     }
-    int note = step.note() + evalTransposition(scale, octave, transpose);
+    int note = step.note() + evalTransposition(quantizer, octave, transpose);
     int probability = clamp(step.noteOctaveProbability() + probabilityBias, -1, StochasticSequence::NoteOctaveProbability::Max);
     if (useVariation && int(rng.nextRange(StochasticSequence::NoteOctaveProbability::Range)) <= probability && probability != 0) {
         int oct = step.noteOctave() + sequence.lowOctaveRange() + ( std::rand() % ( sequence.highOctaveRange() - sequence.lowOctaveRange() + 1 ) );
-        note = StochasticSequence::Note::clamp(note + (scale.notesPerOctave()*oct));
+        note = StochasticSequence::Note::clamp(note + (quantizer.notesPerOctave()*oct));
     }
-    return scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+    return quantizer.noteToVolts(note);
 }
 
 
@@ -175,6 +175,7 @@ void StochasticEngine::reset() {
     _recordHistory.clear();
     rng = Random(time(NULL)); 
     changePattern();
+    accountLockedSteps(_track.trackIndex(), _lockedSteps.size() * sizeof(StochasticLoopStep), sizeof(_lockedSteps));
 }
 
 void StochasticEngine::restart() {
@@ -251,28 +252,27 @@ TrackEngine::TickResult StochasticEngine::tick(uint32_t tick) {
 
     TickResult result = TickResult::NoUpdate;
 
-    while (!_gateQueue.empty() && tick >= _gateQueue.front().tick) {
+    Gate gate;
+    while (_gateQueue.pop(tick, gate)) {
         if (!_monitorOverrideActive) {
             result |= TickResult::GateUpdate;
-            _activity = _gateQueue.front().gate;
+            _activity = gate.gate;
             _gateOutput = (!mute() || fill()) && _activity;
             midiOutputEngine.sendGate(_track.trackIndex(), _gateOutput);
         }
-        _gateQueue.pop();
-
     }
 
-    while (!_cvQueue.empty() && tick >= _cvQueue.front().tick) {
+    Cv cv;
+    while (_cvQueue.pop(tick, cv)) {
         if (!mute() || _stochasticTrack.cvUpdateMode() == StochasticTrack::CvUpdateMode::Always) {
             if (!_monitorOverrideActive) {
                 result |= TickResult::CvUpdate;
-                _cvOutputTarget = _cvQueue.front().cv;
-                _slideActive = _cvQueue.front().slide;
+                _cvOutputTarget = cv.cv;
+                _slideActive = cv.slide;
                 midiOutputEngine.sendCv(_track.trackIndex(), _cvOutputTarget);
                 midiOutputEngine.sendSlide(_track.trackIndex(), _slideActive);
             }
         }
-        _cvQueue.pop();
     }
 
     return result;
@@ -281,8 +281,8 @@ TrackEngine::TickResult StochasticEngine::tick(uint32_t tick) {
 void StochasticEngine::update(float dt) {
     bool running = _engine.state().running();
     const auto &sequence = *_sequence;
-    const auto &scale = sequence.selectedScale(_model.project().scale());
     int rootNote = sequence.selectedRootNote(_model.project().rootNote());
+    const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
     int octave = _stochasticTrack.octave();
     int transpose = _stochasticTrack.transpose();
 
@@ -325,10 +325,10 @@ void StochasticEngine::update(float dt) {
 
     if (stepMonitoring) {
         const auto &step = sequence.step(_monitorStepIndex);
-        setOverride(evalStepNote(step, 0, scale, rootNote, octave, transpose, sequence, false));
+        setOverride(evalStepNote(step, 0, quantizer, rootNote, octave, transpose, sequence, false));
     } else if (liveMonitoring && _recordHistory.isNoteActive()) {
-        int note = noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(scale, octave, transpose);
-        setOverride(scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f));
+        int note = quantizer.noteFromMidiNote(_recordHistory.activeNote()) + evalTransposition(quantizer, octave, transpose);
+        setOverride(quantizer.noteToVolts(note));
     } else {
         clearOverride();
     }
@@ -345,8 +345,8 @@ void StochasticEngine::changePattern() {
     _fillSequence = &_stochasticTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
-void StochasticEngine::monitorMidi(uint32_t tick, const MidiMessage &message) {
-    _recordHistory.write(tick, message);
+void StochasticEngine::monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) {
+    _recordHistory.write(tick, fraction, message);
 }
 
 void StochasticEngine::clearMidiMonitoring() {
@@ -404,6 +404,7 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
         
         if (_index == 0) {
             _lockedSteps.clear();
+            accountLockedSteps(_track.trackIndex(), 0, sizeof(_lockedSteps));
             sequence.setClearLoop(false);
             sequence.setUseLoop(false);
             _sequenceState.reset();
@@ -420,7 +421,8 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
         if (_skips != 0 && _index > 0 && !useFillGates) {
             --_skips;
             if (int(_lockedSteps.size()) < sequence.bufferLoopLength()) {
-                _lockedSteps.insert(_lockedSteps.end(), StochasticLoopStep(-1, false, step, 0, 0, 0));
+                _lockedSteps.push(StochasticLoopStep(-1, false, step, 0, 0, 0));
+                accountLockedSteps(_track.trackIndex(), _lockedSteps.size() * sizeof(StochasticLoopStep), sizeof(_lockedSteps));
             }
             return;
         }
@@ -431,23 +433,21 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
             }
         }
 
-        std::vector<StochasticStep> probability;
-        int sum =0;
+        int probabilities[12];
         for (int i = 0; i < 12; i++) {
             if (sequence.step(i).gate()) {
                 int prob = sequence.step(i).noteVariationProbability() + _stochasticTrack.noteProbabilityBias();
                 if (sequence.step(i).noteVariationProbability()==0) {
                     prob = 0;
                 }
-                probability.insert(probability.end(), StochasticStep(i, clamp(prob, -1, StochasticSequence::NoteVariationProbability::Max)));
+                probabilities[i] = clamp(prob, -1, StochasticSequence::NoteVariationProbability::Max);
             } else {
-                probability.insert(probability.end(), StochasticStep(i, 0));
+                probabilities[i] = 0;
             }
-            sum = sum + probability.at(i).probability();
         }
-        if (sum==0) { return;}
-        std::sort (std::begin(probability), std::end(probability), sortTaskByProbRev);
-        stepIndex = getNextWeightedPitch(probability, probability.size());
+        _noteSampler.setWeights(probabilities, 12);
+        if (_noteSampler.total() == 0) { return;}
+        stepIndex = _noteSampler.sample(rng);
 
         step = evalSequence.step(stepIndex); 
         _currentStep = stepIndex;   
@@ -459,9 +459,9 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
         if (stepGate) {
             stepGate = evalStepCondition(step, _sequenceState.iteration(), useFillCondition, _prevCondition);
         }
-        const auto &scale = sequence.selectedScale(_model.project().scale());
         int rootNote = sequence.selectedRootNote(_model.project().rootNote());
-        noteValue = evalStepNote(step, _stochasticTrack.noteProbabilityBias(), scale, rootNote, octave, transpose, sequence);
+        const auto &quantizer = QuantizerTable::get(sequence.selectedScale(_model.project().scale()), rootNote);
+        noteValue = evalStepNote(step, _stochasticTrack.noteProbabilityBias(), quantizer, rootNote, octave, transpose, sequence);
         stepLength = (divisor * evalStepLength(step, _stochasticTrack.lengthBias())) / StochasticSequence::Length::Range;
 
         int rnd = 0;
@@ -476,7 +476,8 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
         stepRetrigger = evalStepRetrigger(step, _stochasticTrack.retriggerProbabilityBias());
         
         if (int(_lockedSteps.size()) < sequence.bufferLoopLength()) {
-            _lockedSteps.insert(_lockedSteps.end(), StochasticLoopStep(stepIndex, stepGate, step, noteValue, stepLength, stepRetrigger));
+            _lockedSteps.push(StochasticLoopStep(stepIndex, stepGate, step, noteValue, stepLength, stepRetrigger));
+            accountLockedSteps(_track.trackIndex(), _lockedSteps.size() * sizeof(StochasticLoopStep), sizeof(_lockedSteps));
         }
 
         if (stepGate) {
@@ -516,24 +517,29 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
             _index = _sequenceState.nextStep();
         }
 
-        _lockedSteps = slicing(_lockedSteps, 0, sequence.bufferLoopLength()-1);
-       
-        auto subArray = slicing(_lockedSteps, sequence.sequenceFirstStep(), sequence.sequenceLastStep());
+        _lockedSteps.truncate(sequence.bufferLoopLength());
+        accountLockedSteps(_track.trackIndex(), _lockedSteps.size() * sizeof(StochasticLoopStep), sizeof(_lockedSteps));
+
+        auto window = _lockedSteps.window(sequence.sequenceFirstStep(), sequence.sequenceLastStep());
         _index = _index%sequence.sequenceLength();
-        stepIndex = subArray.at(_index).index();
+        if (_index >= window.size()) {
+            return;
+        }
+        const auto &lockedStep = window[_index];
+        stepIndex = lockedStep.index();
         if (stepIndex == -1) {
             return;
         }
         _currentStep = stepIndex;
 
-        stepGate = subArray.at(_index).gate();
-        step = subArray.at(_index).step();
+        stepGate = lockedStep.gate();
+        step = lockedStep.step();
 
         int gateOffset = ((int) divisor * step.gateOffset()) / (StochasticSequence::GateOffset::Max + 1);
         stepTick = (int) tick + gateOffset;
-        noteValue = subArray.at(_index).noteValue();
-        stepLength = subArray.at(_index).stepLength();
-        stepRetrigger = _lockedSteps.at(_index).stepRetrigger();
+        noteValue = lockedStep.noteValue();
+        stepLength = lockedStep.stepLength();
+        stepRetrigger = lockedStep.stepRetrigger();
     
     
 
@@ -561,27 +567,6 @@ void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor, bool forNext
 }
 
 
-int StochasticEngine::getNextWeightedPitch(std::vector<StochasticStep> distr, int notesPerOctave) {
-        int total_weights = 0;
-
-        for(int i = 0; i < notesPerOctave; i++) {
-            total_weights += distr.at(i % notesPerOctave).probability();
-        }
-
-        int rnd = rng.nextRange(total_weights);
-
-        for(int i = 0; i < notesPerOctave; i++) {
-            int weight = distr.at(i % notesPerOctave).probability();
-            if (rnd <= weight && weight > 0) {
-                return distr.at(i % notesPerOctave).index();
-            }
-            rnd -= weight;
-        }
-        return -1;
-    }
-
-
-
 void StochasticEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     triggerStep(tick, divisor, false);
 }
@@ -593,9 +578,9 @@ void StochasticEngine::recordStep(uint32_t tick, uint32_t divisor) {
 
     bool stepWritten = false;
 
-    auto writeStep = [this, divisor, &stepWritten] (int stepIndex, int note, int lengthTicks) {
+    auto writeStep = [this, divisor, &stepWritten] (int stepIndex, int note, float lengthTicks) {
         auto &step = _sequence->step(stepIndex);
-        int length = (lengthTicks * StochasticSequence::Length::Range) / divisor;
+        int length = int((lengthTicks * StochasticSequence::Length::Range) / divisor);
 
         step.setGate(true);
         step.setGateProbability(StochasticSequence::GateProbability::Max);
@@ -619,9 +604,10 @@ void StochasticEngine::recordStep(uint32_t tick, uint32_t divisor) {
         step.clear();
     };
 
+    // note times are in (fractional) ticks relative to the step start
     uint32_t stepStart = tick - divisor;
-    uint32_t stepEnd = tick;
-    uint32_t margin = divisor / 2;
+    float stepEnd = divisor;
+    float margin = divisor / 2;
 
     for (size_t i = 0; i < _recordHistory.size(); ++i) {
         if (_recordHistory[i].type != RecordHistory::Type::NoteOn) {
@@ -629,23 +615,23 @@ void StochasticEngine::recordStep(uint32_t tick, uint32_t divisor) {
         }
 
         int note = _recordHistory[i].note;
-        uint32_t noteStart = _recordHistory[i].tick;
-        uint32_t noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].tick : tick;
+        float noteStart = _recordHistory[i].offset(stepStart);
+        float noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].offset(stepStart) : stepEnd;
 
-        if (noteStart >= stepStart - margin && noteStart < stepStart + margin) {
+        if (noteStart >= -margin && noteStart < margin) {
             // note on during step start phase
             if (noteEnd >= stepEnd) {
                 // note hold during step
-                int length = std::min(noteEnd, stepEnd) - stepStart;
+                float length = std::min(noteEnd, stepEnd);
                 writeStep(_sequenceState.prevStep(), note, length);
             } else {
                 // note released during step
-                int length = noteEnd - noteStart;
+                float length = noteEnd - noteStart;
                 writeStep(_sequenceState.prevStep(), note, length);
             }
-        } else if (noteStart < stepStart && noteEnd > stepStart) {
+        } else if (noteStart < 0.f && noteEnd > 0.f) {
             // note on during previous step
-            int length = std::min(noteEnd, stepEnd) - stepStart;
+            float length = std::min(noteEnd, stepEnd);
             writeStep(_sequenceState.prevStep(), note, length);
         }
     }
@@ -659,9 +645,5 @@ int StochasticEngine::noteFromMidiNote(uint8_t midiNote) const {
     const auto &scale = _sequence->selectedScale(_model.project().scale());
     int rootNote = _sequence->selectedRootNote(_model.project().rootNote());
 
-    if (scale.isChromatic()) {
-        return scale.noteFromVolts((midiNote - 60 - rootNote) * (1.f / 12.f));
-    } else {
-        return scale.noteFromVolts((midiNote - 60) * (1.f / 12.f));
-    }
+    return QuantizerTable::get(scale, rootNote).noteFromMidiNote(midiNote);
 }
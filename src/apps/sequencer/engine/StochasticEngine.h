@@ -2,36 +2,14 @@
 
 #include "TrackEngine.h"
 #include "SequenceState.h"
-#include "SortedQueue.h"
+#include "EventScheduler.h"
+#include "LoopBuffer.h"
 #include "Groove.h"
 #include "RecordHistory.h"
 #include "model/StochasticSequence.h"
 #include "StepRecorder.h"
-#include <valarray>
-#include <vector>
 
-class StochasticStep {
-        public:
-
-            StochasticStep() {}
-            StochasticStep(int index, int probability) {
-                _index = index;
-                _probability = probability;
-            }
-
-            int index() {
-                return _index;
-            }
-
-            int probability() const {
-                return _probability;
-            }
-
-        private:
-            int _index;
-            int _probability;
-
-    };
+#include "core/utils/WeightedSampler.h"
 
 class StochasticLoopStep {
     public:
@@ -45,38 +23,38 @@ class StochasticLoopStep {
             _stepRetrigger = stepRetrigger;
         }
 
-        int index() {
+        int index() const {
             return _index;
         }
 
-        bool gate() {
+        bool gate() const {
             return _gate;
         }
 
-        StochasticSequence::Step step() {
+        const StochasticSequence::Step &step() const {
             return _step;
         }
 
-        float noteValue() {
+        float noteValue() const {
             return _noteValue;
         }
 
-        uint32_t stepLength() {
+        uint32_t stepLength() const {
             return _stepLength;
         }
 
-        int stepRetrigger() {
+        int stepRetrigger() const {
             return _stepRetrigger;
         }
 
 
     private:
-        int _index;
-        bool _gate;
         StochasticSequence::Step _step;
         float _noteValue;
         uint32_t _stepLength;
-        int _stepRetrigger;
+        int8_t _index;
+        bool _gate;
+        uint8_t _stepRetrigger;
 };
 
 class StochasticEngine : public TrackEngine {
@@ -97,11 +75,13 @@ public:
 
     virtual void changePattern() override;
 
-    virtual void monitorMidi(uint32_t tick, const MidiMessage &message) override;
+    virtual void monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) override;
     virtual void clearMidiMonitoring() override;
 
     virtual const TrackLinkData *linkData() const override { return &_linkData; }
 
+    virtual uint32_t eventOverflowCount() const override { return _gateQueue.overflowCount() + _cvQueue.overflowCount(); }
+
     virtual bool activity() const override { return _activity; }
     virtual bool gateOutput(int index) const override { return _gateOutput; }
     virtual float cvOutput(int index) const override { return _cvOutput; }
@@ -121,12 +101,11 @@ public:
     Types::PlayMode playMode() const { return _stochasticTrack.playMode(); }
 
 
-    int getNextWeightedPitch(std::vector<StochasticStep> distr, int notesPerOctave = 12);
     int evalRestProbability(StochasticSequence &sequence);
 
-    std::vector<StochasticLoopStep> lockedSteps() {
-        return _lockedSteps;
-    }
+    typedef LoopBuffer<StochasticLoopStep, CONFIG_STEP_COUNT> LockedSteps;
+
+    const LockedSteps &lockedSteps() const { return _lockedSteps; }
 
 
 
@@ -141,23 +120,6 @@ private:
         return (_stochasticTrack.fillMuted() || !TrackEngine::mute()) ? TrackEngine::fill() : false;
     }
 
-    std::vector<StochasticLoopStep> slicing(std::vector<StochasticLoopStep> &arr, int X, int Y)
-    {
-    
-        // Starting and Ending iterators
-        auto start = arr.begin() + X;
-        auto end = arr.begin() + Y + 1;
-    
-        // To store the sliced vector
-        std::vector<StochasticLoopStep> result(Y - X + 1);
-    
-        // Copy vector using copy function()
-        copy(start, end, result.begin());
-    
-        // Return the final sliced vector
-        return result;
-    }
-
     StochasticTrack &_stochasticTrack;
 
     TrackLinkData _linkData;
@@ -185,21 +147,17 @@ private:
     unsigned int _currentStageRepeat;
 
     int _skips;
+    WeightedSampler<4> _restSampler;
+    WeightedSampler<12> _noteSampler;
 
-    std::vector<StochasticLoopStep> _lockedSteps;
+    LockedSteps _lockedSteps;
 
     struct Gate {
         uint32_t tick;
         bool gate;
     };
 
-    struct GateCompare {
-        bool operator()(const Gate &a, const Gate &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Gate, 16, GateCompare> _gateQueue;
+    EventScheduler<Gate, 32> _gateQueue;
 
     struct Cv {
         uint32_t tick;
@@ -207,11 +165,5 @@ private:
         bool slide;
     };
 
-    struct CvCompare {
-        bool operator()(const Cv &a, const Cv &b) {
-            return a.tick < b.tick;
-        }
-    };
-
-    SortedQueue<Cv, 16, CvCompare> _cvQueue;
+    EventScheduler<Cv, 16> _cvQueue;
 };
@@ -75,11 +75,14 @@ public:
     virtual void changePattern() {}
 
     virtual bool receiveMidi(MidiPort port, const MidiMessage &message) { return false; }
-    virtual void monitorMidi(uint32_t tick, const MidiMessage &message) {}
+    virtual void monitorMidi(uint32_t tick, float fraction, const MidiMessage &message) {}
     virtual void clearMidiMonitoring() {}
 
     virtual const TrackLinkData *linkData() const { return nullptr; }
 
+    // number of gate/cv events dropped due to full event schedulers
+    virtual uint32_t eventOverflowCount() const { return 0; }
+
     // track output
 
     virtual bool activity() const = 0;
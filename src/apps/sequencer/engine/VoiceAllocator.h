@@ -0,0 +1,334 @@
+#pragma once
+
+#include "NoteSet.h"
+
+#include <array>
+
+#include <cstdint>
+#include <cstddef>
+
+// Polyphonic voice allocator assigning held notes to a number of outputs.
+//
+// Held notes are kept in a doubly linked list ordered by note priority, which is maintained incrementally on every
+// note event: last/first note priority insert at the head/tail, lowest/highest note priority find the insertion point
+// through a 128 bit set of held notes. A 128 entry table maps notes to voices, so note off and key pressure lookups
+// do not search the voices.
+// The highest priority notes are assigned to outputs in round-robin fashion. Released voices keep their output
+// (release tail, the output holds the CV of the released note) until the output is needed for another note. When all
+// outputs are in use by held notes, the output of the lowest priority held note is stolen.
+template<size_t VoiceCount>
+class VoiceAllocator {
+    static_assert(VoiceCount > 0 && VoiceCount < 128, "invalid voice count");
+public:
+    enum class Priority : uint8_t {
+        LastNote,
+        FirstNote,
+        LowestNote,
+        HighestNote,
+    };
+
+    struct Voice {
+        uint32_t time;
+        uint8_t note;
+        uint8_t velocity;
+        uint8_t pressure;
+        int8_t output;
+        bool active;
+
+        bool isActive() const { return active; }
+        bool isAllocated() const { return output != -1; }
+    };
+
+    VoiceAllocator() {
+        reset();
+    }
+
+    void reset() {
+        for (size_t i = 0; i < VoiceCount; ++i) {
+            auto &voice = _voices[i];
+            voice.time = 0;
+            voice.note = 60;
+            voice.velocity = 0;
+            voice.pressure = 0;
+            voice.output = -1;
+            voice.active = false;
+            _freeVoices[i] = VoiceCount - 1 - i;
+        }
+        _freeCount = VoiceCount;
+        _noteVoice.fill(-1);
+        _heldNotes.clear();
+        _outputVoice.fill(-1);
+        _head = _tail = -1;
+        _activeCount = 0;
+        _nextOutput = -1;
+    }
+
+    Priority priority() const { return _priority; }
+    void setPriority(Priority priority) {
+        if (priority != _priority) {
+            _priority = priority;
+            relink();
+            rebalance();
+        }
+    }
+
+    int outputCount() const { return _outputCount; }
+    void setOutputCount(int outputCount) {
+        outputCount = outputCount < 1 ? 1 : (outputCount > int(VoiceCount) ? int(VoiceCount) : outputCount);
+        if (outputCount != _outputCount) {
+            // release excess outputs, held notes may be reassigned to the remaining outputs
+            for (int output = outputCount; output < _outputCount; ++output) {
+                unassignOutput(output);
+            }
+            _outputCount = outputCount;
+            _nextOutput = -1;
+            rebalance();
+        }
+    }
+
+    // start a note, a note that is already held is retriggered
+    void noteOn(int note, int velocity, uint32_t time) {
+        note &= 0x7f;
+        int voiceIndex = _noteVoice[note];
+        if (voiceIndex != -1) {
+            // retriggered notes are the most recent notes for last/first note priority
+            if (_priority == Priority::LastNote || _priority == Priority::FirstNote) {
+                unlink(voiceIndex);
+                link(voiceIndex);
+            }
+        } else {
+            voiceIndex = acquireVoice();
+            auto &voice = _voices[voiceIndex];
+            voice.note = note;
+            voice.active = true;
+            _noteVoice[note] = voiceIndex;
+            link(voiceIndex);
+            _heldNotes.set(note);
+        }
+
+        auto &voice = _voices[voiceIndex];
+        voice.time = time;
+        voice.velocity = velocity;
+        voice.pressure = 0;
+
+        rebalance();
+    }
+
+    // release a note, returns false if note is not held
+    bool noteOff(int note) {
+        note &= 0x7f;
+        int voiceIndex = _noteVoice[note];
+        if (voiceIndex == -1) {
+            return false;
+        }
+
+        releaseVoice(voiceIndex);
+        rebalance();
+        return true;
+    }
+
+    // held voice playing the note or nullptr
+    Voice *findVoice(int note) {
+        int voiceIndex = _noteVoice[note & 0x7f];
+        return voiceIndex != -1 ? &_voices[voiceIndex] : nullptr;
+    }
+
+    // voice assigned to an output (held or in release tail) or nullptr
+    const Voice *outputVoice(int output) const {
+        int voiceIndex = output >= 0 && output < _outputCount ? _outputVoice[output] : -1;
+        return voiceIndex != -1 ? &_voices[voiceIndex] : nullptr;
+    }
+
+    // highest priority held voice or nullptr
+    const Voice *firstVoice() const {
+        return _head != -1 ? &_voices[_head] : nullptr;
+    }
+
+    // call f(const Voice &) for all held voices in priority order
+    template<typename F>
+    void forEachActiveVoice(F f) const {
+        for (int voiceIndex = _head; voiceIndex != -1; voiceIndex = _next[voiceIndex]) {
+            f(_voices[voiceIndex]);
+        }
+    }
+
+    int activeCount() const { return _activeCount; }
+
+    const Voice &voice(int index) const { return _voices[index]; }
+
+private:
+    // voice for a new note, takes a free voice, the voice of the oldest release tail or steals the
+    // lowest priority held voice
+    int acquireVoice() {
+        if (_freeCount > 0) {
+            return _freeVoices[--_freeCount];
+        }
+
+        int oldest = -1;
+        for (int output = 0; output < _outputCount; ++output) {
+            int voiceIndex = _outputVoice[output];
+            if (voiceIndex != -1 && !_voices[voiceIndex].active && (oldest == -1 || int32_t(_voices[voiceIndex].time - _voices[oldest].time) < 0)) {
+                oldest = voiceIndex;
+            }
+        }
+        if (oldest == -1) {
+            oldest = _tail;
+            releaseVoice(oldest);
+        }
+
+        if (_voices[oldest].output != -1) {
+            unassignOutput(_voices[oldest].output);
+        }
+        // unassigning pushed the voice to the free list
+        return _freeVoices[--_freeCount];
+    }
+
+    void releaseVoice(int voiceIndex) {
+        auto &voice = _voices[voiceIndex];
+        unlink(voiceIndex);
+        _heldNotes.reset(voice.note);
+        _noteVoice[voice.note] = -1;
+        voice.active = false;
+        if (voice.output == -1) {
+            _freeVoices[_freeCount++] = voiceIndex;
+        }
+    }
+
+    // assign outputs to the highest priority held notes
+    void rebalance() {
+        int rank = 0;
+        for (int voiceIndex = _head; voiceIndex != -1 && rank < _outputCount; voiceIndex = _next[voiceIndex], ++rank) {
+            if (_voices[voiceIndex].output == -1) {
+                assignOutput(voiceIndex);
+            }
+        }
+    }
+
+    void assignOutput(int voiceIndex) {
+        int output = -1;
+
+        // next output in round-robin order that is free or playing a release tail
+        for (int i = 0; i < _outputCount; ++i) {
+            _nextOutput = _nextOutput + 1 >= _outputCount ? 0 : _nextOutput + 1;
+            int owner = _outputVoice[_nextOutput];
+            if (owner == -1 || !_voices[owner].active) {
+                output = _nextOutput;
+                break;
+            }
+        }
+
+        // otherwise steal the output of the lowest priority held note
+        if (output == -1) {
+            for (int owner = _tail; owner != -1; owner = _prev[owner]) {
+                if (owner != voiceIndex && _voices[owner].output != -1) {
+                    output = _voices[owner].output;
+                    break;
+                }
+            }
+        }
+
+        if (output != -1) {
+            unassignOutput(output);
+            _outputVoice[output] = voiceIndex;
+            _voices[voiceIndex].output = output;
+        }
+    }
+
+    void unassignOutput(int output) {
+        int voiceIndex = _outputVoice[output];
+        if (voiceIndex != -1) {
+            auto &voice = _voices[voiceIndex];
+            voice.output = -1;
+            if (!voice.active) {
+                _freeVoices[_freeCount++] = voiceIndex;
+            }
+            _outputVoice[output] = -1;
+        }
+    }
+
+    // priority list
+
+    void link(int voiceIndex) {
+        int before = -1;
+        switch (_priority) {
+        case Priority::LastNote:
+            before = _head;
+            break;
+        case Priority::FirstNote:
+            break;
+        case Priority::LowestNote: {
+            int note = _heldNotes.nextAbove(_voices[voiceIndex].note);
+            before = note != -1 ? _noteVoice[note] : -1;
+            break;
+        }
+        case Priority::HighestNote: {
+            int note = _heldNotes.nextBelow(_voices[voiceIndex].note);
+            before = note != -1 ? _noteVoice[note] : -1;
+            break;
+        }
+        }
+        insertBefore(voiceIndex, before);
+    }
+
+    // insert voice before another voice or at the tail if before is -1
+    void insertBefore(int voiceIndex, int before) {
+        int prev = before != -1 ? _prev[before] : _tail;
+        _prev[voiceIndex] = prev;
+        _next[voiceIndex] = before;
+        (prev != -1 ? _next[prev] : _head) = voiceIndex;
+        (before != -1 ? _prev[before] : _tail) = voiceIndex;
+        ++_activeCount;
+    }
+
+    void unlink(int voiceIndex) {
+        int prev = _prev[voiceIndex];
+        int next = _next[voiceIndex];
+        (prev != -1 ? _next[prev] : _head) = next;
+        (next != -1 ? _prev[next] : _tail) = prev;
+        --_activeCount;
+    }
+
+    // rebuild priority list after changing the priority, keeps the order of arrival for last/first note priority
+    void relink() {
+        std::array<int8_t, VoiceCount> order;
+        int count = 0;
+        for (int voiceIndex = _head; voiceIndex != -1; voiceIndex = _next[voiceIndex]) {
+            order[count++] = voiceIndex;
+        }
+        _head = _tail = -1;
+        _activeCount = 0;
+        _heldNotes.clear();
+        // insert oldest notes first
+        for (int i = 0; i < count; ++i) {
+            int voiceIndex = order[i];
+            for (int j = i + 1; j < count; ++j) {
+                if (int32_t(_voices[order[j]].time - _voices[voiceIndex].time) < 0) {
+                    voiceIndex = order[j];
+                    order[j] = order[i];
+                    order[i] = voiceIndex;
+                }
+            }
+            link(voiceIndex);
+            _heldNotes.set(_voices[voiceIndex].note);
+        }
+    }
+
+    std::array<Voice, VoiceCount> _voices;
+    std::array<int8_t, VoiceCount> _prev;
+    std::array<int8_t, VoiceCount> _next;
+    int8_t _head;
+    int8_t _tail;
+    int _activeCount;
+
+    std::array<int8_t, VoiceCount> _freeVoices;
+    int _freeCount;
+
+    std::array<int8_t, 128> _noteVoice;
+    KeySet _heldNotes;
+
+    std::array<int8_t, VoiceCount> _outputVoice;
+    int _outputCount = 1;
+    int _nextOutput;
+
+    Priority _priority = Priority::LastNote;
+};
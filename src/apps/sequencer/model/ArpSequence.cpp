@@ -192,6 +192,8 @@ void ArpSequence::Step::clear() {
 
 }
 
+static_assert(sizeof(ArpSequence::Step) == 2 * sizeof(uint32_t), "step must match its serialized layout");
+
 void ArpSequence::Step::write(VersionedSerializedWriter &writer) const {
     writer.write(_data0.raw);
     writer.write(_data1.raw);
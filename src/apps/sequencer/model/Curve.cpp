@@ -3,94 +3,99 @@
 #include <algorithm>
 
 #include <cmath>
-#include <map>
+#include <cstdint>
 
 static const float Pi = 3.1415926536f;
 static const float TwoPi = 2.f * Pi;
 
-    static const std::map<int, Curve::Type> INV_SHAPE_MAP = {
-        {0, Curve::High},
-        {1, Curve::Low},
-        {2, Curve::RampDown},
-        {3, Curve::RampUp},
-        {4, Curve::rampDownHalf},
-        {5, Curve::rampUpHalf},
-        {6, Curve::doubleRampDownHalf},
-        {7, Curve::doubleRampUpHalf},
-        {8, Curve::ExpDown},
-        {9, Curve::ExpUp},
-        {10, Curve::expDownHalf},
-        {11, Curve:: expUpHalf},
-        {12, Curve::doubleExpDownHalf},
-        {13, Curve::doubleExpUpHalf},
-        {14, Curve::LogDown},
-        {15, Curve::LogUp},
-        {16, Curve::logDownHalf},
-        {17, Curve::logUpHalf},
-        {18, Curve::doubleLogDownHalf},
-        {19, Curve::doubleLogUpHalf},
-        {20, Curve::SmoothDown},
-        {21, Curve::SmoothUp},
-        {22, Curve::smoothDownHalf},
-        {23, Curve::smoothUpHalf},
-        {24, Curve::doubleSmoothDownHalf},
-        {25, Curve::doubleSmoothUpHalf},
-        {26, Curve::RevTriangle},
-        {27, Curve::Triangle},
-        {28, Curve::RevBell},
-        {29, Curve::Bell},
-        {30, Curve::StepDown},
-        {31, Curve::StepUp},
-        {33, Curve::ExpDown2x},
-        {32, Curve::ExpUp2x},
-        {35, Curve::ExpDown3x},
-        {34, Curve::ExpUp3x},
-        {37, Curve::ExpDown4x},
-        {36, Curve::ExpUp4x},
-        {38, Curve::Low},
-    };
-
-    static const std::map<int, Curve::Type> REV_SHAPE_MAP = {
-        {0, Curve::Low},
-        {1, Curve::High},
-        {2, Curve::RampDown},
-        {3, Curve::RampUp},
-        {4, Curve::rampDownHalf},
-        {5, Curve::rampUpHalf},
-        {6, Curve::doubleRampDownHalf},
-        {7, Curve::doubleRampUpHalf},
-        {8, Curve::ExpDown},
-        {9, Curve::ExpUp},
-        {10, Curve::expDownHalf},
-        {11, Curve:: expUpHalf},
-        {12, Curve::doubleExpDownHalf},
-        {13, Curve::doubleExpUpHalf},
-        {14, Curve::LogDown},
-        {15, Curve::LogUp},
-        {16, Curve::logDownHalf},
-        {17, Curve::logUpHalf},
-        {18, Curve::doubleLogDownHalf},
-        {19, Curve::doubleLogUpHalf},
-        {20, Curve::SmoothDown},
-        {21, Curve::SmoothUp},
-        {22, Curve::smoothDownHalf},
-        {23, Curve::smoothUpHalf},
-        {24, Curve::doubleSmoothDownHalf},
-        {25, Curve::doubleSmoothUpHalf},
-        {26, Curve::Triangle},
-        {27, Curve::RevTriangle},
-        {28, Curve::Bell},
-        {29, Curve::RevBell},
-        {30, Curve::StepDown},
-        {31, Curve::StepUp},
-        {32, Curve::ExpDown2x},
-        {33, Curve::ExpUp2x},
-        {34, Curve::ExpDown3x},
-        {35, Curve::ExpUp3x},
-        {36, Curve::ExpDown4x},
-        {37, Curve::ExpUp4x},
-        {38, Curve::Low},
-    };
+// shape to use when inverting a step shape
+static constexpr Curve::Type invShapes[] = {
+    Curve::High, // 0
+    Curve::Low, // 1
+    Curve::RampDown, // 2
+    Curve::RampUp, // 3
+    Curve::rampDownHalf, // 4
+    Curve::rampUpHalf, // 5
+    Curve::doubleRampDownHalf, // 6
+    Curve::doubleRampUpHalf, // 7
+    Curve::ExpDown, // 8
+    Curve::ExpUp, // 9
+    Curve::expDownHalf, // 10
+    Curve::expUpHalf, // 11
+    Curve::doubleExpDownHalf, // 12
+    Curve::doubleExpUpHalf, // 13
+    Curve::LogDown, // 14
+    Curve::LogUp, // 15
+    Curve::logDownHalf, // 16
+    Curve::logUpHalf, // 17
+    Curve::doubleLogDownHalf, // 18
+    Curve::doubleLogUpHalf, // 19
+    Curve::SmoothDown, // 20
+    Curve::SmoothUp, // 21
+    Curve::smoothDownHalf, // 22
+    Curve::smoothUpHalf, // 23
+    Curve::doubleSmoothDownHalf, // 24
+    Curve::doubleSmoothUpHalf, // 25
+    Curve::RevTriangle, // 26
+    Curve::Triangle, // 27
+    Curve::RevBell, // 28
+    Curve::Bell, // 29
+    Curve::StepDown, // 30
+    Curve::StepUp, // 31
+    Curve::ExpUp2x, // 32
+    Curve::ExpDown2x, // 33
+    Curve::ExpUp3x, // 34
+    Curve::ExpDown3x, // 35
+    Curve::ExpUp4x, // 36
+    Curve::ExpDown4x, // 37
+    Curve::Low, // 38
+};
+
+// shape to use when playing a step shape in reverse direction
+static constexpr Curve::Type revShapes[] = {
+    Curve::Low, // 0
+    Curve::High, // 1
+    Curve::RampDown, // 2
+    Curve::RampUp, // 3
+    Curve::rampDownHalf, // 4
+    Curve::rampUpHalf, // 5
+    Curve::doubleRampDownHalf, // 6
+    Curve::doubleRampUpHalf, // 7
+    Curve::ExpDown, // 8
+    Curve::ExpUp, // 9
+    Curve::expDownHalf, // 10
+    Curve::expUpHalf, // 11
+    Curve::doubleExpDownHalf, // 12
+    Curve::doubleExpUpHalf, // 13
+    Curve::LogDown, // 14
+    Curve::LogUp, // 15
+    Curve::logDownHalf, // 16
+    Curve::logUpHalf, // 17
+    Curve::doubleLogDownHalf, // 18
+    Curve::doubleLogUpHalf, // 19
+    Curve::SmoothDown, // 20
+    Curve::SmoothUp, // 21
+    Curve::smoothDownHalf, // 22
+    Curve::smoothUpHalf, // 23
+    Curve::doubleSmoothDownHalf, // 24
+    Curve::doubleSmoothUpHalf, // 25
+    Curve::Triangle, // 26
+    Curve::RevTriangle, // 27
+    Curve::Bell, // 28
+    Curve::RevBell, // 29
+    Curve::StepDown, // 30
+    Curve::StepUp, // 31
+    Curve::ExpDown2x, // 32
+    Curve::ExpUp2x, // 33
+    Curve::ExpDown3x, // 34
+    Curve::ExpUp3x, // 35
+    Curve::ExpDown4x, // 36
+    Curve::ExpUp4x, // 37
+    Curve::Low, // 38
+};
+
+static_assert(sizeof(invShapes) / sizeof(invShapes[0]) == Curve::Last, "invalid inverse shape table");
+static_assert(sizeof(revShapes) / sizeof(revShapes[0]) == Curve::Last, "invalid reverse shape table");
 
 static float low(float x) {
     return 0.f;
@@ -290,6 +295,255 @@ static Curve::Function functions[] = {
     &trigger
 };
 
+//----------------------------------------------------------------------------
+// Fixed point evaluation
+//----------------------------------------------------------------------------
+
+// Every curve type is described as a base shape that is repeated a number of times within a step, optionally
+// mirrored (played backwards) and inverted. Discontinuities at repetition boundaries are therefore exact. The
+// smooth base shapes are stored in wavetables generated at compile time and evaluated with linear interpolation.
+
+namespace {
+
+template<int... Is>
+struct IndexSequence {};
+
+template<int N, int... Is>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Is...> {};
+
+template<int... Is>
+struct MakeIndexSequence<0, Is...> { typedef IndexSequence<Is...> type; };
+
+static constexpr int WavetableBits = 8;
+static constexpr int WavetableSegments = 1 << WavetableBits;
+static constexpr int PhaseBits = 16;
+static constexpr uint32_t PhaseOne = 1 << PhaseBits;
+static constexpr uint32_t ValueMax = Curve::FixedOne;
+
+struct Wavetable {
+    uint16_t values[WavetableSegments + 1];
+};
+
+constexpr uint16_t toFixed(double value) {
+    return uint16_t(value * ValueMax + 0.5);
+}
+
+// taylor series of cos(x) for x in [0, pi], x2 = x * x
+constexpr double cosTaylor(double x2, double term, int n) {
+    return n > 24 ? 0.0 : term + cosTaylor(x2, -term * x2 / ((2 * n + 1) * (2 * n + 2)), n + 1);
+}
+
+constexpr double PiDouble = 3.14159265358979323846;
+
+// cos(2 * pi * x) for x in [0, 1]
+constexpr double cosTurn(double x) {
+    return cosTaylor((x < 0.5 ? x : 1.0 - x) * (x < 0.5 ? x : 1.0 - x) * 4.0 * PiDouble * PiDouble, 1.0, 0);
+}
+
+struct ExpShape {
+    static constexpr double eval(double x) { return x * x; }
+};
+
+struct SmoothShape {
+    static constexpr double eval(double x) { return x * x * (3.0 - 2.0 * x); }
+};
+
+struct BellShape {
+    static constexpr double eval(double x) { return 0.5 - 0.5 * cosTurn(x); }
+};
+
+template<typename Shape, int... Is>
+constexpr Wavetable makeWavetable(IndexSequence<Is...>) {
+    return {{ toFixed(Shape::eval(double(Is) / WavetableSegments))... }};
+}
+
+template<typename Shape>
+constexpr Wavetable makeWavetable() {
+    return makeWavetable<Shape>(typename MakeIndexSequence<WavetableSegments + 1>::type());
+}
+
+// square root of [0.25..1] in 192 segments, scaled by 2^16
+static constexpr int SqrtWavetableOffset = 64;
+static constexpr int SqrtWavetableSegments = 192;
+
+struct SqrtWavetable {
+    uint32_t values[SqrtWavetableSegments + 1];
+};
+
+constexpr double sqrtNewton(double x, double guess, int n) {
+    return n == 0 ? guess : sqrtNewton(x, 0.5 * (guess + x / guess), n - 1);
+}
+
+template<int... Is>
+constexpr SqrtWavetable makeSqrtWavetable(IndexSequence<Is...>) {
+    return {{ uint32_t(sqrtNewton(double(SqrtWavetableOffset + Is) / 256.0, 1.0, 8) * PhaseOne + 0.5)... }};
+}
+
+static constexpr SqrtWavetable sqrtWavetable = makeSqrtWavetable(MakeIndexSequence<SqrtWavetableSegments + 1>::type());
+
+static constexpr Wavetable expWavetable = makeWavetable<ExpShape>();
+static constexpr Wavetable smoothWavetable = makeWavetable<SmoothShape>();
+static constexpr Wavetable bellWavetable = makeWavetable<BellShape>();
+
+enum class Base : uint8_t {
+    Zero,
+    One,
+    Step,
+    Ramp,
+    Triangle,
+    Exp,
+    Log,
+    Smooth,
+    Bell,
+    Trigger,
+};
+
+struct Shape {
+    Base base;
+    uint8_t repeats;    // number of repetitions of the base shape
+    uint8_t active;     // number of active repetitions, output is 0 after
+    uint8_t mirror;     // evaluate base shape backwards
+    uint8_t invert;     // invert output
+};
+
+// indexed by curve type, same order as the float functions
+static constexpr Shape shapes[] = {
+    { Base::Zero,       1, 1, 0, 0 }, // low
+    { Base::One,        1, 1, 0, 0 }, // high
+    { Base::Step,       1, 1, 0, 0 }, // stepUp
+    { Base::Step,       1, 1, 0, 1 }, // stepDown
+    { Base::Ramp,       1, 1, 0, 0 }, // rampUp
+    { Base::Ramp,       1, 1, 1, 0 }, // rampDown
+    { Base::Ramp,       2, 1, 0, 0 }, // rampUpHalf
+    { Base::Ramp,       2, 1, 1, 0 }, // rampDownHalf
+    { Base::Ramp,       2, 2, 0, 0 }, // doubleRampUpHalf
+    { Base::Ramp,       2, 2, 1, 0 }, // doubleRampDownHalf
+    { Base::Exp,        1, 1, 0, 0 }, // expUp
+    { Base::Exp,        1, 1, 1, 0 }, // expDown
+    { Base::Exp,        2, 1, 0, 0 }, // expUpHalf
+    { Base::Exp,        2, 1, 1, 0 }, // expDownHalf
+    { Base::Exp,        2, 2, 0, 0 }, // doubleExpUpHalf
+    { Base::Exp,        2, 2, 1, 0 }, // doubleExpDownHalf
+    { Base::Log,        1, 1, 0, 0 }, // logUp
+    { Base::Log,        1, 1, 1, 0 }, // logDown
+    { Base::Log,        2, 1, 0, 0 }, // logUpHalf
+    { Base::Log,        2, 1, 1, 0 }, // logDownHalf
+    { Base::Log,        2, 2, 0, 0 }, // doubleLogUpHalf
+    { Base::Log,        2, 2, 1, 0 }, // doubleLogDownHalf
+    { Base::Smooth,     1, 1, 0, 0 }, // smoothUp
+    { Base::Smooth,     1, 1, 1, 0 }, // smoothDown
+    { Base::Smooth,     2, 1, 0, 0 }, // smoothUpHalf
+    { Base::Smooth,     2, 1, 1, 0 }, // smoothDownHalf
+    { Base::Smooth,     2, 2, 0, 0 }, // doubleSmoothUpHalf
+    { Base::Smooth,     2, 2, 1, 0 }, // doubleSmoothDownHalf
+    { Base::Triangle,   1, 1, 0, 0 }, // triangle
+    { Base::Triangle,   1, 1, 0, 1 }, // revTriangle
+    { Base::Bell,       1, 1, 0, 0 }, // bell
+    { Base::Bell,       1, 1, 0, 1 }, // revBell
+    { Base::Exp,        2, 2, 1, 0 }, // expDown2x
+    { Base::Exp,        2, 2, 0, 0 }, // expUp2x
+    { Base::Exp,        3, 3, 1, 0 }, // expDown3x
+    { Base::Exp,        3, 3, 0, 0 }, // expUp3x
+    { Base::Exp,        4, 4, 1, 0 }, // expDown4x
+    { Base::Exp,        4, 4, 0, 0 }, // expUp4x
+    { Base::Trigger,    1, 1, 0, 0 }, // trigger
+};
+
+static_assert(sizeof(shapes) / sizeof(shapes[0]) == Curve::Last, "invalid shape table");
+
+static inline uint32_t lookup(const Wavetable &wavetable, uint32_t phase) {
+    uint32_t index = phase >> (PhaseBits - WavetableBits);
+    uint32_t fraction = phase & ((1 << (PhaseBits - WavetableBits)) - 1);
+    if (index >= WavetableSegments) {
+        return wavetable.values[WavetableSegments];
+    }
+    int32_t a = wavetable.values[index];
+    int32_t b = wavetable.values[index + 1];
+    return a + (((b - a) * int32_t(fraction)) >> (PhaseBits - WavetableBits));
+}
+
+// square root of phase scaled to the value range
+// the phase is normalized to [0.25..1) so the interpolated wavetable does not need to follow the infinite slope at 0
+static inline uint32_t squareRoot(uint32_t phase) {
+    if (phase == 0) {
+        return 0;
+    } else if (phase >= PhaseOne) {
+        return ValueMax;
+    }
+    uint32_t x = phase << PhaseBits;
+    int shift = __builtin_clz(x) & ~1;
+    x <<= shift;
+    uint32_t index = (x >> 24) - SqrtWavetableOffset;
+    int32_t fraction = (x >> 16) & 0xff;
+    int32_t a = sqrtWavetable.values[index];
+    int32_t b = sqrtWavetable.values[index + 1];
+    return uint32_t(((a << 8) + (b - a) * fraction) >> 8) >> (shift / 2);
+}
+
+// evaluate base shape at phase [0..PhaseOne]
+static inline uint32_t evalBase(Base base, uint32_t phase) {
+    switch (base) {
+    case Base::Zero:
+        return 0;
+    case Base::One:
+        return ValueMax;
+    case Base::Step:
+        return phase < PhaseOne / 2 ? 0 : ValueMax;
+    case Base::Ramp:
+        return std::min(phase, ValueMax);
+    case Base::Triangle:
+        return std::min((phase < PhaseOne / 2 ? phase : PhaseOne - phase) * 2, ValueMax);
+    case Base::Exp:
+        return lookup(expWavetable, phase);
+    case Base::Log:
+        return squareRoot(phase);
+    case Base::Smooth:
+        return lookup(smoothWavetable, phase);
+    case Base::Bell:
+        return lookup(bellWavetable, phase);
+    case Base::Trigger:
+        // high for 10% of the step, exponential decay up to 30% of the step
+        if (phase * 10 < PhaseOne) {
+            return ValueMax;
+        } else if (phase * 10 < 3 * PhaseOne) {
+            return lookup(expWavetable, PhaseOne - phase * 2);
+        }
+        return 0;
+    }
+    return 0;
+}
+
+} // namespace
+
+uint32_t Curve::evalFixed(Type type, uint32_t x) {
+    const auto &shape = shapes[type];
+    uint32_t phase = std::min(x, PhaseOne);
+    if (shape.repeats > 1) {
+        phase *= shape.repeats;
+        if ((phase >> PhaseBits) >= shape.active) {
+            return 0;
+        }
+        phase &= PhaseOne - 1;
+    }
+    if (shape.mirror) {
+        phase = PhaseOne - phase;
+    }
+    uint32_t value = evalBase(shape.base, phase);
+    return shape.invert ? ValueMax - value : value;
+}
+
+float Curve::evalTable(Type type, float x) {
+    return evalFixed(type, uint32_t(std::max(0.f, x) * PhaseOne)) * (1.f / ValueMax);
+}
+
+void Curve::render(Type type, float *values, int count, float min, float max) {
+    float scale = (max - min) / ValueMax;
+    uint32_t last = count > 1 ? uint32_t(count - 1) : 1;
+    for (int i = 0; i < count; ++i) {
+        values[i] = min + evalFixed(type, (uint32_t(i) * PhaseOne) / last) * scale;
+    }
+}
+
 Curve::Function Curve::function(Type type) {
     return functions[type];
 }
@@ -299,9 +553,9 @@ float Curve::eval(Type type, float x) {
 }
 
 Curve::Type Curve::invAt(int i) {
-        return INV_SHAPE_MAP.at(i);
+    return invShapes[std::max(0, std::min(int(Last) - 1, i))];
 }
 
 Curve::Type Curve::revAt(int i) {
-        return REV_SHAPE_MAP.at(i);
+    return revShapes[std::max(0, std::min(int(Last) - 1, i))];
 }
\ No newline at end of file
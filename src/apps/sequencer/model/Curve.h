@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class Curve {
     
 public:
@@ -50,10 +52,21 @@ public:
 
  
 
+    // fixed point value representing 1.0
+    static constexpr uint32_t FixedOne = 0xffff;
+
     static Function function(Type type);
 
+    // reference evaluation using the float functions
     static float eval(Type type, float x);
 
+    // fast evaluation using fixed point wavetables, x in [0..1] with 16 fractional bits, returns [0..FixedOne]
+    static uint32_t evalFixed(Type type, uint32_t x);
+    static float evalTable(Type type, float x);
+
+    // render count values of a shape mapped to [min..max], evenly spaced over x in [0..1] (including both ends)
+    static void render(Type type, float *values, int count, float min = 0.f, float max = 1.f);
+
     static Type invAt(int i);
     static Type revAt(int i);
 };
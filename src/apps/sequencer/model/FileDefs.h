@@ -19,6 +19,9 @@ enum class FileType : uint8_t {
 struct FileHeader {
     static constexpr size_t NameLength = 8;
 
+    // version of files stored as a table of chunks (see FileChunk)
+    static constexpr uint8_t ChunkedVersion = 1;
+
     FileType type;
     uint8_t version;
     char name[NameLength];
@@ -40,3 +43,12 @@ struct FileHeader {
 
 } __attribute__((packed));
 
+// Entry in the chunk table of a chunked file.
+// Chunks start at a sector boundary and can be rewritten in place as long as they fit their capacity.
+struct FileChunk {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t hash;
+} __attribute__((packed));
+
@@ -6,6 +6,7 @@
 #include "core/fs/FileSystem.h"
 #include "core/fs/FileWriter.h"
 #include "core/fs/FileReader.h"
+#include "core/hash/FnvHash.h"
 
 #include "os/os.h"
 
@@ -22,6 +23,7 @@ uint32_t FileManager::_cachedSlotInfoTicket = 0;
 FileManager::TaskExecuteCallback FileManager::_taskExecuteCallback;
 FileManager::TaskResultCallback FileManager::_taskResultCallback;
 volatile uint32_t FileManager::_taskPending;
+volatile int32_t FileManager::_taskProgress = -1;
 
 struct FileTypeInfo {
     const char *dir;
@@ -37,6 +39,121 @@ FileTypeInfo fileTypeInfos[] = {
     {"SEQS", "ASQ"}
 };
 
+// Writes serialized data of a model that is in use by the engine to a sink (i.e. a file).
+// The model is only locked while being serialized into the staging buffer. Full staging buffers are passed to the
+// sink with the model unlocked, so the engine keeps running during slow file system writes.
+class StagedWriter {
+public:
+    typedef std::function<void(const uint8_t *, size_t)> Sink;
+
+    static constexpr size_t StageSize = 2048;
+
+    StagedWriter(Sink sink, FileManager::LockCallback lockCallback, size_t progressOffset, size_t progressTotal) :
+        _sink(sink),
+        _lockCallback(lockCallback),
+        _progressOffset(progressOffset),
+        _progressTotal(progressTotal)
+    {
+        lock(true);
+    }
+
+    ~StagedWriter() {
+        finish();
+    }
+
+    void write(const void *data, size_t len) {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        while (len > 0) {
+            size_t chunk = std::min(len, StageSize - _pos);
+            std::memcpy(&stage()[_pos], src, chunk);
+            _pos += chunk;
+            src += chunk;
+            len -= chunk;
+            if (_pos == StageSize) {
+                flush();
+                lock(true);
+            }
+        }
+    }
+
+    void finish() {
+        if (_locked) {
+            flush();
+        }
+    }
+
+private:
+    void lock(bool locked) {
+        if (_lockCallback && locked != _locked) {
+            _lockCallback(locked);
+        }
+        _locked = locked;
+    }
+
+    void flush() {
+        lock(false);
+        _sink(stage(), _pos);
+        _written += _pos;
+        _pos = 0;
+        FileManager::setTaskProgress(_progressOffset + _written, _progressTotal);
+    }
+
+    Sink _sink;
+    FileManager::LockCallback _lockCallback;
+    size_t _progressOffset;
+    size_t _progressTotal;
+    size_t _written = 0;
+    size_t _pos = 0;
+    bool _locked = false;
+
+    // word aligned, so full stages can be passed on to the block device without copying
+    static uint8_t *stage() { return reinterpret_cast<uint8_t *>(_stage); }
+
+    static uint32_t _stage[StageSize / 4];
+};
+
+uint32_t StagedWriter::_stage[StagedWriter::StageSize / 4];
+
+// Chunked project files start with a sector containing the file header, the data version and the chunk table,
+// followed by the chunks, each starting at a sector boundary.
+static constexpr size_t SectorSize = 512;
+
+struct ProjectTable {
+    FileHeader header;
+    uint32_t version;
+    FileChunk chunks[Project::ChunkCount];
+} __attribute__((packed));
+
+static_assert(sizeof(ProjectTable) <= SectorSize, "project chunk table does not fit into a sector");
+
+static size_t roundUpToSector(size_t size) {
+    return ((size + SectorSize - 1) / SectorSize) * SectorSize;
+}
+
+// size and hash of serialized data
+struct ChunkDigest {
+    size_t size = 0;
+    FnvHash hash;
+
+    void operator()(const void *data, size_t len) {
+        size += len;
+        hash(data, len);
+    }
+};
+
+static void writeProjectChunk(const Project &project, int chunk, ChunkDigest &digest, StagedWriter *stagedWriter) {
+    VersionedSerializedWriter writer(
+        [&digest, stagedWriter] (const void *data, size_t len) {
+            digest(data, len);
+            if (stagedWriter) {
+                stagedWriter->write(data, len);
+            }
+        },
+        ProjectVersion::Latest
+    );
+    project.writeChunk(chunk, writer);
+}
+
 static void slotPath(StringBuilder &str, FileType type, int slot) {
     const auto &info = fileTypeInfos[int(type)];
     str("%s/%03d.%s", info.dir, slot + 1, info.ext);
@@ -48,6 +165,7 @@ void FileManager::init() {
     _taskExecuteCallback = nullptr;
     _taskResultCallback = nullptr;
     _taskPending = 0;
+    _taskProgress = -1;
 }
 
 bool FileManager::volumeAvailable() {
@@ -63,9 +181,9 @@ fs::Error FileManager::format() {
     return fs::volume().format();
 }
 
-fs::Error FileManager::writeProject(Project &project, int slot) {
+fs::Error FileManager::writeProject(Project &project, int slot, LockCallback lockCallback) {
     return writeFile(FileType::Project, slot, [&] (const char *path) {
-        auto result = writeProject(project, path);
+        auto result = writeProject(project, path, lockCallback);
         if (result == fs::OK) {
             project.setSlot(slot);
             writeLastProject(slot);
@@ -159,23 +277,13 @@ fs::Error FileManager::readArpSequence(ArpSequence &noteSequence, int slot) {
     });
 }
 
-fs::Error FileManager::writeProject(const Project &project, const char *path) {
-    fs::FileWriter fileWriter(path);
-    if (fileWriter.error() != fs::OK) {
-        return fileWriter.error();
+fs::Error FileManager::writeProject(const Project &project, const char *path, LockCallback lockCallback) {
+    // rewrite the chunks that have changed in place if possible, otherwise write the whole file
+    fs::Error result;
+    if (!updateProject(project, path, lockCallback, result)) {
+        result = writeWholeProject(project, path, lockCallback);
     }
-
-    FileHeader header(FileType::Project, 0, project.name());
-    fileWriter.write(&header, sizeof(header));
-
-    VersionedSerializedWriter writer(
-        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        ProjectVersion::Latest
-    );
-
-    project.write(writer);
-
-    return fileWriter.finish();
+    return result;
 }
 
 fs::Error FileManager::readProject(Project &project, const char *path) {
@@ -187,6 +295,10 @@ fs::Error FileManager::readProject(Project &project, const char *path) {
     FileHeader header;
     fileReader.read(&header, sizeof(header));
 
+    if (header.version == FileHeader::ChunkedVersion) {
+        return readChunkedProject(project, fileReader);
+    }
+
     VersionedSerializedReader reader(
         [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
         ProjectVersion::Latest
@@ -492,6 +604,7 @@ bool FileManager::slotUsed(FileType type, int slot) {
 void FileManager::task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback) {
     _taskExecuteCallback = executeCallback;
     _taskResultCallback = resultCallback;
+    _taskProgress = -1;
     _taskPending = 1;
 }
 
@@ -519,10 +632,234 @@ void FileManager::processTask() {
         fs::Error result = _taskExecuteCallback();
         _taskPending = 0;
         _taskResultCallback(result);
+        _taskProgress = -1;
     }
 }
 
 
+void FileManager::setTaskProgress(size_t done, size_t total) {
+    _taskProgress = total > 0 ? int32_t(std::min(done, total) * ProgressRange / total) : -1;
+}
+
+fs::Error FileManager::writeWholeProject(const Project &project, const char *path, LockCallback lockCallback) {
+    fs::FileWriter fileWriter(path);
+    if (fileWriter.error() != fs::OK) {
+        return fileWriter.error();
+    }
+
+    // the size is used for reporting progress and preallocating the file, no need to lock
+    size_t totalSize = SectorSize;
+    for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+        ChunkDigest digest;
+        writeProjectChunk(project, chunk, digest, nullptr);
+        totalSize += roundUpToSector(digest.size);
+    }
+
+    // contiguous clusters avoid updating the allocation table while writing, the file is truncated when finished
+    fileWriter.preallocate(totalSize);
+
+    // chunk table is written again when all chunks are written
+    ProjectTable table;
+    std::memset(&table, 0, sizeof(table));
+    table.header = FileHeader(FileType::Project, FileHeader::ChunkedVersion, project.name());
+    table.version = ProjectVersion::Latest;
+
+    static const uint8_t padding[SectorSize] = {};
+    fileWriter.write(&table, sizeof(table));
+    fileWriter.write(padding, SectorSize - sizeof(table));
+
+    size_t offset = SectorSize;
+    for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+        ChunkDigest digest;
+        {
+            StagedWriter stagedWriter(
+                [&fileWriter] (const uint8_t *data, size_t len) { fileWriter.write(data, len); },
+                lockCallback, offset, totalSize
+            );
+            writeProjectChunk(project, chunk, digest, &stagedWriter);
+        }
+
+        auto &entry = table.chunks[chunk];
+        entry.offset = offset;
+        entry.size = digest.size;
+        entry.capacity = roundUpToSector(digest.size);
+        entry.hash = digest.hash.result();
+
+        fileWriter.write(padding, entry.capacity - entry.size);
+        offset += entry.capacity;
+    }
+
+    auto result = fileWriter.finish();
+    if (result != fs::OK) {
+        return result;
+    }
+
+    fs::File file(path, fs::File::ReadWrite);
+    if (file.error() == fs::OK) {
+        file.writeAll(&table, sizeof(table));
+    }
+    if (file.error() != fs::OK) {
+        return file.error();
+    }
+    return file.close();
+}
+
+bool FileManager::updateProject(const Project &project, const char *path, LockCallback lockCallback, fs::Error &result) {
+    if (!fs::exists(path)) {
+        return false;
+    }
+
+    fs::File file(path, fs::File::ReadWrite);
+    if (file.error() != fs::OK) {
+        return false;
+    }
+
+    // check if file is a chunked project file of the same version that can hold the project
+    ProjectTable table;
+    size_t lenRead;
+    if (file.read(&table, sizeof(table), &lenRead) != fs::OK || lenRead != sizeof(table) ||
+        table.header.type != FileType::Project || table.header.version != FileHeader::ChunkedVersion ||
+        table.version != ProjectVersion::Latest) {
+        return false;
+    }
+    for (const auto &entry : table.chunks) {
+        if (entry.offset < SectorSize || entry.offset % SectorSize != 0 || entry.size > entry.capacity ||
+            entry.offset + entry.capacity > file.size()) {
+            return false;
+        }
+    }
+
+    // find chunks that have changed by comparing the hashes of the serialized chunks
+    std::array<bool, Project::ChunkCount> changed;
+    size_t changedSize = 0;
+    for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+        const auto &entry = table.chunks[chunk];
+        ChunkDigest digest;
+        {
+            // serialized data is only hashed, stage anyway so the model is locked for one stage at a time
+            StagedWriter stagedWriter([] (const uint8_t *data, size_t len) {}, lockCallback, 0, 0);
+            writeProjectChunk(project, chunk, digest, &stagedWriter);
+        }
+        if (digest.size > entry.capacity) {
+            return false;
+        }
+        changed[chunk] = digest.size != entry.size || digest.hash.result() != entry.hash;
+        changedSize += changed[chunk] ? digest.size : 0;
+    }
+
+    ProjectTable newTable = table;
+    newTable.header = FileHeader(FileType::Project, FileHeader::ChunkedVersion, project.name());
+
+    // rewrite changed chunks in place, only sectors with different content are written
+    static uint8_t sector[SectorSize];
+    size_t progress = 0;
+    for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+        if (!changed[chunk]) {
+            continue;
+        }
+
+        auto &entry = newTable.chunks[chunk];
+        size_t offset = entry.offset;
+        bool overflow = false;
+        ChunkDigest digest;
+        {
+            StagedWriter stagedWriter(
+                [&] (const uint8_t *data, size_t len) {
+                    // chunk has grown in the meantime
+                    if (offset + len > entry.offset + entry.capacity) {
+                        overflow = true;
+                        return;
+                    }
+                    while (len > 0 && file.error() == fs::OK) {
+                        size_t part = std::min(len, SectorSize - offset % SectorSize);
+                        size_t lenRead;
+                        file.seek(offset);
+                        file.read(sector, part, &lenRead);
+                        if (lenRead != part || std::memcmp(sector, data, part) != 0) {
+                            file.seek(offset);
+                            file.writeAll(data, part);
+                        }
+                        offset += part;
+                        data += part;
+                        len -= part;
+                    }
+                },
+                lockCallback, progress, changedSize
+            );
+            writeProjectChunk(project, chunk, digest, &stagedWriter);
+        }
+
+        if (file.error() != fs::OK) {
+            result = file.error();
+            return true;
+        }
+        if (overflow) {
+            return false;
+        }
+
+        entry.size = digest.size;
+        entry.hash = digest.hash.result();
+        progress += digest.size;
+    }
+
+    if (std::memcmp(&newTable, &table, sizeof(table)) != 0) {
+        file.seek(0);
+        file.writeAll(&newTable, sizeof(newTable));
+    }
+
+    result = file.error() == fs::OK ? file.close() : file.error();
+    return true;
+}
+
+fs::Error FileManager::readChunkedProject(Project &project, fs::FileReader &fileReader) {
+    uint32_t version;
+    FileChunk chunks[Project::ChunkCount];
+    fileReader.read(&version, sizeof(version));
+    fileReader.read(chunks, sizeof(chunks));
+
+    if (fileReader.error() != fs::OK) {
+        return fileReader.error();
+    }
+    if (version > ProjectVersion::Latest) {
+        return fs::INVALID_CHECKSUM;
+    }
+
+    project.beginReadChunks();
+
+    // chunks are stored in ascending order
+    size_t offset = sizeof(ProjectTable);
+    bool success = true;
+    for (int chunk = 0; chunk < Project::ChunkCount && success && fileReader.error() == fs::OK; ++chunk) {
+        const auto &entry = chunks[chunk];
+        if (entry.offset < offset) {
+            success = false;
+            break;
+        }
+        while (offset < entry.offset && fileReader.error() == fs::OK) {
+            uint8_t padding[32];
+            size_t len = std::min(sizeof(padding), size_t(entry.offset - offset));
+            fileReader.read(padding, len);
+            offset += len;
+        }
+
+        // chunk size is known, so the reader can fetch the chunk in blocks
+        VersionedSerializedReader reader(
+            [&fileReader, &offset] (void *data, size_t len) { fileReader.read(data, len); offset += len; },
+            ProjectVersion::Latest,
+            entry.size
+        );
+        success = project.readChunk(chunk, reader) && offset == entry.offset + entry.size && reader.remaining() == 0;
+    }
+
+    auto error = fileReader.finish();
+    success = project.endReadChunks(success && error == fs::OK);
+    if (error == fs::OK && !success) {
+        error = fs::INVALID_CHECKSUM;
+    }
+
+    return error;
+}
+
 fs::Error FileManager::writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write) {
     const auto &info = fileTypeInfos[int(type)];
     if (!fs::exists(info.dir)) {
@@ -7,6 +7,7 @@
 #include "Settings.h"
 
 #include "core/fs/FileSystem.h"
+#include "core/fs/FileReader.h"
 
 #include <array>
 #include <functional>
@@ -22,7 +23,10 @@ public:
 
     static fs::Error format();
 
-    static fs::Error writeProject(Project &project, int slot);
+    // Called with true/false to lock/unlock a model that is in use by the engine while it is being serialized.
+    typedef std::function<void(bool)> LockCallback;
+
+    static fs::Error writeProject(Project &project, int slot, LockCallback lockCallback = nullptr);
     static fs::Error readProject(Project &project, int slot);
     static fs::Error readLastProject(Project &project);
 
@@ -38,7 +42,7 @@ public:
     static fs::Error writeArpSequence(const ArpSequence &arpSequence, int slot);
     static fs::Error readArpSequence(ArpSequence &arpSequence, int slot);
 
-    static fs::Error writeProject(const Project &project, const char *path);
+    static fs::Error writeProject(const Project &project, const char *path, LockCallback lockCallback = nullptr);
     static fs::Error readProject(Project &project, const char *path);
 
     static fs::Error writeUserScale(const UserScale &userScale, const char *path);
@@ -74,7 +78,18 @@ public:
     static void task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback);
     static void processTask();
 
+    // progress of the current task (0..1) or -1 if the task does not report progress
+    static float taskProgress() { return _taskProgress < 0 ? -1.f : _taskProgress * (1.f / ProgressRange); }
+
 private:
+    static constexpr int32_t ProgressRange = 1000;
+
+    static void setTaskProgress(size_t done, size_t total);
+
+    static fs::Error writeWholeProject(const Project &project, const char *path, LockCallback lockCallback);
+    static bool updateProject(const Project &project, const char *path, LockCallback lockCallback, fs::Error &result);
+    static fs::Error readChunkedProject(Project &project, fs::FileReader &fileReader);
+
     static fs::Error writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write);
     static fs::Error readFile(FileType type, int slot, std::function<fs::Error(const char *)> read);
 
@@ -112,4 +127,7 @@ private:
     static TaskExecuteCallback _taskExecuteCallback;
     static TaskResultCallback _taskResultCallback;
     static volatile uint32_t _taskPending;
+    static volatile int32_t _taskProgress;
+
+    friend class StagedWriter;
 };
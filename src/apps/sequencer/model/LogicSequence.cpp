@@ -197,6 +197,8 @@ void LogicSequence::Step::clear() {
     setStageRepeatsMode(Types::StageRepeatMode::Each);
 }
 
+static_assert(sizeof(LogicSequence::Step) == 2 * sizeof(uint32_t), "step must match its serialized layout");
+
 void LogicSequence::Step::write(VersionedSerializedWriter &writer) const {
     writer.write(_data0.raw);
     writer.write(_data1.raw);
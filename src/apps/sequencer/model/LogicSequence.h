@@ -3,6 +3,7 @@
 #include "Config.h"
 #include "Bitfield.h"
 #include "Serialize.h"
+#include "ProjectVersion.h"
 #include "ModelUtils.h"
 #include "Types.h"
 #include "Scale.h"
@@ -267,6 +268,9 @@ public:
 
         void clear();
 
+        // steps are serialized as raw data since Version37
+        static constexpr uint32_t RawSerializationVersion = ProjectVersion::Version37;
+
         void write(VersionedSerializedWriter &writer) const;
         void read(VersionedSerializedReader &reader);
 
@@ -343,7 +347,7 @@ public:
 
         _scale.set(clamp(s, -1, Scale::Count - 1), routed);
 
-        auto &aScale = selectedScale(s);
+        auto &aScale = selectedScale(defaultScale);
 
         if (pScale == aScale) {
             return;
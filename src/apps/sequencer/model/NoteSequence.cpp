@@ -203,6 +203,8 @@ void NoteSequence::Step::clear() {
     setStageRepeatsMode(Types::StageRepeatMode::Each);
 }
 
+static_assert(sizeof(NoteSequence::Step) == 2 * sizeof(uint32_t), "step must match its serialized layout");
+
 void NoteSequence::Step::write(VersionedSerializedWriter &writer) const {
     writer.write(_data0.raw);
     writer.write(_data1.raw);
@@ -3,6 +3,7 @@
 #include "Config.h"
 #include "Bitfield.h"
 #include "Serialize.h"
+#include "ProjectVersion.h"
 #include "ModelUtils.h"
 #include "Types.h"
 #include "Scale.h"
@@ -226,6 +227,9 @@ public:
 
         void clear();
 
+        // steps are serialized as raw data since Version36
+        static constexpr uint32_t RawSerializationVersion = ProjectVersion::Version36;
+
         void write(VersionedSerializedWriter &writer) const;
         void read(VersionedSerializedReader &reader);
 
@@ -299,7 +303,7 @@ public:
 
         _scale.set(clamp(s, -1, Scale::Count - 1), routed);
 
-        auto &aScale = selectedScale(s);
+        auto &aScale = selectedScale(defaultScale);
 
         if (pScale == aScale) {
             return;
@@ -104,23 +104,7 @@ void Project::setTrackMode(int trackIndex, Track::TrackMode trackMode) {
 }
 
 void Project::write(VersionedSerializedWriter &writer) const {
-    writer.write(_name, NameLength + 1);
-    writer.write(_tempo.base);
-    writer.write(_swing.base);
-    _timeSignature.write(writer);
-    writer.write(_syncMeasure);
-    writer.write(_scale);
-    writer.write(_rootNote);
-    writer.write(_monitorMode);
-    writer.write(_recordMode);
-    writer.write(_midiInputMode);
-    _midiInputSource.write(writer);
-    writer.write(_midiIntegrationMode);
-    writer.write(_midiProgramOffset);
-    writer.write(_cvGateInput);
-    writer.write(_curveCvInput);
-
-    _clockSetup.write(writer);
+    writeSettings(writer);
 
     writeArray(writer, _tracks);
     writeArray(writer, _cvOutputTracks);
@@ -133,10 +117,7 @@ void Project::write(VersionedSerializedWriter &writer) const {
 
     writeArray(writer, UserScale::userScales);
 
-    writer.write(_selectedTrackIndex);
-    writer.write(_selectedPatternIndex);
-    writer.write(_resetCvOnStop);
-    writer.write(_useMultiCv);
+    writeSelection(writer);
 
     writer.writeHash();
 
@@ -146,6 +127,135 @@ void Project::write(VersionedSerializedWriter &writer) const {
 bool Project::read(VersionedSerializedReader &reader) {
     clear();
 
+    readSettings(reader);
+
+    readArray(reader, _tracks);
+    readArray(reader, _cvOutputTracks);
+    readArray(reader, _gateOutputTracks);
+
+    _song.read(reader);
+    _playState.read(reader);
+    _routing.read(reader);
+    _midiOutput.read(reader);
+
+    if (reader.dataVersion() >= ProjectVersion::Version5) {
+        readArray(reader, UserScale::userScales);
+    }
+
+    readSelection(reader);
+
+    bool success = reader.checkHash();
+    if (success) {
+        _observable.notify(ProjectRead);
+    } else {
+        clear();
+    }
+
+    return success;
+}
+
+void Project::writeChunk(int chunk, VersionedSerializedWriter &writer) const {
+    switch (chunk) {
+    case SettingsChunk:
+        writeSettings(writer);
+        writeArray(writer, _cvOutputTracks);
+        writeArray(writer, _gateOutputTracks);
+        writeSelection(writer);
+        _autoLoaded = false;
+        break;
+    case SongChunk:
+        _song.write(writer);
+        break;
+    case PlayStateChunk:
+        _playState.write(writer);
+        break;
+    case RoutingChunk:
+        _routing.write(writer);
+        break;
+    case MidiOutputChunk:
+        _midiOutput.write(writer);
+        break;
+    case UserScalesChunk:
+        writeArray(writer, UserScale::userScales);
+        break;
+    default:
+        if (chunk >= TrackChunk && chunk < TrackChunk + CONFIG_TRACK_COUNT) {
+            _tracks[chunk - TrackChunk].write(writer);
+        }
+        break;
+    }
+
+    writer.writeHash();
+}
+
+void Project::beginReadChunks() {
+    clear();
+}
+
+bool Project::readChunk(int chunk, VersionedSerializedReader &reader) {
+    switch (chunk) {
+    case SettingsChunk:
+        readSettings(reader);
+        readArray(reader, _cvOutputTracks);
+        readArray(reader, _gateOutputTracks);
+        readSelection(reader);
+        break;
+    case SongChunk:
+        _song.read(reader);
+        break;
+    case PlayStateChunk:
+        _playState.read(reader);
+        break;
+    case RoutingChunk:
+        _routing.read(reader);
+        break;
+    case MidiOutputChunk:
+        _midiOutput.read(reader);
+        break;
+    case UserScalesChunk:
+        readArray(reader, UserScale::userScales);
+        break;
+    default:
+        if (chunk >= TrackChunk && chunk < TrackChunk + CONFIG_TRACK_COUNT) {
+            _tracks[chunk - TrackChunk].read(reader);
+        }
+        break;
+    }
+
+    return reader.checkHash();
+}
+
+bool Project::endReadChunks(bool success) {
+    if (success) {
+        _observable.notify(ProjectRead);
+    } else {
+        clear();
+    }
+
+    return success;
+}
+
+void Project::writeSettings(VersionedSerializedWriter &writer) const {
+    writer.write(_name, NameLength + 1);
+    writer.write(_tempo.base);
+    writer.write(_swing.base);
+    _timeSignature.write(writer);
+    writer.write(_syncMeasure);
+    writer.write(_scale);
+    writer.write(_rootNote);
+    writer.write(_monitorMode);
+    writer.write(_recordMode);
+    writer.write(_midiInputMode);
+    _midiInputSource.write(writer);
+    writer.write(_midiIntegrationMode);
+    writer.write(_midiProgramOffset);
+    writer.write(_cvGateInput);
+    writer.write(_curveCvInput);
+
+    _clockSetup.write(writer);
+}
+
+void Project::readSettings(VersionedSerializedReader &reader) {
     reader.read(_name, NameLength + 1, ProjectVersion::Version5);
     reader.read(_tempo.base);
     _orinalTempo = _tempo.base;
@@ -172,31 +282,18 @@ bool Project::read(VersionedSerializedReader &reader) {
     reader.read(_curveCvInput, ProjectVersion::Version11);
 
     _clockSetup.read(reader);
+}
 
-    readArray(reader, _tracks);
-    readArray(reader, _cvOutputTracks);
-    readArray(reader, _gateOutputTracks);
-
-    _song.read(reader);
-    _playState.read(reader);
-    _routing.read(reader);
-    _midiOutput.read(reader);
-
-    if (reader.dataVersion() >= ProjectVersion::Version5) {
-        readArray(reader, UserScale::userScales);
-    }
+void Project::writeSelection(VersionedSerializedWriter &writer) const {
+    writer.write(_selectedTrackIndex);
+    writer.write(_selectedPatternIndex);
+    writer.write(_resetCvOnStop);
+    writer.write(_useMultiCv);
+}
 
+void Project::readSelection(VersionedSerializedReader &reader) {
     reader.read(_selectedTrackIndex);
     reader.read(_selectedPatternIndex);
     reader.read(_resetCvOnStop, ProjectVersion::Version38);
     reader.read(_useMultiCv, ProjectVersion::Version39);
-
-    bool success = reader.checkHash();
-    if (success) {
-        _observable.notify(ProjectRead);
-    } else {
-        clear();
-    }
-
-    return success;
 }
@@ -677,7 +677,39 @@ public:
     void write(VersionedSerializedWriter &writer) const;
     bool read(VersionedSerializedReader &reader);
 
+    //----------------------------------------
+    // Chunked serialization
+    //----------------------------------------
+
+    // Project files are stored as a table of chunks (see FileHeader::ChunkedVersion).
+    // Each chunk is serialized separately (including its own version and hash), which allows
+    // updating only the chunks of a project file that have changed.
+    enum Chunk {
+        SettingsChunk,
+        TrackChunk,
+        SongChunk = TrackChunk + CONFIG_TRACK_COUNT,
+        PlayStateChunk,
+        RoutingChunk,
+        MidiOutputChunk,
+        UserScalesChunk,
+        ChunkCount
+    };
+
+    void writeChunk(int chunk, VersionedSerializedWriter &writer) const;
+
+    // chunks are read in between beginReadChunks() and endReadChunks()
+    void beginReadChunks();
+    bool readChunk(int chunk, VersionedSerializedReader &reader);
+    bool endReadChunks(bool success);
+
 private:
+    // settings stored at the beginning of the project and the settings chunk
+    void writeSettings(VersionedSerializedWriter &writer) const;
+    void readSettings(VersionedSerializedReader &reader);
+    // selection and options stored at the end of the project and the settings chunk
+    void writeSelection(VersionedSerializedWriter &writer) const;
+    void readSelection(VersionedSerializedReader &reader);
+
     uint8_t _slot = uint8_t(-1);
     char _name[NameLength + 1];
     mutable uint8_t _autoLoaded = 0;
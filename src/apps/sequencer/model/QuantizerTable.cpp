@@ -0,0 +1,104 @@
+#include "QuantizerTable.h"
+
+#include <algorithm>
+
+#include <cmath>
+
+void QuantizerTable::build(const Scale &scale, int rootNote) {
+    _scale = &scale;
+    _chromatic = scale.isChromatic();
+    _rootNote = _chromatic ? rootNote : 0;
+    _revision = scale.revision();
+    _notesPerOctave = scale.notesPerOctave();
+
+    scale.grid(_grid);
+    _validGrid = _grid.octaveKeys > 0.f && _grid.octaveNotes > 0 && _grid.octaveNotes <= MaxNotes && _grid.thresholdCount > 0;
+
+    // note to volts
+    _octaveNotes = clamp(_grid.octaveNotes, 1, MaxNotes);
+    _octaveVolts = _grid.octaveVolts;
+    _rootVolts = _rootNote * (1.f / 12.f);
+    for (int i = 0; i < _octaveNotes; ++i) {
+        _volts[i] = scale.noteToVolts(i);
+    }
+
+    // note presence
+    _presentNotes = 0;
+    for (int note = 0; note < NoteRange; ++note) {
+        _noteIndex[note] = scale.getNoteIndex(note);
+        if (scale.isNotePresent(note)) {
+            _presentNotes |= 1 << note;
+        }
+    }
+
+    // MIDI note to note
+    for (int midiNote = 0; midiNote < 128; ++midiNote) {
+        _midiNotes[midiNote] = scale.noteFromVolts((midiNote - 60 - _rootNote) * (1.f / 12.f));
+    }
+}
+
+int QuantizerTable::noteFromVolts(float volts) const {
+    if (!_validGrid) {
+        return _scale->noteFromVolts(volts);
+    }
+
+    float key = volts * _grid.keyScale + _grid.keyOffset;
+    if (_grid.floorKey) {
+        key = std::floor(key);
+    }
+    int octave = std::floor(key / _grid.octaveKeys);
+    float remainder = key - octave * _grid.octaveKeys;
+
+    const float *thresholds = _grid.thresholds;
+    int index = int(std::upper_bound(thresholds, thresholds + _grid.thresholdCount, remainder) - thresholds) - 1;
+    if (index == -1) {
+        index = _grid.thresholdCount - 1;
+        --octave;
+    }
+
+    return octave * _grid.octaveNotes + index;
+}
+
+struct CacheEntry {
+    QuantizerTable table;
+    uint32_t lastUse = 0;
+};
+
+static std::array<CacheEntry, QuantizerTable::CacheSize> cache;
+static uint32_t cacheTime;
+
+const QuantizerTable &QuantizerTable::get(const Scale &scale, int rootNote) {
+    if (!scale.isChromatic()) {
+        rootNote = 0;
+    }
+
+    ++cacheTime;
+
+    // lookup, evict the least recently used table on a miss
+    CacheEntry *victim = &cache[0];
+    for (auto &entry : cache) {
+        auto &table = entry.table;
+        if (table._scale == &scale && table._rootNote == rootNote) {
+            if (table._revision != scale.revision()) {
+                table.build(scale, rootNote);
+            }
+            entry.lastUse = cacheTime;
+            return table;
+        }
+        if (entry.lastUse < victim->lastUse) {
+            victim = &entry;
+        }
+    }
+
+    victim->table.build(scale, rootNote);
+    victim->lastUse = cacheTime;
+    return victim->table;
+}
+
+void QuantizerTable::clearCache() {
+    for (auto &entry : cache) {
+        entry.table._scale = nullptr;
+        entry.lastUse = 0;
+    }
+    cacheTime = 0;
+}
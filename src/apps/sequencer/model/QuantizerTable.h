@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Config.h"
+
+#include "Scale.h"
+
+#include "core/math/Math.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Precomputed lookup tables of a scale and root note.
+// Replaces the per-call linear searches and virtual calls of Scale when quantizing notes in the engines:
+// - MIDI note to scale note in a single table lookup
+// - scale note to volts (including the root note offset of chromatic scales) without division
+// - volts to scale note using a binary search on the note grid of the scale
+// Tables are cached and shared across track engines, use QuantizerTable::get() to obtain a table.
+// Tables of user scales are rebuilt when the scale is edited.
+class QuantizerTable {
+public:
+    static constexpr int MaxNotes = Scale::MaxGridNotes;
+    // one table per track plus two spare tables (e.g. for fill sequences using a different scale)
+    static constexpr int CacheSize = CONFIG_TRACK_COUNT + 2;
+
+    QuantizerTable() = default;
+    QuantizerTable(const Scale &scale, int rootNote) { build(scale, rootNote); }
+
+    void build(const Scale &scale, int rootNote);
+
+    const Scale &scale() const { return *_scale; }
+    int rootNote() const { return _rootNote; }
+    uint32_t revision() const { return _revision; }
+
+    bool isChromatic() const { return _chromatic; }
+    int notesPerOctave() const { return _notesPerOctave; }
+
+    // same as Scale::isNotePresent()
+    bool isNotePresent(int note) const {
+        return (note >= 0 && note < NoteRange) ? (_presentNotes & (1 << note)) != 0 : _scale->isNotePresent(note);
+    }
+
+    // same as Scale::getNoteIndex()
+    int getNoteIndex(int note) const {
+        return (note >= 0 && note < NoteRange) ? _noteIndex[note] : _scale->getNoteIndex(note);
+    }
+
+    // same as Scale::noteToVolts() including the root note offset of chromatic scales
+    float noteToVolts(int note) const {
+        int octave = roundDownDivide(note, _octaveNotes);
+        int index = note - octave * _octaveNotes;
+        return octave * _octaveVolts + _volts[index] + _rootVolts;
+    }
+
+    // same as Scale::noteFromVolts()
+    int noteFromVolts(float volts) const;
+
+    // scale note of a MIDI note (relative to the root note for chromatic scales) as used when recording
+    int noteFromMidiNote(int midiNote) const {
+        return _midiNotes[clamp(midiNote, 0, 127)];
+    }
+
+    // returns the shared table of a scale and root note, building it if necessary
+    // (must only be called from the engine task)
+    static const QuantizerTable &get(const Scale &scale, int rootNote);
+
+    // drop all cached tables
+    static void clearCache();
+
+private:
+    static constexpr int NoteRange = 24;
+
+    const Scale *_scale = nullptr;
+    int8_t _rootNote = 0;
+    bool _chromatic = false;
+    bool _validGrid = false;
+    uint32_t _revision = 0;
+
+    int _notesPerOctave = 1;
+    int _octaveNotes = 1;
+    float _octaveVolts = 1.f;
+    float _rootVolts = 0.f;
+    std::array<float, MaxNotes> _volts;
+
+    Scale::Grid _grid;
+
+    uint32_t _presentNotes;
+    std::array<int8_t, NoteRange> _noteIndex;
+    std::array<int16_t, 128> _midiNotes;
+};
@@ -7,6 +7,8 @@
 
 #include <algorithm>
 
+#include <limits>
+
 #include <cstdint>
 #include <cmath>
 
@@ -18,6 +20,23 @@ public:
         Long,
     };
 
+    static constexpr int MaxGridNotes = 32;
+
+    // Note grid of noteToVolts()/noteFromVolts(), describes the mapping between notes and volts so it can be
+    // tabulated by QuantizerTable. Volts are converted to a key (volts * keyScale + keyOffset, rounded down if
+    // floorKey is set), the key is split into octaves of octaveKeys and the last threshold less or equal to the
+    // remainder gives the index within the octave. A note is octave * octaveNotes + index.
+    struct Grid {
+        float keyScale;
+        float keyOffset;
+        bool floorKey;
+        float octaveKeys;
+        float octaveVolts;
+        int octaveNotes;
+        int thresholdCount;
+        float thresholds[MaxGridNotes]; // non-decreasing
+    };
+
     Scale(const char *name) :
         _displayName(name)
     {}
@@ -33,6 +52,11 @@ public:
 
     virtual int notesPerOctave() const = 0;
 
+    virtual void grid(Grid &grid) const = 0;
+
+    // incremented whenever the scale is changed (only user scales are editable)
+    uint32_t revision() const { return _revision; }
+
     static int Count;
     static const Scale &get(int index);
     static const char *name(int index);
@@ -43,10 +67,14 @@ public:
     
     }
 
+protected:
+    void invalidate() { ++_revision; }
+
 private:
     const char *displayName() const { return _displayName; }
 
     const char *_displayName;
+    uint32_t _revision = 0;
 };
 
 
@@ -164,6 +192,19 @@ public:
         return _noteCount;
     }
 
+    void grid(Grid &grid) const override {
+        grid.keyScale = 1.f;
+        grid.keyOffset = 0.01f;
+        grid.floorKey = false;
+        grid.octaveKeys = 1.f;
+        grid.octaveVolts = 1.f;
+        grid.octaveNotes = _noteCount;
+        grid.thresholdCount = std::min(int(_noteCount), int(MaxGridNotes));
+        for (int i = 0; i < grid.thresholdCount; ++i) {
+            grid.thresholds[i] = _notes[i] * (1.f / 1536.f);
+        }
+    }
+
 private:
     bool _chromatic;
     uint16_t _noteCount;
@@ -220,6 +261,18 @@ public:
         return std::max(1, int(std::round(1.f / _interval)));
     }
 
+    void grid(Grid &grid) const override {
+        // every interval is a single note octave
+        grid.keyScale = 1.f;
+        grid.keyOffset = 0.f;
+        grid.floorKey = false;
+        grid.octaveKeys = _interval;
+        grid.octaveVolts = _interval;
+        grid.octaveNotes = 1;
+        grid.thresholdCount = 1;
+        grid.thresholds[0] = std::numeric_limits<float>::lowest();
+    }
+
 private:
     float _interval;
 };
@@ -8,8 +8,26 @@
 #include <cstdlib>
 #include <cstdint>
 
+// Types declaring a static RawSerializationVersion member are serialized as their raw memory representation since
+// that version, which allows arrays of them to be written and read with a single bulk copy.
+// Data of older versions is read element by element.
+template<typename T>
+struct RawSerialization {
+    template<typename U>
+    static constexpr uint32_t version(decltype(U::RawSerializationVersion) *) { return U::RawSerializationVersion; }
+    template<typename U>
+    static constexpr uint32_t version(...) { return UINT32_MAX; }
+
+    static constexpr uint32_t Version = version<T>(nullptr);
+    static constexpr bool Enabled = Version != UINT32_MAX;
+};
+
 template<typename T, size_t N>
 static void writeArray(VersionedSerializedWriter &writer, const std::array<T, N> &array) {
+    if (RawSerialization<T>::Enabled) {
+        writer.write(array.data(), sizeof(T) * N);
+        return;
+    }
     for (size_t i = 0; i < array.size(); ++i) {
         array[i].write(writer);
     }
@@ -17,13 +35,15 @@ static void writeArray(VersionedSerializedWriter &writer, const std::array<T, N>
 
 template<size_t N>
 static void writeArray(VersionedSerializedWriter &writer, const std::array<uint8_t, N> &array) {
-    for (size_t i = 0; i < array.size(); ++i) {
-        writer.write(array[i]);
-    }
+    writer.write(array.data(), N);
 }
 
 template<typename T, size_t N>
 static void readArray(VersionedSerializedReader &reader, std::array<T, N> &array, size_t size = N) {
+    if (RawSerialization<T>::Enabled && reader.dataVersion() >= RawSerialization<T>::Version) {
+        reader.read(array.data(), sizeof(T) * size, 0);
+        return;
+    }
     for (size_t i = 0; i < size; ++i) {
         array[i].read(reader);
     }
@@ -31,7 +51,5 @@ static void readArray(VersionedSerializedReader &reader, std::array<T, N> &array
 
 template<size_t N>
 static void readArray(VersionedSerializedReader &reader, std::array<uint8_t, N> &array, size_t size = N) {
-    for (size_t i = 0; i < size; ++i) {
-        reader.read(array[i]);
-    }
+    reader.read(array.data(), size, 0);
 }
@@ -192,6 +192,8 @@ void StochasticSequence::Step::clear() {
     setStageRepeatsMode(StageRepeatMode::Each);
 }
 
+static_assert(sizeof(StochasticSequence::Step) == 2 * sizeof(uint32_t), "step must match its serialized layout");
+
 void StochasticSequence::Step::write(VersionedSerializedWriter &writer) const {
     writer.write(_data0.raw);
     writer.write(_data1.raw);
@@ -3,6 +3,7 @@
 #include "Config.h"
 #include "Bitfield.h"
 #include "Serialize.h"
+#include "ProjectVersion.h"
 #include "ModelUtils.h"
 #include "Types.h"
 #include "Scale.h"
@@ -246,6 +247,9 @@ public:
 
         void clear();
 
+        // steps are serialized as raw data since Version27
+        static constexpr uint32_t RawSerializationVersion = ProjectVersion::Version27;
+
         void write(VersionedSerializedWriter &writer) const;
         void read(VersionedSerializedReader &reader);
 
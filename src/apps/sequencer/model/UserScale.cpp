@@ -21,6 +21,7 @@ void UserScale::clearItems() {
     if (_mode == Mode::Voltage) {
         _items[1] = 1000;
     }
+    invalidate();
 }
 
 void UserScale::write(VersionedSerializedWriter &writer) const {
@@ -51,5 +52,7 @@ bool UserScale::read(VersionedSerializedReader &reader) {
         clear();
     }
 
+    invalidate();
+
     return success;
 }
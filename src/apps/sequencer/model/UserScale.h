@@ -60,6 +60,7 @@ public:
         if (mode != _mode) {
             _mode = mode;
             clearItems();
+            invalidate();
         }
     }
 
@@ -76,6 +77,7 @@ public:
     int size() const { return _size; }
     void setSize(int size) {
         _size = clamp(size, _mode == Mode::Chromatic ? 1 : 2, CONFIG_USER_SCALE_SIZE);
+        invalidate();
     }
 
     void editSize(int value, bool shift) {
@@ -103,6 +105,7 @@ public:
         case Mode::Last:
             break;
         }
+        invalidate();
     }
 
     void editItem(int index, int value, int shift) {
@@ -231,6 +234,35 @@ public:
         return _mode == Mode::Chromatic ? _size : _size - 1;
     }
 
+    void grid(Grid &grid) const override {
+        grid.thresholdCount = std::min(int(_size), int(MaxGridNotes));
+        switch (_mode) {
+        case Mode::Chromatic:
+            grid.keyScale = 12.f;
+            grid.keyOffset = 0.01f;
+            grid.floorKey = true;
+            grid.octaveKeys = 12.f;
+            grid.octaveVolts = 1.f;
+            break;
+        case Mode::Voltage:
+        case Mode::Last:
+            grid.keyScale = 1000.f;
+            grid.keyOffset = 0.f;
+            grid.floorKey = false;
+            grid.octaveKeys = _items[_size - 1] - _items[0];
+            grid.octaveVolts = octaveRangeVolts();
+            break;
+        }
+        grid.octaveNotes = notesPerOctave();
+        // items are not required to be sorted, the linear search in noteFromVolts() stops at the first item
+        // above the key, which is the first item where the running maximum is above the key
+        float max = std::numeric_limits<float>::lowest();
+        for (int i = 0; i < grid.thresholdCount; ++i) {
+            max = std::max(max, float(_items[i]));
+            grid.thresholds[i] = max;
+        }
+    }
+
     static Array userScales;
 
 private:
@@ -15,6 +15,7 @@
 #define SettingPatternChange "patternchg"
 #define SettingLaunchpadNoteStyle "lpnote"
 #define SettingSyncSong "syncsong"
+#define SettingTickRouting "tickrouting"
 
 class BaseSetting {
 public:
@@ -36,14 +37,16 @@ public:
         std::string menuItem,
         std::vector<std::string> menuItemKeys,
         std::vector<T> menuItemValues,
-        T defaultValue
+        T defaultValue,
+        uint32_t addedInVersion = 0
     ) :
         _value(defaultValue),
         _key(std::move(key)),
         _menuItem(std::move(menuItem)),
         _menuItemKeys(std::move(menuItemKeys)),
         _menuItemValues(std::move(menuItemValues)),
-        _defaultValue(defaultValue)
+        _defaultValue(defaultValue),
+        _addedInVersion(addedInVersion)
     {}
 
     std::string getKey() override {
@@ -81,7 +84,7 @@ public:
     };
 
     void read(VersionedSerializedReader &reader) override {
-        reader.read(getValue());
+        reader.read(getValue(), _addedInVersion);
     };
 
     void write(VersionedSerializedWriter &writer) override {
@@ -101,6 +104,7 @@ private:
     std::vector<std::string> _menuItemKeys;
     std::vector<T> _menuItemValues;
     T _defaultValue;
+    uint32_t _addedInVersion;
 };
 
 class BrightnessSetting : public Setting<float> {
@@ -191,6 +195,18 @@ class SyncSong : public Setting<int> {
     ) {}
 };
 
+class TickRoutingSetting : public Setting<bool> {
+    public:
+    TickRoutingSetting() : Setting(
+        SettingTickRouting,
+        "Tick Routing",
+        {"batched", "per tick"},
+        {false, true},
+        false,
+        2
+    ) {}
+};
+
 class UserSettings {
 public:
     UserSettings() {
@@ -205,6 +221,8 @@ public:
 
         addSetting(new LaunchpadStyleSetting());
         addSetting(new LaunchpadNoteStyle());
+
+        addSetting(new TickRoutingSetting());
     }
 
     //----------------------------------------
@@ -1,4 +1,5 @@
 #include "core/midi/MidiMessage.h"
+#include "core/profiler/Profiler.h"
 
 #include <pybind11/pybind11.h>
 
@@ -20,4 +21,46 @@ void register_core(py::module &m) {
         .def_static("makeChannelPressure", &MidiMessage::makeChannelPressure, py::arg("channel"), py::arg("pressure"))
         .def_static("makePitchBend", &MidiMessage::makePitchBend, py::arg("channel"), py::arg("pitchBend"))
     ;
+
+#if CONFIG_ENABLE_PROFILER
+    // ------------------------------------------------------------------------
+    // Profiler
+    // ------------------------------------------------------------------------
+
+    py::class_<Profiler::IntervalSnapshot> intervalSnapshot(m, "IntervalSnapshot");
+    intervalSnapshot
+        .def_property_readonly("desc", [] (const Profiler::IntervalSnapshot &snapshot) { return std::string(snapshot.desc); })
+        .def_readonly("count", &Profiler::IntervalSnapshot::count)
+        .def_readonly("last", &Profiler::IntervalSnapshot::last)
+        .def_readonly("min", &Profiler::IntervalSnapshot::min)
+        .def_readonly("max", &Profiler::IntervalSnapshot::max)
+        .def_readonly("mean", &Profiler::IntervalSnapshot::mean)
+        .def_readonly("budget", &Profiler::IntervalSnapshot::budget)
+        .def_property_readonly("meanUtilization", &Profiler::IntervalSnapshot::meanUtilization)
+        .def_property_readonly("maxUtilization", &Profiler::IntervalSnapshot::maxUtilization)
+        .def_property_readonly("histogram", [] (const Profiler::IntervalSnapshot &snapshot) {
+            py::list result;
+            for (int i = 0; i < Profiler::HistogramBuckets; ++i) {
+                result.append(snapshot.histogram[i]);
+            }
+            return result;
+        })
+    ;
+
+    py::class_<Profiler> profiler(m, "Profiler");
+    profiler
+        .def_static("dump", &Profiler::dump)
+        .def_static("reset", &Profiler::reset)
+        .def_static("intervals", [] () {
+            py::list result;
+            Profiler::forEachInterval([&result] (const Profiler::Interval &interval) {
+                Profiler::IntervalSnapshot snapshot;
+                if (interval.snapshot(snapshot)) {
+                    result.append(snapshot);
+                }
+            });
+            return result;
+        })
+    ;
+#endif // CONFIG_ENABLE_PROFILER
 }
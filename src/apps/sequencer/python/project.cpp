@@ -19,6 +19,29 @@ static void loadProject(Project &project, const std::string &filename) {
     FileHeader header;
     ifs.read(reinterpret_cast<char *>(&header), sizeof(header));
 
+    if (header.version == FileHeader::ChunkedVersion) {
+        uint32_t version;
+        FileChunk chunks[Project::ChunkCount];
+        ifs.read(reinterpret_cast<char *>(&version), sizeof(version));
+        ifs.read(reinterpret_cast<char *>(chunks), sizeof(chunks));
+
+        bool success = ifs.good();
+        project.beginReadChunks();
+        for (int chunk = 0; chunk < Project::ChunkCount && success; ++chunk) {
+            ifs.seekg(chunks[chunk].offset);
+            VersionedSerializedReader reader(
+                [&ifs] (void *data, size_t len) { ifs.read(reinterpret_cast<char *>(data), len); },
+                ProjectVersion::Latest,
+                chunks[chunk].size
+            );
+            success = project.readChunk(chunk, reader) && ifs.good();
+        }
+        if (!project.endReadChunks(success)) {
+            throw std::runtime_error("Failed to load project");
+        }
+        return;
+    }
+
     VersionedSerializedReader reader(
         [&ifs] (void *data, size_t len) { ifs.read(reinterpret_cast<char *>(data), len); },
         ProjectVersion::Latest
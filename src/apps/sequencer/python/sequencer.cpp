@@ -15,6 +15,7 @@ void register_sequencer(py::module &m) {
     py::class_<SequencerApp> sequencer(m, "Sequencer");
     sequencer
         .def_property_readonly("model", [] (SequencerApp &app) { return &app.model; })
+        .def_property_readonly("sdCard", [] (SequencerApp &app) { return &app.sdCard; })
     ;
 
     // ------------------------------------------------------------------------
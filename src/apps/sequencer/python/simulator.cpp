@@ -1,5 +1,7 @@
 #include "sim/Simulator.h"
 
+#include "drivers/SdCard.h"
+
 #include <pybind11/pybind11.h>
 
 namespace py = pybind11;
@@ -24,6 +26,29 @@ void register_simulator(py::module &m) {
         .def_property_readonly("targetState", &Simulator::targetState, py::return_value_policy::reference)
     ;
 
+    // ------------------------------------------------------------------------
+    // SdCard
+    // ------------------------------------------------------------------------
+
+    // needs to be called before the simulator is first stepped
+    m.def("configureSdCard", &SdCard::configure, py::arg("path"), py::arg("sectorCount") = size_t(SdCard::DefaultSectorCount));
+
+    py::class_<SdCard::SectorStats> sectorStats(m, "SectorStats");
+    sectorStats
+        .def_readonly("reads", &SdCard::SectorStats::reads)
+        .def_readonly("writes", &SdCard::SectorStats::writes)
+        .def_readonly("syncs", &SdCard::SectorStats::syncs)
+    ;
+
+    py::class_<SdCard> sdCard(m, "SdCard");
+    sdCard
+        .def_property_readonly("sectorCount", &SdCard::sectorCount)
+        .def_property_readonly("isMapped", &SdCard::isMapped)
+        .def("sectorStats", &SdCard::sectorStats, py::return_value_policy::copy)
+        .def("totalStats", &SdCard::totalStats)
+        .def("resetStats", &SdCard::resetStats)
+    ;
+
     // ------------------------------------------------------------------------
     // TargetTrace
     // ------------------------------------------------------------------------
@@ -1,5 +1,8 @@
 #include "ControllerManager.h"
 
+#include "core/profiler/Profiler.h"
+
+PROFILER_COUNTER(controllerFramesSkipped, "controller frames skipped")
 
 ControllerManager::ControllerManager(Model &model, Engine &engine) :
     _model(model),
@@ -28,6 +31,11 @@ void ControllerManager::disconnect() {
 
 void ControllerManager::update() {
     if (_controller) {
+        // let the usb link catch up with previous frames, the controller frame rate adapts to the available bandwidth
+        if (_engine.midiTxPending(_port) > MaxTxPending) {
+            PROFILER_COUNTER_ADD(controllerFramesSkipped, 1);
+            return;
+        }
         _controller->update();
     }
 }
@@ -42,5 +50,6 @@ bool ControllerManager::recvMidi(MidiPort port, uint8_t cable, const MidiMessage
 }
 
 bool ControllerManager::sendMidi(uint8_t cable, const MidiMessage &message) {
-    return _engine.sendMidi(_port, cable, message);
+    // sequencer output always goes first
+    return _engine.sendMidiLowPriority(_port, cable, message);
 }
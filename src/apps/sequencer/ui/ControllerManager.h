@@ -51,6 +51,9 @@ public:
     }
 
 private:
+    // controller frames are skipped while more messages are waiting for transmission
+    static constexpr int MaxTxPending = 16;
+
     bool sendMidi(uint8_t cable, const MidiMessage &message);
 
     Model &_model;
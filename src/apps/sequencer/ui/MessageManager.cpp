@@ -15,14 +15,20 @@ void MessageManager::showMessage(const char *text, uint32_t duration) {
 
     StringUtils::copy(_text, text, sizeof(_text));
     _timeout = os::ticks() + os::time::ms(duration);
+    _changed = true;
 }
 
-void MessageManager::update() {
+bool MessageManager::update() {
     os::LockGuard lock(_mutex);
 
-    if (os::ticks() > _timeout) {
+    if (_timeout && os::ticks() > _timeout) {
         _timeout = 0;
+        _changed = true;
     }
+
+    bool changed = _changed;
+    _changed = false;
+    return changed;
 }
 
 void MessageManager::draw(Canvas &canvas) {
@@ -11,6 +11,17 @@ class PageManager;
 
 class Page {
 public:
+    // State drawn by a page besides the page state itself. Pages are only redrawn when state they depend on has been
+    // invalidated (see PageManager::invalidate), the page state is invalidated by events, page switches and messages.
+    enum DrawDependency : uint8_t {
+        DrawPage    = (1 << 0), // page state (implied for all pages)
+        DrawProject = (1 << 1), // project events (selected track and pattern, track modes, project loaded or cleared)
+        DrawEngine  = (1 << 2), // engine state (playheads, play state, clock, tempo, outputs)
+        DrawRouting = (1 << 3), // routed parameters
+        DrawTime    = (1 << 4), // animations and timeouts (invalidated every frame)
+        DrawAlways  = 0xff,
+    };
+
     Page(PageManager &manager);
 
     virtual void enter() {}
@@ -21,6 +32,9 @@ public:
 
     virtual int fps() const { return CONFIG_DEFAULT_UI_FPS; }
 
+    // state drawn by the page (see DrawDependency), pages are redrawn every frame by default
+    virtual uint8_t drawDependencies() const { return DrawAlways; }
+
     virtual bool isModal() const { return false; }
 
     // Event handlers
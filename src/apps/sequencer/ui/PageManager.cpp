@@ -15,6 +15,7 @@ void PageManager::push(Page *page) {
     ASSERT(_pageStackPos < PageStackSize - 1, "page stack overflow");
     _pageStack[++_pageStackPos] = page;
     page->enter();
+    invalidate();
 
     notifyPageSwitch(page);
 }
@@ -23,6 +24,7 @@ void PageManager::pop() {
     ASSERT(_pageStackPos > 0, "page stack underflow");
     top()->exit();
     --_pageStackPos;
+    invalidate();
 
     if (_pageStackPos >= 0) {
         notifyPageSwitch(top());
@@ -43,17 +45,44 @@ void PageManager::replace(int index, Page *page) {
     pagePtr->exit();
     pagePtr = page;
     pagePtr->enter();
+    invalidate();
 
     if (index == _pageStackPos) {
         notifyPageSwitch(page);
     }
 }
 
-void PageManager::draw(Canvas &canvas) {
+bool PageManager::draw(Canvas &canvas) {
+    uint8_t invalid = _invalid.exchange(0) | Page::DrawTime;
+
+    bool redraw = false;
+    for (int i = 0; i <= _pageStackPos; ++i) {
+        if ((_pageStack[i]->drawDependencies() | Page::DrawPage) & invalid) {
+            redraw = true;
+            break;
+        }
+    }
+
+    // keep drawing for a few frames after an invalidation and refresh unchanged pages once in a while
+    if (redraw) {
+        _settleFrames = CONFIG_UI_SETTLE_FRAMES;
+    } else if (_settleFrames > 0) {
+        --_settleFrames;
+        redraw = true;
+    } else if (++_refreshFrames >= CONFIG_UI_REFRESH_FRAMES) {
+        redraw = true;
+    }
+
+    if (!redraw) {
+        return false;
+    }
+    _refreshFrames = 0;
+
     // draw bottom to top
     for (int i = 0; i <= _pageStackPos; ++i) {
         _pageStack[i]->draw(canvas);
     }
+    return true;
 }
 
 void PageManager::updateLeds(Leds &leds) {
@@ -73,6 +102,8 @@ int PageManager::fps() const {
 
 
 void PageManager::dispatchEvent(Event &event) {
+    invalidate();
+
     // handle modal page
     if (top()->isModal() && !event.consumed()) {
         top()->dispatchEvent(event);
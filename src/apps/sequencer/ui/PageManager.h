@@ -8,6 +8,7 @@
 #include "core/gfx/Canvas.h"
 
 #include <array>
+#include <atomic>
 #include <functional>
 
 struct Pages;
@@ -30,7 +31,13 @@ public:
     void reset(Page *page);
     void replace(int index, Page *page);
 
-    void draw(Canvas &canvas);
+    // mark state drawn by pages as changed (see Page::DrawDependency)
+    void invalidate(uint8_t dependencies = Page::DrawAlways) {
+        _invalid.fetch_or(dependencies);
+    }
+
+    // draw the page stack if any page depends on invalidated state, returns true if the pages were drawn
+    bool draw(Canvas &canvas);
     void updateLeds(Leds &leds);
 
     int fps() const;
@@ -53,4 +60,8 @@ private:
     std::array<Page *, PageStackSize> _pageStack;
     int _pageStackPos = -1;
     PageSwitchHandler _pageSwitchHandler;
+
+    std::atomic<uint8_t> _invalid { Page::DrawAlways };
+    int _settleFrames = 0;
+    int _refreshFrames = 0;
 };
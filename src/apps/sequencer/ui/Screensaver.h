@@ -16,6 +16,7 @@ public:
     void on();
     void off();
     bool shouldBeOn();
+    bool isOn() const { return _screenSaved; }
 
     void setScreenOnTicks(uint32_t ticks);
     void incScreenOnTicks(uint32_t ticks);
@@ -4,11 +4,20 @@
 #include "Key.h"
 
 #include "core/Debug.h"
+#include "core/hash/FnvHash.h"
 #include "core/profiler/Profiler.h"
 #include "core/utils/StringBuilder.h"
 
 #include "model/Model.h"
 
+PROFILER_INTERVAL(uiLeds, "ui led sync")
+PROFILER_INTERVAL(uiDraw, "ui draw")
+PROFILER_INTERVAL(uiLcd, "ui lcd update")
+PROFILER_COUNTER(uiFramesRetained, "ui frames retained")
+PROFILER_COUNTER(uiLcdBytes, "ui lcd bytes sent")
+PROFILER_COUNTER(uiLcdSkipped, "ui lcd frames skipped")
+PROFILER_INTERVAL(uiControllers, "ui controller sync")
+
 Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &encoder, Settings &settings) :
         _model(model),
         _engine(engine),
@@ -45,12 +54,8 @@ void Ui::init() {
 #endif
     _pageManager.push(&_pages.startup);
 
+    // messages are forwarded through the engine's receive queue and handled in handleMidi()
     _engine.setMidiReceiveHandler([this] (MidiPort port, uint8_t cable, const MidiMessage &message) {
-        if (!_receiveMidiEvents.writable()) {
-            DBG("ui midi buffer overflow");
-            _receiveMidiEvents.read();
-        }
-        _receiveMidiEvents.write({ port, cable, message });
         return port == MidiPort::UsbMidi && _controllerManager.isConnected();
     });
 
@@ -82,30 +87,55 @@ void Ui::update() {
         return;
     }
 
+    PROFILER_INTERVAL_BEGIN(uiLeds)
     _leds.clear();
     _pageManager.updateLeds(_leds);
     _blm.setLeds(_leds.array());
+    PROFILER_INTERVAL_END(uiLeds)
 
-    // update display at target fps
+    // update display at target fps, pages are only redrawn when state they draw has been invalidated
     uint32_t currentTicks = os::ticks();
     uint32_t intervalTicks = os::time::ms(1000 / _pageManager.fps());
     if (currentTicks - _lastFrameBufferUpdateTicks >= intervalTicks) {
+        PROFILER_INTERVAL_BEGIN(uiDraw)
         if (!_screensaver.shouldBeOn()) {
-            _pageManager.draw(_canvas);
-            _messageManager.update();
-            _messageManager.draw(_canvas);
+            invalidateEngineState();
+            if (_messageManager.update()) {
+                _pageManager.invalidate();
+            }
+            if (_pageManager.draw(_canvas)) {
+                _messageManager.draw(_canvas);
+            } else {
+                PROFILER_COUNTER_ADD(uiFramesRetained, 1)
+            }
             _screensaver.incScreenOnTicks(intervalTicks);
-        } else {
+        } else if (!_screensaver.isOn()) {
             _screensaver.on();
+            // redraw once the screensaver is switched off
+            _pageManager.invalidate();
         }
-        _lcd.draw(_frameBuffer.data());
+        PROFILER_INTERVAL_BEGIN(uiLcd)
+        // nothing to transfer while nothing has been drawn,
+        // only clear the dirty region once the frame has been taken by the display
+        if (!_canvas.dirtyRegion().isEmpty()) {
+            if (_lcd.draw(_frameBuffer.data(), _canvas.dirtyRegion())) {
+                _canvas.clearDirtyRegion();
+                PROFILER_COUNTER_ADD(uiLcdBytes, _lcd.frameStats().lastBytesSent)
+            } else {
+                PROFILER_COUNTER_ADD(uiLcdSkipped, 1)
+            }
+        }
+        PROFILER_INTERVAL_END(uiLcd)
         _lastFrameBufferUpdateTicks += intervalTicks;
+        PROFILER_INTERVAL_END(uiDraw)
     }
 
     intervalTicks = os::time::ms(1000 / _controllerManager.fps());
     if (currentTicks - _lastControllerUpdateTicks >= intervalTicks) {
         if (!_engine.isSuspended()) {
+            PROFILER_INTERVAL_BEGIN(uiControllers)
             _controllerManager.update();
+            PROFILER_INTERVAL_END(uiControllers)
         }
         _lastControllerUpdateTicks += intervalTicks;
     }
@@ -129,7 +159,8 @@ void Ui::showAssert(const char *filename, int line, const char *msg) {
 
     _canvas.drawText(4, 58, "PRESS ENCODER TO RESET");
 
-    _lcd.draw(_frameBuffer.data());
+    while (!_lcd.draw(_frameBuffer.data(), _canvas.dirtyRegion())) {}
+    _canvas.clearDirtyRegion();
 }
 
 void Ui::handleKeys() {
@@ -183,14 +214,58 @@ void Ui::handleEncoder() {
 }
 
 void Ui::handleMidi() {
-    while (_receiveMidiEvents.readable()) {
-        auto receiveEvent = _receiveMidiEvents.read();
-        if (!_controllerManager.recvMidi(receiveEvent.port, receiveEvent.cable, receiveEvent.message)) {
-            // only process events from cable 0
-            if (receiveEvent.cable == 0) {
-                MidiEvent midiEvent(receiveEvent.port, receiveEvent.message);
-                _pageManager.dispatchEvent(midiEvent);
+    Engine::MidiReceiveEvent receiveEvents[8];
+    size_t count;
+    while ((count = _engine.midiReceiveQueue().drain(receiveEvents, 8)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const auto &receiveEvent = receiveEvents[i];
+            if (!_controllerManager.recvMidi(receiveEvent.port, receiveEvent.cable, receiveEvent.message)) {
+                // only process events from cable 0
+                if (receiveEvent.cable == 0) {
+                    MidiEvent midiEvent(receiveEvent.port, receiveEvent.message);
+                    _pageManager.dispatchEvent(midiEvent);
+                }
+            } else {
+                // controllers edit the project and play state
+                _pageManager.invalidate();
             }
         }
     }
 }
+
+void Ui::invalidateEngineState() {
+    // engine state drawn by pages, only changes while the engine is running, monitoring or routing
+    FnvHash hash;
+    auto add = [&hash] (uint32_t value) { hash(&value, sizeof(value)); };
+
+    const auto &playState = _model.project().playState();
+    add(_engine.tick());
+    add(_engine.state().running() | (_engine.state().recording() << 1) | (_engine.isLaunchpadConnected() << 2) | (_engine.midiLearn().isActive() << 3));
+    add(uint32_t(_engine.tempo() * 10.f + 0.5f));
+    add(uint32_t(_engine.clock().activeMode()));
+    add(_engine.gateOutput() | (playState.snapshotActive() << 8) | (playState.songState().playing() << 9) | (playState.songState().currentSlot() << 16));
+    for (int i = 0; i < CONFIG_CV_OUTPUT_CHANNELS; ++i) {
+        float value = _engine.cvOutput().channel(i);
+        hash(&value, sizeof(value));
+    }
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &trackEngine = *_engine.trackEngines()[trackIndex];
+        const auto &trackState = playState.trackState(trackIndex);
+        add(trackEngine.activity() | (trackState.mute() << 1) | (trackState.requestedMute() << 2) | (trackState.fill() << 3) |
+            (trackState.fillAmount() << 8) | (trackState.pattern() << 16) | (trackState.requestedPattern() << 24));
+        float progress = trackEngine.sequenceProgress();
+        hash(&progress, sizeof(progress));
+    }
+
+    if (hash.result() != _engineStateHash) {
+        _engineStateHash = hash.result();
+        _pageManager.invalidate(Page::DrawEngine);
+    }
+
+    // routed parameters are only written when the route source changes
+    uint32_t routingEvaluated = _engine.routingEngine().stats().evaluated;
+    if (routingEvaluated != _routingEvaluated) {
+        _routingEvaluated = routingEvaluated;
+        _pageManager.invalidate(Page::DrawRouting);
+    }
+}
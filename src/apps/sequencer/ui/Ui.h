@@ -17,7 +17,6 @@
 
 #include "core/gfx/FrameBuffer.h"
 #include "core/gfx/Canvas.h"
-#include "core/utils/RingBuffer.h"
 #include "core/midi/MidiMessage.h"
 
 #include "engine/Engine.h"
@@ -41,6 +40,9 @@ private:
     void handleEncoder();
     void handleMidi();
 
+    // invalidate pages drawing engine state or routed parameters if they changed since the last frame
+    void invalidateEngineState();
+
     Model &_model;
     Engine &_engine;
 
@@ -48,17 +50,12 @@ private:
     ButtonLedMatrix &_blm;
     Encoder &_encoder;
 
-    struct ReceiveMidiEvent {
-        MidiPort port;
-        uint8_t cable;
-        MidiMessage message;
-    };
-    RingBuffer<ReceiveMidiEvent, 16> _receiveMidiEvents;
-
-    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT];
-    FrameBuffer8bit _frameBuffer;
+    uint32_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT / FrameBuffer4bit::WordPixels];
+    FrameBuffer4bit _frameBuffer;
     Canvas _canvas;
     uint32_t _lastFrameBufferUpdateTicks;
+    uint32_t _engineStateHash = 0;
+    uint32_t _routingEvaluated = 0;
 
     KeyState _pageKeyState;
     KeyState _globalKeyState;
@@ -213,9 +213,12 @@ LaunchpadController::LaunchpadController(ControllerManager &manager, Model &mode
     } else if (info.productId == 0x0051) {
         // Launchpad Pro
         _device = _deviceContainer.create<LaunchpadProDevice>();
-    } else if (info.productId == 0x0113 || info.productId == 0x0103) {
-        // Launchpad Mini Mk3 | Launchpad X
-        _device = _deviceContainer.create<LaunchpadMk3Device>();
+    } else if (info.productId == 0x0113) {
+        // Launchpad Mini Mk3
+        _device = _deviceContainer.create<LaunchpadMk3Device>(LaunchpadMk3Device::MiniMk3);
+    } else if (info.productId == 0x0103) {
+        // Launchpad X
+        _device = _deviceContainer.create<LaunchpadMk3Device>(LaunchpadMk3Device::X);
     } else if (info.productId == 0x0123) {
         // Launchpad Mk3 Pro
         _device = _deviceContainer.create<LaunchpadProMk3Device>();
@@ -1,5 +1,7 @@
 #include "LaunchpadDevice.h"
 
+#include <algorithm>
+
 //  +---+---+---+---+---+---+---+---+
 //  |104|105|106|107|108|109|110|111| < CC messages
 //  +---+---+---+---+---+---+---+---+
@@ -50,35 +52,80 @@ void LaunchpadDevice::recvMidi(uint8_t cable, const MidiMessage &message) {
 }
 
 void LaunchpadDevice::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, row * 16 + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
+    syncLeds(Cable, nullptr);
+}
+
+void LaunchpadDevice::syncLeds(uint8_t cable, const SysExLedCommand *sysEx) {
+    int changed = 0;
+    for (int index = 0; index < ButtonCount; ++index) {
+        changed += _deviceLedState[index] != _ledState[index] ? 1 : 0;
+    }
+
+    if (sysEx && changed >= SysExMinLeds && MidiMessage::maxPayloadLength() >= SysExMaxLength) {
+        if (syncLedsSysEx(cable, *sysEx)) {
+            return;
         }
+        // no payload slot available, send the remaining leds with individual messages
     }
 
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
+    // grid, scene and function leds
+    for (int index = 0; index < ButtonCount; ++index) {
         if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeNoteOn(0, col * 16 + 8, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
+            int row = index / Cols;
+            int col = index % Cols;
+            auto message = ledControlChange(row) ?
+                MidiMessage::makeControlChange(0, ledIndex(row, col), _ledState[index]) :
+                MidiMessage::makeNoteOn(0, ledIndex(row, col), _ledState[index]);
+            if (!sendMidi(cable, message)) {
+                return;
             }
+            _deviceLedState[index] = _ledState[index];
         }
     }
+}
 
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 104 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
+bool LaunchpadDevice::syncLedsSysEx(uint8_t cable, const SysExLedCommand &sysEx) {
+    const size_t HeaderLength = 6;
+    const size_t ledLength = sysEx.colorSpec ? 3 : 2;
+
+    uint8_t data[SysExMaxLength] = { 0x00, 0x20, 0x29, 0x02, sysEx.model, sysEx.command };
+    size_t length = HeaderLength;
+    int begin = 0;
+    for (int index = 0; index < ButtonCount; ++index) {
+        if (_deviceLedState[index] == _ledState[index]) {
+            continue;
+        }
+        if (length + ledLength > SysExMaxLength) {
+            auto message = MidiMessage::makeSystemExclusive(data, length);
+            if (!message.hasPayload()) {
+                return false;
+            }
+            if (!sendLedsSysEx(cable, message, begin, index)) {
+                return true;
             }
+            length = HeaderLength;
+            begin = index;
+        }
+        if (sysEx.colorSpec) {
+            data[length++] = 0;
+        }
+        data[length++] = ledIndex(index / Cols, index % Cols);
+        data[length++] = _ledState[index];
+    }
+    if (length > HeaderLength) {
+        auto message = MidiMessage::makeSystemExclusive(data, length);
+        if (!message.hasPayload()) {
+            return false;
         }
+        sendLedsSysEx(cable, message, begin, ButtonCount);
+    }
+    return true;
+}
+
+bool LaunchpadDevice::sendLedsSysEx(uint8_t cable, const MidiMessage &message, int begin, int end) {
+    if (!sendMidi(cable, message)) {
+        return false;
     }
+    std::copy(_ledState.begin() + begin, _ledState.begin() + end, _deviceLedState.begin() + begin);
+    return true;
 }
@@ -81,6 +81,39 @@ public:
 protected:
     static constexpr uint8_t Cable = 0;
 
+    // "set leds" sysex message: 00 20 29 02 <model> <command> followed by [<type>] <index> <color> for each led
+    struct SysExLedCommand {
+        uint8_t model;
+        uint8_t command;
+        bool colorSpec;             // leds are prefixed with a lighting type (static color)
+    };
+
+    // changed leds are sent in bulk with sysex messages if at least this many leds changed,
+    // fewer leds are sent with individual messages which is less data
+    static constexpr int SysExMinLeds = 8;
+    // sysex payload limit, a message fits into a single full speed usb packet (16 usb midi events),
+    // larger messages are split across packets by the usb host driver
+    static constexpr int SysExMaxLength = 46;
+
+    // led index used in note on, control change and sysex messages
+    virtual uint8_t ledIndex(int row, int col) const {
+        if (row == SceneRow) {
+            return col * 16 + 8;
+        } else if (row == FunctionRow) {
+            return 104 + col;
+        }
+        return row * 16 + col;
+    }
+
+    // leds set with control change instead of note on messages
+    virtual bool ledControlChange(int row) const {
+        return row == FunctionRow;
+    }
+
+    // sends changed leds, in bulk with sysex messages if supported by the device (sysEx != nullptr) and payload slots
+    // are available, stops when messages cannot be queued, the remaining leds are sent with the next sync
+    void syncLeds(uint8_t cable, const SysExLedCommand *sysEx);
+
     bool sendMidi(uint8_t cable, const MidiMessage &message) {
         if (_sendMidiHandler) {
             return _sendMidiHandler(cable, message);
@@ -100,4 +133,9 @@ protected:
     std::bitset<ButtonCount> _buttonState;
     std::array<uint8_t, ButtonCount> _ledState;
     std::array<uint8_t, ButtonCount> _deviceLedState;
+
+private:
+    // returns false if a payload cannot be allocated (all payload slots are queued for transmission)
+    bool syncLedsSysEx(uint8_t cable, const SysExLedCommand &sysEx);
+    bool sendLedsSysEx(uint8_t cable, const MidiMessage &message, int begin, int end);
 };
@@ -25,6 +25,16 @@ public:
 
     void syncLeds() override;
 
+protected:
+    uint8_t ledIndex(int row, int col) const override {
+        if (row == SceneRow) {
+            return 11 + 10 * (7 - col) + 8;
+        } else if (row == FunctionRow) {
+            return 104 + col;
+        }
+        return 11 + 10 * (7 - row) + col;
+    }
+
 private:
     static constexpr uint8_t Cable = 0;
 
@@ -22,17 +22,18 @@
 //  | 11|...|   |   |   |   |   | 18|  | 19|
 //  +---+---+---+---+---+---+---+---+  +---+
 
-LaunchpadMk3Device::LaunchpadMk3Device() :
-    LaunchpadDevice()
+LaunchpadMk3Device::LaunchpadMk3Device(Model model) :
+    LaunchpadDevice(),
+    _model(model)
 {
 }
 
 void LaunchpadMk3Device::initialize() {
    // send sysex message to enter daw mode (to cancel midi messages on the daw port)
-   std::array<uint8_t, 7> payloadDM { 0x00, 0x20, 0x29, 0x02, 0x0d, 0x10, 0x01 };
+   std::array<uint8_t, 7> payloadDM { 0x00, 0x20, 0x29, 0x02, _model, 0x10, 0x01 };
    sendMidi(Cable, MidiMessage::makeSystemExclusive(payloadDM.data(), payloadDM.size()));
    // send sysex message to enter programmer mode
-   std::array<uint8_t, 7> payloadPM { 0x00, 0x20, 0x29, 0x02, 0x0d, 0x0e, 0x01 };
+   std::array<uint8_t, 7> payloadPM { 0x00, 0x20, 0x29, 0x02, _model, 0x0e, 0x01 };
    sendMidi(Cable, MidiMessage::makeSystemExclusive(payloadPM.data(), payloadPM.size()));
 }
 
@@ -57,35 +58,6 @@ void LaunchpadMk3Device::recvMidi(uint8_t cable, const MidiMessage &message) {
 }
 
 void LaunchpadMk3Device::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - row) + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
-        }
-    }
-
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 19 + 10 * (7 - col), _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
-
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 91 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
+    const SysExLedCommand sysEx = { _model, 0x03, true };
+    LaunchpadDevice::syncLeds(Cable, &sysEx);
 }
@@ -7,7 +7,13 @@
 // Compatible with Launchpad Mini Mk3 and Launchpad X
 class LaunchpadMk3Device : public LaunchpadDevice {
 public:
-    LaunchpadMk3Device();
+    // device id used in sysex messages
+    enum Model : uint8_t {
+        MiniMk3 = 0x0d,
+        X = 0x0c,
+    };
+
+    LaunchpadMk3Device(Model model);
 
     void initialize() override;
 
@@ -27,9 +33,25 @@ public:
 
     void syncLeds() override;
 
+protected:
+    uint8_t ledIndex(int row, int col) const override {
+        if (row == SceneRow) {
+            return 19 + 10 * (7 - col);
+        } else if (row == FunctionRow) {
+            return 91 + col;
+        }
+        return 11 + 10 * (7 - row) + col;
+    }
+
+    bool ledControlChange(int row) const override {
+        return row == SceneRow || row == FunctionRow;
+    }
+
 private:
     static constexpr uint8_t Cable = 1;
 
+    Model _model;
+
     inline uint8_t mapColor(int red, int green, int style) const {
         static const uint8_t map[] = {
         //  g0 g1 g2 g3
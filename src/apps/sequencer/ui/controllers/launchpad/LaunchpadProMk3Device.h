@@ -27,6 +27,20 @@ public:
 
     void syncLeds() override;
 
+protected:
+    uint8_t ledIndex(int row, int col) const override {
+        if (row == SceneRow) {
+            return 11 + 10 * (7 - col) + 8;
+        } else if (row == FunctionRow) {
+            return 91 + col;
+        }
+        return 11 + 10 * (7 - row) + col;
+    }
+
+    bool ledControlChange(int row) const override {
+        return row == SceneRow || row == FunctionRow;
+    }
+
 private:
     static constexpr uint8_t Cable = 0;
 
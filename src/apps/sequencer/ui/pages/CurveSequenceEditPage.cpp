@@ -49,22 +49,24 @@ static const CurveSequenceListModel::Item quickEditItems[8] = {
     CurveSequenceListModel::Item::Last
 };
 
-static void drawCurve(Canvas &canvas, int x, int y, int w, int h, float &lastY, const Curve::Function function, float min, float max) {
-    const int Step = 1;
+static void drawCurve(Canvas &canvas, int x, int y, int w, int h, float &lastY, Curve::Type type, float min, float max) {
+    const int MaxWidth = 32;
 
-    auto eval = [=] (float x) {
-        return (1.f - (function(x) * (max - min) + min)) * h;
-    };
+    w = std::min(w, MaxWidth);
 
-    float fy0 = y + eval(0.f);
+    // render the step once into screen coordinates, one value per pixel boundary
+    float values[MaxWidth + 1];
+    Curve::render(type, values, w + 1, y + (1.f - min) * h, y + (1.f - max) * h);
+
+    float fy0 = values[0];
 
     if (lastY >= 0.f && lastY != fy0) {
         canvas.line(x, lastY, x, fy0);
     }
 
-    for (int i = 0; i < w; i += Step) {
-        float fy1 = y + eval((float(i) + Step) / w);
-        canvas.line(x + i, fy0, x + i + Step, fy1);
+    for (int i = 0; i < w; ++i) {
+        float fy1 = values[i + 1];
+        canvas.line(x + i, fy0, x + i + 1, fy1);
         fy0 = fy1;
     }
 
@@ -212,21 +214,21 @@ void CurveSequenceEditPage::draw(Canvas &canvas) {
 
         // curve
         {
-            const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shape())));
+            auto type = Curve::Type(std::min(Curve::Last - 1, step.shape()));
 
             canvas.setColor(drawShapeVariation ? Color::MediumLow : Color::Bright);
             canvas.setBlendMode(BlendMode::Add);
 
-            drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastY, function, min, max);
+            drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastY, type, min, max);
         }
 
         if (drawShapeVariation) {
-            const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shapeVariation())));
+            auto type = Curve::Type(std::min(Curve::Last - 1, step.shapeVariation()));
 
             canvas.setColor(Color::Bright);
             canvas.setBlendMode(BlendMode::Add);
 
-            drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastYVariation, function, min, max);
+            drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastYVariation, type, min, max);
         }
 
         switch (layer()) {
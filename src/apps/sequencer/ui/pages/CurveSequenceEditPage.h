@@ -17,6 +17,9 @@ public:
     virtual void exit() override;
 
     virtual void draw(Canvas &canvas) override;
+    virtual uint8_t drawDependencies() const override {
+        return _stepSelection.any() ? DrawAlways : DrawProject | DrawEngine | DrawRouting;
+    }
     virtual void updateLeds(Leds &leds) override;
 
     virtual void keyDown(KeyEvent &event) override;
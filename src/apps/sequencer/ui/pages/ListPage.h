@@ -16,6 +16,7 @@ public:
     virtual void exit() override;
 
     virtual void draw(Canvas &canvas) override;
+    virtual uint8_t drawDependencies() const override { return DrawProject | DrawEngine | DrawRouting; }
     virtual void updateLeds(Leds &leds) override;
 
     virtual void keyPress(KeyPressEvent &event) override;
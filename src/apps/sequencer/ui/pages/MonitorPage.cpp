@@ -5,16 +5,20 @@
 #include "engine/CvInput.h"
 #include "engine/CvOutput.h"
 
+#include "core/profiler/Profiler.h"
 #include "core/utils/StringBuilder.h"
 
+#include <algorithm>
+
 enum class Function {
     CvIn    = 0,
     CvOut   = 1,
     Midi    = 2,
     Stats   = 3,
+    Profiler= 4,
 };
 
-static const char *functionNames[] = { "CV IN", "CV OUT", "MIDI", "STATS", nullptr };
+static const char *functionNames[] = { "CV IN", "CV OUT", "MIDI", "STATS", "PROFILER" };
 
 static void formatMidiMessage(StringBuilder &eventStr, StringBuilder &dataStr, const MidiMessage &msg) {
     if (msg.isChannelMessage()) {
@@ -107,6 +111,9 @@ void MonitorPage::draw(Canvas &canvas) {
     case Mode::Stats:
         drawStats(canvas);
         break;
+    case Mode::Profiler:
+        drawProfiler(canvas);
+        break;
     }
 }
 
@@ -134,11 +141,21 @@ void MonitorPage::keyPress(KeyPressEvent &event) {
         case Function::Stats:
             _mode = Mode::Stats;
             break;
+        case Function::Profiler:
+            // pressing again resets the profiler statistics
+            if (_mode == Mode::Profiler) {
+                Profiler::reset();
+            }
+            _mode = Mode::Profiler;
+            break;
         }
     }
 }
 
 void MonitorPage::encoder(EncoderEvent &event) {
+    if (_mode == Mode::Profiler) {
+        _profilerScroll = std::max(0, _profilerScroll + event.value());
+    }
 }
 
 void MonitorPage::midi(MidiEvent &event) {
@@ -215,14 +232,45 @@ void MonitorPage::drawStats(Canvas &canvas) {
         drawValue(0, "UPTIME:", str);
     }
 
-    {
-        FixedStringBuilder<16> str("%d", stats.midiRxOverflow);
-        drawValue(1, "MIDI OVF:", str);
-    }
+    auto drawQueueStats = [&] (int index, const char *name, const Engine::MidiQueueStats &queueStats) {
+        FixedStringBuilder<24> str("MAX %d OVF %d", queueStats.highWaterMark, queueStats.overflow);
+        drawValue(index, name, str);
+    };
+
+    drawQueueStats(1, "MIDI RX:", stats.midiRx);
+    drawQueueStats(2, "USBMIDI RX:", stats.usbMidiRx);
+    drawQueueStats(3, "UI MIDI:", stats.uiMidi);
 
     {
-        FixedStringBuilder<16> str("%d", stats.usbMidiRxOverflow);
-        drawValue(2, "USBMIDI OVF:", str);
+        FixedStringBuilder<16> str("%d", stats.eventOverflow);
+        drawValue(4, "EVENT OVF:", str);
     }
 
 }
+
+void MonitorPage::drawProfiler(Canvas &canvas) {
+#if CONFIG_ENABLE_PROFILER
+    const int Rows = 5;
+    _profilerScroll = std::min(_profilerScroll, std::max(0, Profiler::intervalCount() - Rows));
+
+    int index = 0;
+    Profiler::forEachInterval([&] (const Profiler::Interval &interval) {
+        int row = index++ - _profilerScroll;
+        Profiler::IntervalSnapshot snapshot;
+        if (row < 0 || row >= Rows || !interval.snapshot(snapshot)) {
+            return;
+        }
+        int y = 20 + row * 8;
+        canvas.drawText(10, y, snapshot.desc);
+        FixedStringBuilder<24> str("%d/%d US", int(snapshot.mean), int(snapshot.max));
+        canvas.drawText(120, y, str);
+        if (snapshot.budget > 0) {
+            str.reset();
+            str("%d%%", int(snapshot.meanUtilization()));
+            canvas.drawText(200, y, str);
+        }
+    });
+#else // CONFIG_ENABLE_PROFILER
+    canvas.drawTextCentered(0, 32 - 8, Width, 16, "PROFILER DISABLED");
+#endif // CONFIG_ENABLE_PROFILER
+}
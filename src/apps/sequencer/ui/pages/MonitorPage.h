@@ -25,15 +25,18 @@ private:
     void drawCvOut(Canvas &canvas);
     void drawMidi(Canvas &canvas);
     void drawStats(Canvas &canvas);
+    void drawProfiler(Canvas &canvas);
 
     enum class Mode : uint8_t {
         CvIn,
         CvOut,
         Midi,
         Stats,
+        Profiler,
     };
 
     Mode _mode = Mode::CvIn;
+    int _profilerScroll = 0;
     MidiMessage _lastMidiMessage;
     MidiPort _lastMidiMessagePort;
     uint32_t _lastMidiMessageTicks = -1;
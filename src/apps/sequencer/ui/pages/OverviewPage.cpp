@@ -121,22 +121,24 @@ static void drawLogicTrack(Canvas &canvas, int trackIndex, const LogicTrackEngin
     }
 }
 
-static void drawCurve(Canvas &canvas, int x, int y, int w, int h, float &lastY, const Curve::Function function, float min, float max) {
-    const int Step = 1;
+static void drawCurve(Canvas &canvas, int x, int y, int w, int h, float &lastY, Curve::Type type, float min, float max) {
+    const int MaxWidth = 32;
 
-    auto eval = [=] (float x) {
-        return (1.f - (function(x) * (max - min) + min)) * h;
-    };
+    w = std::min(w, MaxWidth);
 
-    float fy0 = y + eval(0.f);
+    // render the step once into screen coordinates, one value per pixel boundary
+    float values[MaxWidth + 1];
+    Curve::render(type, values, w + 1, y + (1.f - min) * h, y + (1.f - max) * h);
+
+    float fy0 = values[0];
 
     if (lastY >= 0.f && lastY != fy0) {
         canvas.line(x, lastY, x, fy0);
     }
 
-    for (int i = 0; i < w; i += Step) {
-        float fy1 = y + eval((float(i) + Step) / w);
-        canvas.line(x + i, fy0, x + i + Step, fy1);
+    for (int i = 0; i < w; ++i) {
+        float fy1 = values[i + 1];
+        canvas.line(x + i, fy0, x + i + 1, fy1);
         fy0 = fy1;
     }
 
@@ -223,11 +225,11 @@ static void drawCurveTrack(Canvas &canvas, int trackIndex, const CurveTrackEngin
         const auto &step = sequence.step(stepIndex);
         float min = step.minNormalized();
         float max = step.maxNormalized();
-        const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shape())));
+        auto type = Curve::Type(std::min(Curve::Last - 1, step.shape()));
 
         int x = 76 + i * 8;
 
-        drawCurve(canvas, x, y + 1, 8, 6, lastY, function, min, max);
+        drawCurve(canvas, x, y + 1, 8, 6, lastY, type, min, max);
     }
 
     if (trackEngine.currentStep() >= 0 && trackEngine.currentStep() < 16+(16*sequence.section())) {
@@ -984,8 +986,8 @@ void OverviewPage::drawCurveDetail(Canvas &canvas, const CurveSequence::Step &st
             float min = step.minNormalized();
             float max = step.maxNormalized();
             float lastY = -1.f;
-            const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shape())));
-            drawCurve(canvas, 64 + 64, 24 + 1, 18, 12, lastY, function, min, max);
+            auto type = Curve::Type(std::min(Curve::Last - 1, step.shape()));
+            drawCurve(canvas, 64 + 64, 24 + 1, 18, 12, lastY, type, min, max);
         }
             break;
         case CurveSequence::Layer::Min: {
@@ -16,6 +16,10 @@ public:
     virtual void exit() override;
 
     virtual void draw(Canvas &canvas) override;
+    // step details are shown for a while after selecting steps
+    virtual uint8_t drawDependencies() const override {
+        return _stepSelection.any() ? DrawAlways : DrawProject | DrawEngine | DrawRouting;
+    }
     virtual void updateLeds(Leds &leds) override;
 
     virtual void keyDown(KeyEvent &event) override;
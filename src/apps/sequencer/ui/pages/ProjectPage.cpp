@@ -196,11 +196,17 @@ void ProjectPage::initRoute() {
 }
 
 void ProjectPage::saveProjectToSlot(int slot) {
-    _engine.suspend();
+    // the engine keeps running while saving, it is only locked while the project is copied to the staging buffer
     _manager.pages().busy.show("SAVING PROJECT ...");
 
     FileManager::task([this, slot] () {
-        return FileManager::writeProject(_project, slot);
+        return FileManager::writeProject(_project, slot, [this] (bool lock) {
+            if (lock) {
+                _engine.lock();
+            } else {
+                _engine.unlock();
+            }
+        });
     }, [this] (fs::Error result) {
         if (result == fs::OK) {
             showMessage("PROJECT SAVED");
@@ -209,7 +215,6 @@ void ProjectPage::saveProjectToSlot(int slot) {
         }
         // TODO lock ui mutex
         _manager.pages().busy.close();
-        _engine.resume();
     });
 }
 
@@ -992,13 +992,13 @@ void StochasticSequenceEditPage::copySequence() {
     
 
     if (_project.selectedStochasticSequence().useLoop()) {
-        auto lockedSteps = _engine.selectedTrackEngine().as<StochasticEngine>().lockedSteps();
+        const auto &lockedSteps = _engine.selectedTrackEngine().as<StochasticEngine>().lockedSteps();
 
         const auto &scale = _project.selectedStochasticSequence().selectedScale(_model.project().scale());
 
         auto sequence = NoteSequence();
         for (int i=0; i<int(lockedSteps.size()); ++i) {
-            auto lockedStep = lockedSteps.at(i);
+            const auto &lockedStep = lockedSteps[i];
             auto &step = sequence.step(i);
             step.setGate(lockedStep.gate());
             step.setGateProbability(lockedStep.step().gateProbability());
@@ -17,6 +17,7 @@ void TopPage::init() {
 
     _context.model.project().watch([this] (Project::Event event) {
         auto &pages = _manager.pages();
+        _manager.invalidate(DrawProject);
         switch (event) {
         case Project::Event::ProjectCleared:
         case Project::Event::ProjectRead:
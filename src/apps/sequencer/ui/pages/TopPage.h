@@ -37,6 +37,8 @@ public:
 
     void editRoute(Routing::Target target, int trackIndex);
 
+    // top page does not draw
+    virtual uint8_t drawDependencies() const override { return 0; }
     virtual void updateLeds(Leds &leds) override;
 
     virtual void keyDown(KeyEvent &event) override;
@@ -15,6 +15,7 @@ public:
         Read,
         Write,
         Append,
+        ReadWrite,
     };
 
     File() = default;
@@ -34,6 +35,7 @@ public:
         case Read:      _error = Error(f_open(_file, path, FA_READ)); break;
         case Write:     _error = Error(f_open(_file, path, FA_WRITE | FA_CREATE_ALWAYS)); break;
         case Append:    _error = Error(f_open(_file, path, FA_WRITE | FA_OPEN_APPEND)); break;
+        case ReadWrite: _error = Error(f_open(_file, path, FA_READ | FA_WRITE)); break;
         default:        _error = INVALID_PARAMETER;
         }
         return _error;
@@ -93,6 +95,12 @@ public:
         return _error;
     }
 
+    // allocate a contiguous block of clusters for an empty file opened for writing, sets the file size
+    Error expand(size_t size) {
+        _error = Error(f_expand(_file, size, 1));
+        return _error;
+    }
+
     Error truncate() {
         _error = Error(f_truncate(_file));
         return _error;
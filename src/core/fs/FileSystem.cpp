@@ -5,11 +5,14 @@
 
 #include "os/os.h"
 
+#include <algorithm>
+
 
 namespace fs {
 
 static Volume *g_volume;
 static SdCard *g_sdCard;
+static IoStats g_ioStats;
 
 void setVolume(Volume *volume) {
     ASSERT(volume == nullptr || g_volume == nullptr, "only one volume allowed");
@@ -46,6 +49,14 @@ bool exists(const char *path) {
     return stat(path, info) == OK;
 }
 
+const IoStats &ioStats() {
+    return g_ioStats;
+}
+
+void resetIoStats() {
+    g_ioStats = IoStats();
+}
+
 } // namespace fs
 
 
@@ -72,13 +83,36 @@ DSTATUS disk_status(BYTE pdrv) {
 DRESULT disk_read(BYTE pdrv, BYTE *buf, DWORD sector, UINT count) {
     ASSERT(pdrv == 0, "only one physical drive available");
     // DBG("disk_read(pdrv=%d,sector=%d,count=%d)", pdrv, sector, count);
-    return fs::g_sdCard->read(buf, sector, count) ? RES_OK : RES_ERROR;
+    // multiple sectors are passed to the block device at once (limited by its 8 bit sector count)
+    while (count > 0) {
+        UINT chunk = std::min(count, UINT(255));
+        ++fs::g_ioStats.readCalls;
+        fs::g_ioStats.sectorsRead += chunk;
+        if (!fs::g_sdCard->read(buf, sector, chunk)) {
+            return RES_ERROR;
+        }
+        buf += chunk * FF_MAX_SS;
+        sector += chunk;
+        count -= chunk;
+    }
+    return RES_OK;
 }
 
 DRESULT disk_write(BYTE pdrv, const BYTE *buf, DWORD sector, UINT count) {
     ASSERT(pdrv == 0, "only one physical drive available");
     // DBG("disk_write(pdrv=%d,sector=%d,count=%d)", pdrv, sector, count);
-    return fs::g_sdCard->write(buf, sector, count) ? RES_OK : RES_ERROR;
+    while (count > 0) {
+        UINT chunk = std::min(count, UINT(255));
+        ++fs::g_ioStats.writeCalls;
+        fs::g_ioStats.sectorsWritten += chunk;
+        if (!fs::g_sdCard->write(buf, sector, chunk)) {
+            return RES_ERROR;
+        }
+        buf += chunk * FF_MAX_SS;
+        sector += chunk;
+        count -= chunk;
+    }
+    return RES_OK;
 }
 
 DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buf) {
@@ -86,6 +120,7 @@ DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buf) {
     // DBG("disk_ioctl(pdrv=%d,cmd=%d)", pdrv, cmd);
     switch (cmd) {
     case CTRL_SYNC:
+        ++fs::g_ioStats.syncCalls;
         fs::g_sdCard->sync();
         return RES_OK;
     case GET_SECTOR_COUNT:
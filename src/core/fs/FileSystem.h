@@ -20,4 +20,16 @@ Error rename(const char *oldPath, const char *newPath);
 
 bool exists(const char *path);
 
+// block device access statistics
+struct IoStats {
+    uint32_t readCalls;
+    uint32_t writeCalls;
+    uint32_t syncCalls;
+    uint32_t sectorsRead;
+    uint32_t sectorsWritten;
+};
+
+const IoStats &ioStats();
+void resetIoStats();
+
 } // namespace fs
@@ -2,6 +2,8 @@
 
 #include "File.h"
 
+#include "core/Debug.h"
+
 #include <algorithm>
 
 #include <cstring>
@@ -13,10 +15,24 @@ namespace fs {
 /**
  * File writer.
  * Buffers writes to increase throughput and keeps track of potential errors, which are returned when calling finish().
+ * Data is passed to the file system in multiples of the sector size, which allows the file system to write multiple
+ * sectors at once to the block device. Larger buffers can be provided by the caller (must be word aligned and a
+ * multiple of the sector size). Word aligned data that spans whole buffers is written without copying.
  */
 class FileWriter {
 public:
-    FileWriter(const char *path) {
+    static constexpr size_t SectorSize = 512;
+
+    FileWriter(const char *path) :
+        FileWriter(path, _defaultBuffer, sizeof(_defaultBuffer))
+    {}
+
+    FileWriter(const char *path, void *buffer, size_t bufferSize) :
+        _buffer(static_cast<uint8_t *>(buffer)),
+        _bufferSize(bufferSize)
+    {
+        ASSERT(bufferSize >= SectorSize && bufferSize % SectorSize == 0, "buffer must be a multiple of the sector size");
+        ASSERT(reinterpret_cast<uintptr_t>(buffer) % 4 == 0, "buffer must be word aligned");
         _error = _file.open(path, File::Write);
     }
 
@@ -26,11 +42,25 @@ public:
 
     Error error() const { return _error; }
 
+    // allocate contiguous clusters for the expected file size before writing, the file is truncated to the written
+    // size when finishing. Failing to preallocate (e.g. no contiguous free space) is not an error for the writer.
+    Error preallocate(size_t size) {
+        if (_error != OK) {
+            return _error;
+        }
+        Error result = _file.expand(size);
+        _preallocated = result == OK;
+        return result;
+    }
+
     Error finish() {
         if (!_finished) {
             if (_error == OK) {
                 _error = _file.writeAll(_buffer, _pos);
             }
+            if (_error == OK && _preallocated) {
+                _error = _file.truncate();
+            }
             if (_error == OK) {
                 _error = _file.close();
             } else {
@@ -43,29 +73,36 @@ public:
 
     Error write(const void *data, size_t len) {
         const uint8_t *src = static_cast<const uint8_t *>(data);
-        uint8_t *buffer = reinterpret_cast<uint8_t *>(_buffer);
         while (_error == OK && len > 0) {
-            size_t chunk = std::min(len, BufferSize - _pos);
-            memcpy(&buffer[_pos], src, chunk);
+            if (_pos == 0 && len >= _bufferSize && reinterpret_cast<uintptr_t>(src) % 4 == 0) {
+                size_t chunk = len - len % SectorSize;
+                _error = _file.writeAll(src, chunk);
+                src += chunk;
+                len -= chunk;
+                continue;
+            }
+            size_t chunk = std::min(len, _bufferSize - _pos);
+            memcpy(&_buffer[_pos], src, chunk);
             _pos += chunk;
             src += chunk;
             len -= chunk;
-            if (_pos == BufferSize) {
+            if (_pos == _bufferSize) {
                 _pos = 0;
-                _error = _file.writeAll(buffer, BufferSize);
+                _error = _file.writeAll(_buffer, _bufferSize);
             }
         }
         return _error;
     }
 
 private:
-    static constexpr size_t BufferSize = 512;
-
     File _file;
     bool _finished = false;
+    bool _preallocated = false;
     Error _error;
-    uint32_t _buffer[BufferSize / 4];
+    uint8_t *_buffer;
+    size_t _bufferSize;
     size_t _pos = 0;
+    uint32_t _defaultBuffer[SectorSize / 4];
 };
 
 } // namespace fs
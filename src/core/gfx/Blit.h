@@ -1,23 +1,67 @@
 #pragma once
 
+#include <algorithm>
+
 #include <cstdint>
 
+// Blend operations on 4 bit pixels, results are saturated to 0..15.
+// pixel() blends a single pixel, word() blends 8 pixels packed into a 32 bit word with the color replicated to all
+// nibbles. Word operations split the word into two sets of 4 pixels, each stored in the high nibbles of the bytes,
+// which are blended using saturating byte arithmetic (UQADD8/UQSUB8 on Cortex-M4).
 namespace blit {
+
+    // saturating add of 4 values stored in the high nibbles of each byte (low nibbles are zero)
+    static inline uint32_t addHighNibbles(uint32_t a, uint32_t b) {
+#ifdef PLATFORM_STM32
+        uint32_t result;
+        __asm__ ("uqadd8 %0, %1, %2" : "=r" (result) : "r" (a), "r" (b));
+        return result & 0xf0f0f0f0;
+#else
+        // sums of 4 bit values fit into 5 bits, overflows are saturated through bit 4
+        uint32_t sum = (a >> 4) + (b >> 4);
+        uint32_t overflow = (sum & 0x10101010) >> 4;
+        return ((sum | (overflow * 0xf)) & 0x0f0f0f0f) << 4;
+#endif
+    }
+
+    // saturating subtract of 4 values stored in the high nibbles of each byte (low nibbles are zero)
+    static inline uint32_t subHighNibbles(uint32_t a, uint32_t b) {
+#ifdef PLATFORM_STM32
+        uint32_t result;
+        __asm__ ("uqsub8 %0, %1, %2" : "=r" (result) : "r" (a), "r" (b));
+        return result;
+#else
+        // bit 4 guards against borrowing from the next byte and stays set if there was no underflow
+        uint32_t diff = ((a >> 4) | 0x10101010) - (b >> 4);
+        uint32_t keep = (diff & 0x10101010) >> 4;
+        return (diff & (keep * 0xf)) << 4;
+#endif
+    }
+
     struct set {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            frameBuffer(x, y) = color;
+        static uint8_t pixel(uint8_t dst, uint8_t color) {
+            return color;
+        }
+        static uint32_t word(uint32_t dst, uint32_t color) {
+            return color;
         }
     };
     struct add {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::min(0xff, int(frameBuffer(x, y)) + color);
-            frameBuffer(x, y) += color;
+        static uint8_t pixel(uint8_t dst, uint8_t color) {
+            return std::min(15, dst + color);
+        }
+        static uint32_t word(uint32_t dst, uint32_t color) {
+            color &= 0xf0f0f0f0;
+            return addHighNibbles(dst & 0xf0f0f0f0, color) | (addHighNibbles((dst << 4) & 0xf0f0f0f0, color) >> 4);
         }
     };
     struct sub {
-        void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
-            // frameBuffer(x, y) = std::max(0x00, int(frameBuffer(x, y)) - color);
-            frameBuffer(x, y) -= std::min(frameBuffer(x, y), color);
+        static uint8_t pixel(uint8_t dst, uint8_t color) {
+            return dst - std::min(dst, color);
+        }
+        static uint32_t word(uint32_t dst, uint32_t color) {
+            color &= 0xf0f0f0f0;
+            return subHighNibbles(dst & 0xf0f0f0f0, color) | (subHighNibbles((dst << 4) & 0xf0f0f0f0, color) >> 4);
         }
     };
 };
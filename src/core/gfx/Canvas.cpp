@@ -1,5 +1,4 @@
 #include "Canvas.h"
-#include "Blit.h"
 
 #include <stdio.h>
 
@@ -33,11 +32,13 @@ static const int bitmapFontOffset(Font font) {
 
 
 void Canvas::fill() {
-    _frameBuffer.fill(_color);
+    _frameBuffer.fill(clampColor(_color));
+    markDirty(0, 0, _right, _bottom);
 }
 
 void Canvas::screensaver() {
     _frameBuffer.fill(0x0);
+    markDirty(0, 0, _right, _bottom);
 }
 
 void Canvas::point(int x, int y) {
@@ -90,9 +91,9 @@ void Canvas::fillRect(int x, int y, int w, int h) {
 
 void Canvas::drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap) {
     switch (_blendMode) {
-    case BlendMode::Set: drawBitmap<blit::set, 1>(x, y, w, h, bitmap); break;
-    case BlendMode::Add: drawBitmap<blit::add, 1>(x, y, w, h, bitmap); break;
-    case BlendMode::Sub: drawBitmap<blit::sub, 1>(x, y, w, h, bitmap); break;
+    case BlendMode::Set: drawBitmap1bit<blit::set>(x, y, w, h, bitmap); break;
+    case BlendMode::Add: drawBitmap1bit<blit::add>(x, y, w, h, bitmap); break;
+    case BlendMode::Sub: drawBitmap1bit<blit::sub>(x, y, w, h, bitmap); break;
     }
 }
 
@@ -107,6 +108,11 @@ void Canvas::drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap) {
 void Canvas::drawText(int x, int y, const char *str) {
     const auto &font = bitmapFont(_font);
 
+    if (auto run = _textRunCache.lookup(font, str)) {
+        drawTextRun(x, y, *run);
+        return;
+    }
+
     int ox = x;
     while (*str != '\0') {
         auto c = *str++;
@@ -135,14 +141,17 @@ void Canvas::drawTextCentered(int x, int y, int w, int h, const char *str) {
 void Canvas::drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizontalAlign, VerticalAlign verticalAlign, const char *str) {
     // drawRect(x, y, w, h);
 
+    // measure and draw the string from the same text run
+    auto run = _textRunCache.lookup(bitmapFont(_font), str);
+
     switch (horizontalAlign) {
     case HorizontalAlign::Left:
         break;
     case HorizontalAlign::Right:
-        x += w - textWidth(str);
+        x += w - (run ? run->width : textWidth(str));
         break;
     case HorizontalAlign::Center:
-        x += (w - textWidth(str) + 1) / 2;
+        x += (w - (run ? run->width : textWidth(str)) + 1) / 2;
         break;
     }
 
@@ -158,7 +167,11 @@ void Canvas::drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizon
     }
     y += bitmapFontOffset(_font);
 
-    drawText(x, y, str);
+    if (run) {
+        drawTextRun(x, y, *run);
+    } else {
+        drawText(x, y, str);
+    }
 }
 
 void Canvas::drawTextMultiline(int x, int y, int w, const char *str) {
@@ -193,6 +206,11 @@ void Canvas::drawTextMultiline(int x, int y, int w, const char *str) {
 
 int Canvas::textWidth(const char *str) {
     const auto &font = bitmapFont(_font);
+
+    if (auto run = _textRunCache.find(font, str)) {
+        return run->width;
+    }
+
     int width = 0;
 
     while (*str != '\0') {
@@ -207,6 +225,14 @@ int Canvas::textWidth(const char *str) {
     return width;
 }
 
+void Canvas::drawTextRun(int x, int y, const TextRunCache::Run &run) {
+    switch (_blendMode) {
+    case BlendMode::Set: drawTextRun<blit::set>(x, y, run); break;
+    case BlendMode::Add: drawTextRun<blit::add>(x, y, run); break;
+    case BlendMode::Sub: drawTextRun<blit::sub>(x, y, run); break;
+    }
+}
+
 int Canvas::textHeight(const char *str) {
     const auto &font = bitmapFont(_font);
     int height = bitmapFontHeight(_font);
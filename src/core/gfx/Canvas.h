@@ -1,6 +1,9 @@
 #pragma once
 
 #include "FrameBuffer.h"
+#include "DirtyRegion.h"
+#include "Blit.h"
+#include "TextRunCache.h"
 
 #include <algorithm>
 
@@ -42,7 +45,7 @@ enum class VerticalAlign {
 
 class Canvas {
 public:
-    Canvas(FrameBuffer8bit &frameBuffer, float &brightness) :
+    Canvas(FrameBuffer4bit &frameBuffer, float &brightness) :
         _frameBuffer(frameBuffer),
         _right(frameBuffer.width() - 1),
         _bottom(frameBuffer.height() - 1),
@@ -84,8 +87,16 @@ public:
     int textWidth(const char *str);
     int textHeight(const char *str);
 
+    // repeatedly drawn strings are drawn from cached text runs
+    const TextRunCache &textRunCache() const { return _textRunCache; }
+
+    // bounding box of all pixels drawn since the region was last cleared
+    const DirtyRegion &dirtyRegion() const { return _dirtyRegion; }
+    void clearDirtyRegion() { _dirtyRegion.clear(); }
 
 private:
+    void drawTextRun(int x, int y, const TextRunCache::Run &run);
+
     void hclip(int &x) {
         x = std::max(0, std::min(_right, x));
     }
@@ -111,47 +122,103 @@ private:
         return hinside(x) && vinside(y);
     }
 
+    // pixels are blended with the color clamped to 4 bit
+    static uint32_t clampColor(uint8_t color) {
+        return std::min(color, uint8_t(15));
+    }
+
+    template<typename Blit>
+    void blitPixel(int x, int y, uint8_t color) {
+        uint32_t &word = _frameBuffer.row(y)[x / FrameBuffer4bit::WordPixels];
+        int shift = FrameBuffer4bit::pixelShift(x);
+        uint32_t pixel = Blit::pixel((word >> shift) & 0xf, clampColor(color));
+        word = (word & ~(0xfu << shift)) | (pixel << shift);
+    }
+
+    // blend the masked pixels of a word with the color replicated to all nibbles
+    template<typename Blit>
+    static void blitWord(uint32_t &word, uint32_t value, uint32_t mask) {
+        word = (word & ~mask) | (Blit::word(word, value) & mask);
+    }
+
+    // blend pixels x0..x1 (clipped) of a row
+    template<typename Blit>
+    void blitSpan(int x0, int x1, int y, uint8_t color) {
+        uint32_t *row = _frameBuffer.row(y);
+        uint32_t value = 0x11111111u * clampColor(color);
+        int w0 = x0 / FrameBuffer4bit::WordPixels;
+        int w1 = x1 / FrameBuffer4bit::WordPixels;
+        if (w0 == w1) {
+            blitWord<Blit>(row[w0], value, FrameBuffer4bit::spanMask(x0 & 7, x1 & 7));
+            return;
+        }
+        blitWord<Blit>(row[w0], value, FrameBuffer4bit::spanMask(x0 & 7, 7));
+        for (int w = w0 + 1; w < w1; ++w) {
+            row[w] = Blit::word(row[w], value);
+        }
+        blitWord<Blit>(row[w1], value, FrameBuffer4bit::spanMask(0, x1 & 7));
+    }
+
+    // blend the pixels of a word selected by an 8 bit span, pixels with set bits blend the color,
+    // pixels with cleared bits blend a color of 0 (ie. clear the pixel in set mode)
+    template<typename Blit>
+    static void blitBitmapWord(uint32_t &word, uint32_t value, uint8_t bits, uint8_t span) {
+        uint32_t setMask = FrameBuffer4bit::bitmapMask(bits);
+        uint32_t spanMask = FrameBuffer4bit::bitmapMask(span);
+        uint32_t result = (Blit::word(word, value) & setMask) | (Blit::word(word, 0) & spanMask & ~setMask);
+        word = (word & ~spanMask) | result;
+    }
+
+    // mark a rectangle as dirty, coordinates are clipped
+    void markDirty(int x0, int y0, int x1, int y1) {
+        clip(x0, y0);
+        clip(x1, y1);
+        _dirtyRegion.add(x0, y0, x1, y1);
+    }
+
     template<typename Blit>
     void point(int x, int y) {
-        Blit blit;
         if (inside(x, y)) {
-            blit(_frameBuffer, x, y, _color);
+            blitPixel<Blit>(x, y, _color);
+            _dirtyRegion.add(x, y, x, y);
         }
     }
 
     template<typename Blit>
     void hline(int x, int y, int w) {
-        Blit blit;
         if (vinside(y)) {
             int x0 = x, x1 = x + w - 1;
             hclip(x0);
             hclip(x1);
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
+            if (x0 <= x1) {
+                _dirtyRegion.add(x0, y, x1, y);
+                blitSpan<Blit>(x0, x1, y, _color);
             }
         }
     }
 
     template<typename Blit>
     void vline(int x, int y, int h) {
-        Blit blit;
         if (hinside(x)) {
             int y0 = y, y1 = y + h - 1;
             vclip(y0);
             vclip(y1);
+            if (y0 <= y1) {
+                _dirtyRegion.add(x, y0, x, y1);
+            }
+            uint32_t value = 0x11111111u * clampColor(_color);
+            uint32_t mask = FrameBuffer4bit::pixelMask(x);
             for (int y = y0; y <= y1; ++y) {
-                blit(_frameBuffer, x, y, _color);
+                blitWord<Blit>(_frameBuffer.row(y)[x / FrameBuffer4bit::WordPixels], value, mask);
             }
         }
     }
 
     template<typename Blit>
     void line(float x0, float y0, float x1, float y1) {
-        Blit blit;
-
         auto plot = [&] (int x, int y, float c) {
             if (inside(x, y)) {
-                blit(_frameBuffer, x, y, _color * c);
+                blitPixel<Blit>(x, y, _color * c);
             }
         };
 
@@ -160,6 +227,12 @@ private:
         auto fpart = [] (float x) { return x - std::floor(x); };
         auto rfpart = [] (float x) { return 1.f - (x - std::floor(x)); };
 
+        // endpoints are rounded and antialiased, which can touch pixels next to the bounding box
+        markDirty(
+            int(std::floor(std::min(x0, x1))) - 1, int(std::floor(std::min(y0, y1))) - 1,
+            int(std::floor(std::max(x0, x1))) + 2, int(std::floor(std::max(y0, y1))) + 2
+        );
+
         bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
 
         if (steep) {
@@ -230,26 +303,113 @@ private:
 
     template<typename Blit>
     void fillRect(int x, int y, int w, int h) {
-        Blit blit;
         int x0 = x, x1 = x + w - 1;
         int y0 = y, y1 = y + h - 1;
         clip(x0, y0);
         clip(x1, y1);
+        if (x0 > x1 || y0 > y1) {
+            return;
+        }
+        _dirtyRegion.add(x0, y0, x1, y1);
         for (int y = y0; y <= y1; ++y) {
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
+            blitSpan<Blit>(x0, x1, y, _color);
+        }
+    }
+
+    // 1 bit bitmaps (glyphs) up to 24 pixels wide are blended a word at a time, the bits of each bitmap row are
+    // aligned to the frame buffer words and expanded to pixel masks,
+    // cleared bits blend a color of 0 (ie. clear the pixel in set mode)
+    template<typename Blit>
+    void drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap) {
+        if (w > 24) {
+            drawBitmap<Blit, 1>(x, y, w, h, bitmap);
+            return;
+        }
+
+        int x0 = x, x1 = x + w - 1;
+        int y0 = y, y1 = y + h - 1;
+        if (x0 > _right || x1 < 0 || y0 > _bottom || y1 < 0) {
+            return;
+        }
+        markDirty(x0, y0, x1, y1);
+
+        // first word and pixel offset within the word (rounding towards negative infinity)
+        int word0 = (x0 >= 0 ? x0 : x0 - 7) / FrameBuffer4bit::WordPixels;
+        int offset = x0 - word0 * FrameBuffer4bit::WordPixels;
+        int word1 = (x1 >= 0 ? x1 : x1 - 7) / FrameBuffer4bit::WordPixels;
+        int wordBegin = std::max(0, word0);
+        int wordEnd = std::min(_frameBuffer.stride() - 1, word1);
+        uint32_t span = ((1u << w) - 1) << offset;
+        uint32_t value = 0x11111111u * clampColor(_color);
+
+        for (int py = std::max(y0, 0); py <= std::min(y1, _bottom); ++py) {
+            // gather bits of the bitmap row
+            int bit = (py - y0) * w;
+            const uint8_t *src = &bitmap[bit >> 3];
+            uint32_t bits = 0;
+            for (int i = 0, n = ((bit & 7) + w + 7) >> 3; i < n; ++i) {
+                bits |= uint32_t(src[i]) << (i * 8);
             }
+            bits = ((bits >> (bit & 7)) << offset) & span;
+
+            uint32_t *row = _frameBuffer.row(py);
+            for (int wordIndex = wordBegin; wordIndex <= wordEnd; ++wordIndex) {
+                int shift = (wordIndex - word0) * FrameBuffer4bit::WordPixels;
+                blitBitmapWord<Blit>(row[wordIndex], value, bits >> shift, span >> shift);
+            }
+        }
+    }
+
+    // text runs are blended like 1 bit bitmaps, pixels outside of the glyph boxes of the run are left untouched
+    template<typename Blit>
+    void drawTextRun(int x, int y, const TextRunCache::Run &run) {
+        int x0 = x + run.x, x1 = x0 + run.w - 1;
+        int y0 = y + run.y, y1 = y0 + run.h - 1;
+        if (run.w == 0 || x0 > _right || x1 < 0 || y0 > _bottom || y1 < 0) {
+            return;
+        }
+        markDirty(x0, y0, x1, y1);
+
+        int word0 = (x0 >= 0 ? x0 : x0 - 7) / FrameBuffer4bit::WordPixels;
+        int offset = x0 - word0 * FrameBuffer4bit::WordPixels;
+        int word1 = (x1 >= 0 ? x1 : x1 - 7) / FrameBuffer4bit::WordPixels;
+        int wordBegin = std::max(0, word0);
+        int wordEnd = std::min(_frameBuffer.stride() - 1, word1);
+        uint32_t value = 0x11111111u * clampColor(_color);
+
+        for (int py = std::max(y0, 0); py <= std::min(y1, _bottom); ++py) {
+            const uint32_t *bits = run.bitsRow(py - y0);
+            const uint32_t *span = run.spanRow(py - y0);
+            uint32_t *row = _frameBuffer.row(py);
+            for (int wordIndex = wordBegin; wordIndex <= wordEnd; ++wordIndex) {
+                int bit = (wordIndex - word0) * FrameBuffer4bit::WordPixels - offset;
+                blitBitmapWord<Blit>(row[wordIndex], value, runBits(bits, bit), runBits(span, bit));
+            }
+        }
+    }
+
+    // 8 bits of a text run row starting at a bit index (negative indices are before the start of the row)
+    static uint8_t runBits(const uint32_t *row, int bit) {
+        if (bit < 0) {
+            return row[0] << -bit;
+        }
+        int index = bit >> 5;
+        int shift = bit & 31;
+        uint32_t bits = row[index] >> shift;
+        if (shift > 24 && index + 1 < TextRunCache::RowWords) {
+            bits |= row[index + 1] << (32 - shift);
         }
+        return bits;
     }
 
     template<typename Blit, size_t Bpp>
     void drawBitmap(int x, int y, int w, int h, const uint8_t *bitmap) {
-        Blit blit;
         int x0 = x, x1 = x + w - 1;
         int y0 = y, y1 = y + h - 1;
         if (x0 > _right || x1 < 0 || y0 > _bottom || y1 < 0) {
             return;
         }
+        markDirty(x0, y0, x1, y1);
 
         const uint8_t mask = (1 << Bpp) - 1;
         int shift = 0;
@@ -263,17 +423,19 @@ private:
                     shift = 0;
                 }
                 if (inside(x, y)) {
-                    blit(_frameBuffer, x, y, pixel);
+                    blitPixel<Blit>(x, y, pixel);
                 }
             }
         }
     }
 
-    FrameBuffer8bit &_frameBuffer;
+    FrameBuffer4bit &_frameBuffer;
     int _right;
     int _bottom;
     uint8_t _color = 0xf;
     BlendMode _blendMode = BlendMode::Set;
     Font _font = Font::Default;
     float &_brightness;
+    DirtyRegion _dirtyRegion = DirtyRegion::full(_frameBuffer.width(), _frameBuffer.height());
+    TextRunCache _textRunCache;
 };
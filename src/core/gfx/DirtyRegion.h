@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+
+// Bounding box of modified pixels (inclusive coordinates).
+class DirtyRegion {
+public:
+    DirtyRegion() { clear(); }
+
+    DirtyRegion(int x0, int y0, int x1, int y1) :
+        _x0(x0), _y0(y0), _x1(x1), _y1(y1)
+    {}
+
+    static DirtyRegion full(int width, int height) {
+        return DirtyRegion(0, 0, width - 1, height - 1);
+    }
+
+    int x0() const { return _x0; }
+    int y0() const { return _y0; }
+    int x1() const { return _x1; }
+    int y1() const { return _y1; }
+
+    bool isEmpty() const { return _x1 < _x0 || _y1 < _y0; }
+
+    void clear() {
+        _x0 = _y0 = 0x7fff;
+        _x1 = _y1 = -1;
+    }
+
+    void add(int x0, int y0, int x1, int y1) {
+        _x0 = std::min(_x0, x0);
+        _y0 = std::min(_y0, y0);
+        _x1 = std::max(_x1, x1);
+        _y1 = std::max(_y1, y1);
+    }
+
+    void add(const DirtyRegion &region) {
+        if (!region.isEmpty()) {
+            add(region._x0, region._y0, region._x1, region._y1);
+        }
+    }
+
+private:
+    int _x0;
+    int _y0;
+    int _x1;
+    int _y1;
+};
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 
+#include <cstddef>
 #include <cstdint>
 
 template<typename T>
@@ -46,3 +47,80 @@ private:
 };
 
 typedef FrameBuffer<uint8_t> FrameBuffer8bit;
+
+// Frame buffer with 4 bit pixels packed two pixels per byte, the first pixel in the high nibble, which is the pixel
+// format of the display. Rows are stored in 32 bit words of 8 pixels, so the width must be a multiple of 8.
+// In a (little endian) word, pixel i is stored at bit pixelShift(i).
+class FrameBuffer4bit {
+public:
+    static constexpr int WordPixels = 8;
+
+    FrameBuffer4bit(int width, int height, uint32_t *buffer) :
+        _width(width),
+        _height(height),
+        _stride(width / WordPixels),
+        _data(buffer)
+    {}
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    // number of words per row
+    int stride() const { return _stride; }
+
+    // size in bytes
+    size_t size() const { return _stride * _height * sizeof(uint32_t); }
+
+    const uint8_t *data() const { return reinterpret_cast<const uint8_t *>(_data); }
+          uint8_t *data()       { return reinterpret_cast<uint8_t *>(_data); }
+
+    const uint32_t *row(int y) const { return &_data[y * _stride]; }
+          uint32_t *row(int y)       { return &_data[y * _stride]; }
+
+    void fill(uint8_t value) {
+        std::fill(_data, _data + _stride * _height, 0x11111111u * (value & 0xf));
+    }
+
+    uint8_t get(int x, int y) const {
+        return (row(y)[x / WordPixels] >> pixelShift(x)) & 0xf;
+    }
+
+    void set(int x, int y, uint8_t value) {
+        uint32_t &word = row(y)[x / WordPixels];
+        word = (word & ~pixelMask(x)) | (uint32_t(value & 0xf) << pixelShift(x));
+    }
+
+    static int pixelShift(int x) {
+        return (x & 6) * 4 + ((x & 1) ? 0 : 4);
+    }
+
+    static uint32_t pixelMask(int x) {
+        return 0xfu << pixelShift(x);
+    }
+
+    // mask of pixels x0..x1 within a word (0 <= x0 <= x1 < 8)
+    static uint32_t spanMask(int x0, int x1) {
+        static const uint32_t from[WordPixels] = {
+            0xffffffff, 0xffffff0f, 0xffffff00, 0xffff0f00, 0xffff0000, 0xff0f0000, 0xff000000, 0x0f000000
+        };
+        static const uint32_t to[WordPixels] = {
+            0x000000f0, 0x000000ff, 0x0000f0ff, 0x0000ffff, 0x00f0ffff, 0x00ffffff, 0xf0ffffff, 0xffffffff
+        };
+        return from[x0] & to[x1];
+    }
+
+    // mask of the pixels of a word selected by the bits of a pixel bitmap (bit i selects pixel i)
+    static uint32_t bitmapMask(uint8_t bits) {
+        static const uint16_t masks[16] = {
+            0x0000, 0x00f0, 0x000f, 0x00ff, 0xf000, 0xf0f0, 0xf00f, 0xf0ff,
+            0x0f00, 0x0ff0, 0x0f0f, 0x0fff, 0xff00, 0xfff0, 0xff0f, 0xffff
+        };
+        return masks[bits & 0xf] | (uint32_t(masks[bits >> 4]) << 16);
+    }
+
+private:
+    int _width;
+    int _height;
+    int _stride;
+    uint32_t *_data;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "DirtyRegion.h"
+
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Shadow copy of the 4 bit frame (see FrameBuffer4bit) last sent to SSD1322 type displays.
+// Updating the shadow frame compares the pixels with the previous frame and collects the windows that changed. Changes
+// are tracked in columns of 4 pixels (one 16 bit word of the shadow frame), which matches the column addressing of the
+// display. The frame is split into horizontal bands of BandHeight rows, each band with changes yields one window
+// spanning the changed rows and columns of the band.
+template<int Width, int Height, int BandHeight = 8>
+class FrameBufferDiff {
+public:
+    static constexpr int ColumnPixels = 4;
+    static constexpr int Columns = Width / ColumnPixels;
+    static constexpr int MaxWindows = (Height + BandHeight - 1) / BandHeight;
+    static constexpr size_t Size = Width * Height / 2;
+
+    static_assert(Width % ColumnPixels == 0, "width must be a multiple of 4 pixels");
+    static_assert(Columns <= 256 && Height <= 256, "frame too large");
+
+    // changed window (inclusive column and row addresses)
+    struct Window {
+        uint8_t col0;
+        uint8_t col1;
+        uint8_t row0;
+        uint8_t row1;
+
+        int columns() const { return col1 - col0 + 1; }
+        int rows() const { return row1 - row0 + 1; }
+        size_t size() const { return columns() * rows() * 2; }
+    };
+
+    FrameBufferDiff() {
+        std::fill(_shadow, _shadow + Columns * Height, 0);
+        invalidate();
+    }
+
+    // mark the whole frame as changed on the next update (ie. display contents are unknown)
+    void invalidate() { _invalid = true; }
+
+    // update the shadow frame from the pixels of the 4 bit frame buffer within the region,
+    // pixels outside of the region are expected to be unchanged since the last update
+    void update(const uint8_t *frameBuffer, const DirtyRegion &region) {
+        _windowCount = 0;
+        _changedSize = 0;
+
+        if (_invalid) {
+            _invalid = false;
+            std::memcpy(_shadow, frameBuffer, Size);
+            addWindow({ 0, uint8_t(Columns - 1), 0, uint8_t(Height - 1) });
+            return;
+        }
+
+        if (region.isEmpty()) {
+            return;
+        }
+
+        int col0 = std::max(0, region.x0()) / ColumnPixels;
+        int col1 = std::min(Width - 1, region.x1()) / ColumnPixels;
+        int row0 = std::max(0, region.y0());
+        int row1 = std::min(Height - 1, region.y1());
+
+        for (int bandRow = (row0 / BandHeight) * BandHeight; bandRow <= row1; bandRow += BandHeight) {
+            Window window = { 0xff, 0, 0xff, 0 };
+            int rowEnd = std::min(row1, bandRow + BandHeight - 1);
+            for (int row = std::max(row0, bandRow); row <= rowEnd; ++row) {
+                const uint8_t *src = &frameBuffer[(row * Columns + col0) * 2];
+                uint16_t *dst = &_shadow[row * Columns];
+                for (int col = col0; col <= col1; ++col, src += 2) {
+                    uint16_t pixels;
+                    std::memcpy(&pixels, src, sizeof(pixels));
+                    if (pixels != dst[col]) {
+                        dst[col] = pixels;
+                        window.col0 = std::min(window.col0, uint8_t(col));
+                        window.col1 = std::max(window.col1, uint8_t(col));
+                        window.row0 = std::min(window.row0, uint8_t(row));
+                        window.row1 = uint8_t(row);
+                    }
+                }
+            }
+            if (window.col0 <= window.col1) {
+                addWindow(window);
+            }
+        }
+    }
+
+    int windowCount() const { return _windowCount; }
+    const Window &window(int index) const { return _windows[index]; }
+
+    // number of bytes in all changed windows
+    size_t changedSize() const { return _changedSize; }
+
+    // copy the packed pixels of a window to dst (row by row), returns the number of bytes copied
+    size_t copyWindow(const Window &window, uint8_t *dst) const {
+        size_t rowSize = window.columns() * 2;
+        for (int row = window.row0; row <= window.row1; ++row) {
+            std::memcpy(dst, &_shadow[row * Columns + window.col0], rowSize);
+            dst += rowSize;
+        }
+        return window.size();
+    }
+
+    // packed frame
+    const uint8_t *data() const { return reinterpret_cast<const uint8_t *>(_shadow); }
+
+private:
+    void addWindow(const Window &window) {
+        _windows[_windowCount++] = window;
+        _changedSize += window.size();
+    }
+
+    uint16_t _shadow[Columns * Height];
+    Window _windows[MaxWindows];
+    int _windowCount = 0;
+    size_t _changedSize = 0;
+    bool _invalid;
+};
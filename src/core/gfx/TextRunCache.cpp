@@ -0,0 +1,181 @@
+#include "TextRunCache.h"
+
+#include "core/hash/FnvHash.h"
+#include "core/profiler/Profiler.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <cstring>
+
+PROFILER_COUNTER(textRunHits, "text run cache hits")
+PROFILER_COUNTER(textRunMisses, "text run cache misses")
+PROFILER_COUNTER(textRunRejected, "text run cache rejected strings")
+
+void TextRunCache::clear() {
+    for (auto &run : _runs) {
+        run.font = nullptr;
+        run.lastUse = 0;
+    }
+    _useCounter = 0;
+    for (auto &rejected : _rejected) {
+        rejected.font = nullptr;
+    }
+    _rejectedIndex = 0;
+}
+
+const TextRunCache::Run *TextRunCache::find(const BitmapFont &font, const char *str) const {
+    uint32_t hash;
+    if (!hashString(str, hash)) {
+        return nullptr;
+    }
+    int index = findRun(font, str, hash);
+    return index != -1 ? &_runs[index] : nullptr;
+}
+
+const TextRunCache::Run *TextRunCache::lookup(const BitmapFont &font, const char *str) {
+    uint32_t hash;
+    if (!hashString(str, hash)) {
+        return nullptr;
+    }
+
+    int index = findRun(font, str, hash);
+    if (index != -1) {
+        PROFILER_COUNTER_ADD(textRunHits, 1);
+        _runs[index].lastUse = ++_useCounter;
+        return &_runs[index];
+    }
+
+    if (isRejected(font, hash)) {
+        PROFILER_COUNTER_ADD(textRunRejected, 1);
+        return nullptr;
+    }
+
+    PROFILER_COUNTER_ADD(textRunMisses, 1);
+
+    // replace an empty or the least recently used run
+    Run *run = &_runs[0];
+    for (auto &candidate : _runs) {
+        if (candidate.font == nullptr) {
+            run = &candidate;
+            break;
+        }
+        if (int32_t(candidate.lastUse - run->lastUse) < 0) {
+            run = &candidate;
+        }
+    }
+
+    if (!compose(*run, font, str)) {
+        _rejected[_rejectedIndex] = { &font, hash };
+        _rejectedIndex = (_rejectedIndex + 1) % RejectedEntries;
+        return nullptr;
+    }
+    run->font = &font;
+    run->hash = hash;
+    run->lastUse = ++_useCounter;
+    std::strcpy(run->text, str);
+    return run;
+}
+
+bool TextRunCache::hashString(const char *str, uint32_t &hash) {
+    FnvHash fnv;
+    for (int length = 0; str[length] != '\0'; ++length) {
+        if (length >= MaxLength || str[length] == '\n') {
+            return false;
+        }
+        fnv(uint8_t(str[length]));
+    }
+    hash = fnv.result();
+    return true;
+}
+
+int TextRunCache::findRun(const BitmapFont &font, const char *str, uint32_t hash) const {
+    for (int i = 0; i < Entries; ++i) {
+        const auto &run = _runs[i];
+        if (run.font == &font && run.hash == hash && std::strcmp(run.text, str) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool TextRunCache::isRejected(const BitmapFont &font, uint32_t hash) const {
+    for (const auto &rejected : _rejected) {
+        if (rejected.font == &font && rejected.hash == hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextRunCache::compose(Run &run, const BitmapFont &font, const char *str) {
+    if (font.bpp != 1) {
+        return false;
+    }
+
+    // measure the bounding box of the glyphs
+    int x0 = 0x7fff, y0 = 0x7fff, x1 = -0x7fff, y1 = -0x7fff;
+    int pen = 0;
+    for (const char *s = str; *s != '\0'; ++s) {
+        auto c = *s;
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        if (g.width > 0 && g.height > 0) {
+            x0 = std::min(x0, pen + g.xOffset);
+            x1 = std::max(x1, pen + g.xOffset + g.width - 1);
+            y0 = std::min(y0, int(g.yOffset));
+            y1 = std::max(y1, g.yOffset + g.height - 1);
+        }
+        pen += g.xAdvance;
+    }
+
+    if (x1 < x0) {
+        // no visible glyphs
+        x0 = y0 = 0;
+        x1 = y1 = -1;
+    }
+    if (x1 - x0 + 1 > MaxWidth || y1 - y0 + 1 > MaxRows || x0 < -128 || x0 > 127 || y0 < -128 || y0 > 127 || pen > 255) {
+        return false;
+    }
+    run.x = x0;
+    run.y = y0;
+    run.w = x1 - x0 + 1;
+    run.h = y1 - y0 + 1;
+    run.width = pen;
+
+    // composite the glyphs
+    std::fill(std::begin(run.bits), std::end(run.bits), 0);
+    std::fill(std::begin(run.span), std::end(run.span), 0);
+    pen = 0;
+    for (const char *s = str; *s != '\0'; ++s) {
+        auto c = *s;
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        const uint8_t *bitmap = &font.bitmap[g.offset];
+        for (int gy = 0; gy < g.height; ++gy) {
+            int row = (g.yOffset + gy - y0) * RowWords;
+            for (int gx = 0; gx < g.width; ++gx) {
+                int x = pen + g.xOffset + gx - x0;
+                uint32_t mask = 1u << (x & 31);
+                uint32_t &span = run.span[row + (x >> 5)];
+                if (span & mask) {
+                    // overlapping glyph boxes, the run is invalid
+                    run.font = nullptr;
+                    return false;
+                }
+                span |= mask;
+                int bit = gy * g.width + gx;
+                if ((bitmap[bit >> 3] >> (bit & 7)) & 1) {
+                    run.bits[row + (x >> 5)] |= mask;
+                }
+            }
+        }
+        pen += g.xAdvance;
+    }
+
+    return true;
+}
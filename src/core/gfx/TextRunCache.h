@@ -0,0 +1,77 @@
+#pragma once
+
+#include "fonts/BitmapFont.h"
+
+#include <cstdint>
+
+// Least recently used cache of single line text runs.
+// A run stores the advance width of a string and its glyphs composited into a 1 bit bitmap, so drawing a string that
+// is drawn every frame (labels, names) is a single bitmap blit instead of a walk over the glyph table. Runs are keyed
+// by font and string hash, the string itself is compared on a hash match.
+// Only strings of 1 bit fonts without line breaks that fit into the run bitmap are cached. Besides the glyph bits,
+// the bitmap records which pixels are covered by glyph boxes (the span), so blending a run gives the same result as
+// blending the glyphs one by one. This requires glyph boxes within a run to not overlap, which holds for all fonts
+// in use, runs with overlapping glyphs are not cached.
+// Strings that fail to composite (too wide or high, overlapping glyphs) are remembered by font and string hash, so
+// drawing them every frame does not measure them over and over again (a cacheable string with the same hash is drawn
+// glyph by glyph, which gives the same result).
+class TextRunCache {
+public:
+    static constexpr int Entries = 32;
+    static constexpr int MaxLength = 15;
+    static constexpr int MaxWidth = 64;
+    static constexpr int MaxRows = 8;
+    static constexpr int RowWords = (MaxWidth + 31) / 32;
+    static constexpr int RejectedEntries = 8;
+
+    struct Run {
+        const BitmapFont *font;
+        uint32_t hash;
+        uint32_t lastUse;
+        char text[MaxLength + 1];
+        int8_t x;                   // left edge of the bitmap relative to the pen position
+        int8_t y;                   // top edge of the bitmap relative to the baseline
+        uint8_t w;                  // bitmap size in pixels
+        uint8_t h;
+        uint8_t width;              // advance width
+        // bit n of a row is pixel n from the left edge
+        uint32_t bits[MaxRows * RowWords];
+        uint32_t span[MaxRows * RowWords];
+
+        const uint32_t *bitsRow(int row) const { return &bits[row * RowWords]; }
+        const uint32_t *spanRow(int row) const { return &span[row * RowWords]; }
+    };
+
+    TextRunCache() { clear(); }
+
+    void clear();
+
+    // cached run of a string, returns nullptr if the run is not cached
+    const Run *find(const BitmapFont &font, const char *str) const;
+
+    // cached run of a string, the run is composited on a cache miss (replacing the least recently used run),
+    // returns nullptr if the string cannot be cached
+    const Run *lookup(const BitmapFont &font, const char *str);
+
+private:
+    // hash of a string that can be cached, returns false if the string is too long or has line breaks
+    static bool hashString(const char *str, uint32_t &hash);
+
+    // index of the cached run or -1
+    int findRun(const BitmapFont &font, const char *str, uint32_t hash) const;
+
+    static bool compose(Run &run, const BitmapFont &font, const char *str);
+
+    // strings that failed to composite, replaced round robin
+    struct Rejected {
+        const BitmapFont *font;
+        uint32_t hash;
+    };
+
+    bool isRejected(const BitmapFont &font, uint32_t hash) const;
+
+    Run _runs[Entries];
+    uint32_t _useCounter;
+    Rejected _rejected[RejectedEntries];
+    int _rejectedIndex;
+};
@@ -2,43 +2,49 @@
 
 #include "core/hash/FnvHash.h"
 
+#include <algorithm>
+
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
+// Reads versioned and hashed data.
+// By default every field is requested from the reader, which allows multiple readers to consume data from a single
+// source. If the number of bytes available to the reader (including data version and hash) is known, data is fetched
+// from the reader in blocks instead, large reads such as step arrays are passed to the reader directly.
 class VersionedSerializedReader {
 public:
     typedef std::function<void(void *, size_t)> Reader;
 
-    VersionedSerializedReader(Reader reader, uint32_t readerVersion) :
+    VersionedSerializedReader(Reader reader, uint32_t readerVersion, size_t available = 0) :
         _reader(reader),
-        _readerVersion(readerVersion)
+        _readerVersion(readerVersion),
+        _available(available)
     {
-        _reader(&_dataVersion, sizeof(_dataVersion));
+        fetch(&_dataVersion, sizeof(_dataVersion));
     }
 
     uint32_t readerVersion() const { return _readerVersion; }
     uint32_t dataVersion() const { return _dataVersion; }
 
+    // number of available bytes not yet consumed
+    size_t remaining() const { return _available + _end - _pos; }
+
     template<typename T>
     void read(T &value, uint32_t addedInVersion = 0) {
         read(&value, sizeof(value), addedInVersion);
     }
 
-    // This is potentially slow as we call serialize for every enum value until a match is found.
-    // However, the nice thing about using a switch state in the serialize function is that the
-    // compiler can warn us when new enum values are added without updating the serialize function.
-    template<typename Enum, typename SerializeFunc>
-    void readEnum(Enum &e, SerializeFunc serialize, uint32_t addedInVersion = 0) {
+    // Using a switch statement in the serialize function has the nice property that the compiler can warn us when
+    // new enum values are added without updating the serialize function. To avoid calling the serialize function
+    // for every enum value until a match is found, a reverse lookup table is built on first use.
+    template<typename Enum, typename Value>
+    void readEnum(Enum &e, Value (*serialize)(Enum), uint32_t addedInVersion = 0) {
         if (_dataVersion >= addedInVersion) {
-            auto i = serialize(Enum(0));
-            read(i);
-            for (e = Enum(0); int(e) < int(Enum::Last); e = Enum(int(e) + 1)) {
-                if (serialize(e) == i) {
-                    return;
-                }
-            }
-            e = Enum(0);
+            Value value;
+            read(value);
+            e = EnumTable<Enum, Value>::deserialize(serialize, value);
         }
     }
 
@@ -53,7 +59,7 @@ public:
 
     void read(void *data, size_t len, uint32_t addedInVersion) {
         if (_dataVersion >= addedInVersion) {
-            _reader(data, len);
+            fetch(data, len);
             _hash(data, len);
         }
     }
@@ -66,14 +72,14 @@ public:
     void skip(size_t len, uint32_t addedInVersion, uint32_t removedInVersion) {
         if (_dataVersion >= addedInVersion && _dataVersion < removedInVersion) {
             uint8_t dummy[len];
-            _reader(dummy, len);
+            fetch(dummy, len);
             _hash(dummy, len);
         }
     }
 
     bool checkHash() {
         uint32_t hash;
-        _reader(&hash, sizeof(hash));
+        fetch(&hash, sizeof(hash));
         return _hash.result() == hash;
     }
 
@@ -86,9 +92,80 @@ public:
     }
 
 private:
+    static constexpr size_t BufferSize = 64;
+
+    template<typename Enum, typename Value>
+    class EnumTable {
+    public:
+        static Enum deserialize(Value (*serialize)(Enum), Value value) {
+            if (serialize != _serialize) {
+                build(serialize);
+            }
+            auto it = std::lower_bound(_entries, _entries + Size, value, [] (const Entry &entry, Value value) {
+                return entry.value < value;
+            });
+            return (it != _entries + Size && it->value == value) ? it->e : Enum(0);
+        }
+
+    private:
+        static constexpr int Size = int(Enum::Last);
+
+        struct Entry {
+            Value value;
+            Enum e;
+        };
+
+        // entries are sorted by serialized value, equal values keep the enum order
+        static void build(Value (*serialize)(Enum)) {
+            for (int i = 0; i < Size; ++i) {
+                _entries[i] = { serialize(Enum(i)), Enum(i) };
+            }
+            std::stable_sort(_entries, _entries + Size, [] (const Entry &a, const Entry &b) { return a.value < b.value; });
+            _serialize = serialize;
+        }
+
+        static Value (*_serialize)(Enum);
+        static Entry _entries[Size];
+    };
+
+    void fetch(void *data, size_t len) {
+        uint8_t *dst = static_cast<uint8_t *>(data);
+        size_t chunk = std::min(len, _end - _pos);
+        std::memcpy(dst, &_buffer[_pos], chunk);
+        _pos += chunk;
+        dst += chunk;
+        len -= chunk;
+
+        if (len > 0 && len < BufferSize && _available > 0) {
+            _end = std::min(size_t(BufferSize), _available);
+            _reader(_buffer, _end);
+            _available -= _end;
+            chunk = std::min(len, _end);
+            std::memcpy(dst, _buffer, chunk);
+            _pos = chunk;
+            dst += chunk;
+            len -= chunk;
+        }
+
+        if (len > 0) {
+            _available -= std::min(len, _available);
+            _reader(dst, len);
+        }
+    }
+
     Reader _reader;
     uint32_t _readerVersion;
     uint32_t _dataVersion;
     FnvHash _hash;
     FnvHash _savedHash;
+    size_t _available;
+    size_t _pos = 0;
+    size_t _end = 0;
+    uint8_t _buffer[BufferSize];
 };
+
+template<typename Enum, typename Value>
+Value (*VersionedSerializedReader::EnumTable<Enum, Value>::_serialize)(Enum) = nullptr;
+
+template<typename Enum, typename Value>
+typename VersionedSerializedReader::EnumTable<Enum, Value>::Entry VersionedSerializedReader::EnumTable<Enum, Value>::_entries[VersionedSerializedReader::EnumTable<Enum, Value>::Size];
@@ -4,8 +4,13 @@
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
+// Writes versioned and hashed data.
+// Fields are collected in a small buffer and passed to the writer (and hash) in blocks, large writes such as step
+// arrays are passed to the writer directly. The buffer is flushed when writing the hash, when calling flush() and
+// when the writer is destroyed.
 class VersionedSerializedWriter {
 public:
     typedef std::function<void(const void *, size_t)> Writer;
@@ -17,6 +22,10 @@ public:
         _writer(&_writerVersion, sizeof(_writerVersion));
     }
 
+    ~VersionedSerializedWriter() {
+        flush();
+    }
+
     uint32_t writerVersion() const { return _writerVersion; }
 
     template<typename T>
@@ -31,17 +40,41 @@ public:
     }
 
     void write(const void *data, size_t len) {
-        _hash(data, len);
-        _writer(data, len);
+        if (len <= BufferSize - _pos) {
+            std::memcpy(&_buffer[_pos], data, len);
+            _pos += len;
+        } else {
+            flush();
+            if (len < BufferSize) {
+                std::memcpy(_buffer, data, len);
+                _pos = len;
+            } else {
+                _hash(data, len);
+                _writer(data, len);
+            }
+        }
     }
 
     void writeHash() {
+        flush();
         uint32_t hash = _hash.result();
         _writer(&hash, sizeof(hash));
     }
 
+    void flush() {
+        if (_pos > 0) {
+            _hash(_buffer, _pos);
+            _writer(_buffer, _pos);
+            _pos = 0;
+        }
+    }
+
 private:
+    static constexpr size_t BufferSize = 64;
+
     Writer _writer;
     uint32_t _writerVersion;
     FnvHash _hash;
+    size_t _pos = 0;
+    uint8_t _buffer[BufferSize];
 };
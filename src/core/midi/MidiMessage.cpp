@@ -2,6 +2,8 @@
 
 #include "core/Debug.h"
 
+#include "os/os.h"
+
 MidiMessage::PayloadPool MidiMessage::_payloadPool;
 
 void MidiMessage::dump(const MidiMessage &msg) {
@@ -43,6 +45,10 @@ void MidiMessage::setPayloadPool(uint8_t *data, size_t length) {
     _payloadPool.length = length;
 }
 
+size_t MidiMessage::maxPayloadLength() {
+    return _payloadPool.valid() ? _payloadPool.length / PayloadPool::SlotCount : 0;
+}
+
 MidiMessage::PayloadID MidiMessage::allocatePayload(size_t length) {
     if (!_payloadPool.valid()) {
         return InvalidPayload;
@@ -54,6 +60,9 @@ MidiMessage::PayloadID MidiMessage::allocatePayload(size_t length) {
         return InvalidPayload;
     }
 
+    // messages are created and released by both the ui and the usb host task
+    os::InterruptLock lock;
+
     for (size_t slotIndex = 0; slotIndex < _payloadPool.slots.size(); ++slotIndex) {
         auto &slot = _payloadPool.slots[slotIndex];
         if (!slot.data) {
@@ -68,6 +77,7 @@ MidiMessage::PayloadID MidiMessage::allocatePayload(size_t length) {
 }
 
 void MidiMessage::incPayloadRefCount(PayloadID id) {
+    os::InterruptLock lock;
     auto slot = _payloadPool.getSlot(id);
     if (slot) {
         slot->refCount++;
@@ -76,6 +86,7 @@ void MidiMessage::incPayloadRefCount(PayloadID id) {
 }
 
 void MidiMessage::decPayloadRefCount(PayloadID id) {
+    os::InterruptLock lock;
     auto slot = _payloadPool.getSlot(id);
     if (slot) {
         slot->refCount--;
@@ -385,6 +385,9 @@ public:
 
     static void setPayloadPool(uint8_t *data, size_t length);
 
+    // maximum payload length that can be allocated (0 if there is no payload pool)
+    static size_t maxPayloadLength();
+
 private:
     static PayloadID allocatePayload(size_t length);
     static void incPayloadRefCount(PayloadID id);
@@ -2,11 +2,13 @@
 
 #include "core/Debug.h"
 
+#include <cinttypes>
+
 #if CONFIG_ENABLE_PROFILER
-int Profiler::_numIntervals;
-int Profiler::_numCounters;
-Profiler::Interval *Profiler::_intervals[Profiler::MaxIntervals];
-Profiler::Counter *Profiler::_counters[Profiler::MaxCounters];
+Profiler::Interval *Profiler::_intervals;
+Profiler::Counter *Profiler::_counters;
+Profiler::Memory *Profiler::_memories;
+std::atomic<uint32_t> Profiler::_resetRequest;
 
 void Profiler::init() {
 }
@@ -14,37 +16,46 @@ void Profiler::init() {
 void Profiler::dump() {
     DBG("Profiler:");
     DBG("---------------------------------------------");
-    if (_numIntervals > 0) {
+    if (_intervals) {
         DBG("Intervals:");
-        for (int i = 0; i < _numIntervals; ++i) {
-            const auto &interval = *_intervals[i];
-            DBG("  %s: %lu us", interval.desc, interval.avg);
-        }
+        forEachInterval([] (const Interval &interval) {
+            IntervalSnapshot snapshot;
+            if (!interval.snapshot(snapshot)) {
+                return;
+            }
+            if (snapshot.budget > 0) {
+                DBG("  %s: %" PRIu32 " us mean, %" PRIu32 " us min, %" PRIu32 " us max, %" PRIu32 " samples, %.1f%% budget (%.1f%% max)",
+                    snapshot.desc, snapshot.mean, snapshot.min, snapshot.max, snapshot.count,
+                    snapshot.meanUtilization(), snapshot.maxUtilization());
+            } else {
+                DBG("  %s: %" PRIu32 " us mean, %" PRIu32 " us min, %" PRIu32 " us max, %" PRIu32 " samples",
+                    snapshot.desc, snapshot.mean, snapshot.min, snapshot.max, snapshot.count);
+            }
+        });
     }
-    if (_numCounters > 0) {
+    if (_counters) {
         DBG("Counters:");
-        for (int i = 0; i < _numCounters; ++i) {
-            const auto &counter = *_counters[i];
-            DBG("  %s: %lu", counter.desc, counter.count);
-        }
+        forEachCounter([] (const Counter &counter) {
+            DBG("  %s: %" PRIu32, counter.desc, counter.count);
+        });
+    }
+    if (_memories) {
+        DBG("Memory:");
+        forEachMemory([] (const Memory &memory) {
+            DBG("  %s: %" PRIu32 " bytes used, %" PRIu32 " peak, %" PRIu32 " reserved", memory.desc, memory.used, memory.peak, memory.size);
+        });
     }
     DBG("---------------------------------------------");
 }
 
-void Profiler::registerInterval(Interval *interval) {
-    if (_numIntervals < MaxIntervals) {
-        _intervals[_numIntervals++] = interval;
-    } else {
-        DBG("Profiler: Too many profiler intervals!");
-    }
+void Profiler::reset() {
+    _resetRequest.fetch_add(1, std::memory_order_relaxed);
 }
 
-void Profiler::registerCounter(Counter *counter) {
-    if (_numCounters < MaxCounters) {
-        _counters[_numCounters++] = counter;
-    } else {
-        DBG("Profiler: Too many profiler counters");
-    }
+int Profiler::intervalCount() {
+    int count = 0;
+    forEachInterval([&count] (const Interval &) { ++count; });
+    return count;
 }
 
 #endif // CONFIG_ENABLE_PROFILER
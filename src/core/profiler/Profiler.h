@@ -4,17 +4,41 @@
 
 #include "drivers/HighResolutionTimer.h"
 
+#include <atomic>
 #include <cstdint>
 
 #if CONFIG_ENABLE_PROFILER
 
 class Profiler {
 public:
+    // number of log2 histogram buckets, bucket 0 counts 0us, bucket n counts [2^(n-1), 2^n) us,
+    // last bucket counts everything above
+    static constexpr int HistogramBuckets = 16;
+
     static void init();
     static void dump();
 
+    // request resetting all interval statistics (applied by the writer on the next measurement)
+    static void reset();
+
+    struct IntervalSnapshot {
+        const char *desc;
+        uint32_t count;
+        uint32_t last;
+        uint32_t min;
+        uint32_t max;
+        uint32_t mean;
+        uint32_t budget;
+        uint32_t histogram[HistogramBuckets];
+
+        // utilization of the budget in percent (0 if interval has no budget)
+        float meanUtilization() const { return budget > 0 ? (100.f * mean) / budget : 0.f; }
+        float maxUtilization() const { return budget > 0 ? (100.f * max) / budget : 0.f; }
+    };
+
     struct Interval {
-        Interval(const char *desc) : desc(desc) {
+        // budget is the available time in us (ie. period of the task executing the interval), 0 for no budget
+        Interval(const char *desc, uint32_t budget = 0) : desc(desc), budget(budget) {
             registerInterval(this);
         }
 
@@ -23,13 +47,89 @@ public:
         }
 
         inline void end() {
-            uint32_t end = HighResolutionTimer::us();
-            avg = end - start;
+            record(HighResolutionTimer::us() - start);
+        }
+
+        // record a measurement, must only be called from a single thread/task
+        void record(uint32_t duration) {
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            uint32_t resetRequest = _resetRequest.load(std::memory_order_relaxed);
+            if (resetGeneration != resetRequest) {
+                resetGeneration = resetRequest;
+                clear();
+            }
+
+            ++count;
+            total += duration;
+            last = duration;
+            min = duration < min ? duration : min;
+            max = duration > max ? duration : max;
+            ++histogram[histogramBucket(duration)];
+
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        // take a consistent copy of the statistics without blocking the writer,
+        // returns false (with a cleared snapshot) if the writer kept interrupting the copy
+        bool snapshot(IntervalSnapshot &snapshot) const {
+            for (int retry = 0; retry < 8; ++retry) {
+                uint32_t seq = sequence.load(std::memory_order_acquire);
+                if (seq & 1) {
+                    continue;
+                }
+                snapshot.desc = desc;
+                snapshot.count = count;
+                snapshot.last = last;
+                snapshot.min = count > 0 ? min : 0;
+                snapshot.max = max;
+                snapshot.mean = count > 0 ? uint32_t(total / count) : 0;
+                snapshot.budget = budget;
+                for (int i = 0; i < HistogramBuckets; ++i) {
+                    snapshot.histogram[i] = histogram[i];
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == seq) {
+                    return true;
+                }
+            }
+            snapshot = IntervalSnapshot();
+            return false;
+        }
+
+        static int histogramBucket(uint32_t duration) {
+            int bucket = duration == 0 ? 0 : 32 - __builtin_clz(duration);
+            return bucket < HistogramBuckets ? bucket : HistogramBuckets - 1;
         }
 
         const char *desc;
+        uint32_t budget;
         uint32_t start;
-        uint32_t avg;
+
+        Interval *next = nullptr;
+
+    private:
+        void clear() {
+            count = 0;
+            total = 0;
+            last = 0;
+            min = UINT32_MAX;
+            max = 0;
+            for (int i = 0; i < HistogramBuckets; ++i) {
+                histogram[i] = 0;
+            }
+        }
+
+        std::atomic<uint32_t> sequence { 0 };
+        uint32_t resetGeneration = 0;
+        uint32_t count = 0;
+        uint64_t total = 0;
+        uint32_t last = 0;
+        uint32_t min = UINT32_MAX;
+        uint32_t max = 0;
+        uint32_t histogram[HistogramBuckets] = {};
     };
 
     struct Counter {
@@ -43,23 +143,75 @@ public:
 
         const char *desc;
         uint32_t count;
+
+        Counter *next = nullptr;
+    };
+
+    struct Memory {
+        Memory(const char *desc) : desc(desc) {
+            registerMemory(this);
+        }
+
+        inline void use(uint32_t bytes, uint32_t reserved) {
+            used = bytes;
+            peak = bytes > peak ? bytes : peak;
+            size = reserved;
+        }
+
+        const char *desc;
+        uint32_t used;
+        uint32_t peak;
+        uint32_t size;
+
+        Memory *next = nullptr;
     };
 
+    static int intervalCount();
+
+    template<typename Func>
+    static void forEachInterval(Func func) {
+        for (const Interval *interval = _intervals; interval; interval = interval->next) {
+            func(*interval);
+        }
+    }
+
+    template<typename Func>
+    static void forEachCounter(Func func) {
+        for (const Counter *counter = _counters; counter; counter = counter->next) {
+            func(*counter);
+        }
+    }
+
+    template<typename Func>
+    static void forEachMemory(Func func) {
+        for (const Memory *memory = _memories; memory; memory = memory->next) {
+            func(*memory);
+        }
+    }
+
 private:
-    static const int MaxIntervals = 16;
-    static const int MaxCounters = 16;
+    template<typename T>
+    static void append(T **list, T *item) {
+        while (*list != nullptr) {
+            list = &(*list)->next;
+        }
+        *list = item;
+    }
 
-    static void registerInterval(Interval *interval);
-    static void registerCounter(Counter *counter);
+    static void registerInterval(Interval *interval) { append(&_intervals, interval); }
+    static void registerCounter(Counter *counter) { append(&_counters, counter); }
+    static void registerMemory(Memory *memory) { append(&_memories, memory); }
 
-    static int _numIntervals;
-    static int _numCounters;
-    static Interval *_intervals[MaxIntervals];
-    static Counter *_counters[MaxCounters];
+    static Interval *_intervals;
+    static Counter *_counters;
+    static Memory *_memories;
+    static std::atomic<uint32_t> _resetRequest;
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_) \
     static Profiler::Interval _name_##_profiler_interval(_desc_);
+# define PROFILER_INTERVAL_BUDGET(_name_, _desc_, _budget_) \
+    static Profiler::Interval _name_##_profiler_interval(_desc_, _budget_);
 # define PROFILER_INTERVAL_BEGIN(_name_) \
     _name_##_profiler_interval.begin();
 # define PROFILER_INTERVAL_END(_name_) \
@@ -67,22 +219,32 @@ private:
 
 # define PROFILER_COUNTER(_name_, _desc_) \
     static Profiler::Counter _name_##_profiler_counter(_desc_);
-# define PROFILER_COUNTER_ADD(_num_) \
+# define PROFILER_COUNTER_ADD(_name_, _num_) \
     _name_##_profiler_counter.add(_num_);
 
+# define PROFILER_MEMORY(_name_, _desc_) \
+    static Profiler::Memory _name_##_profiler_memory(_desc_);
+# define PROFILER_MEMORY_USE(_name_, _bytes_, _reserved_) \
+    _name_##_profiler_memory.use(_bytes_, _reserved_);
+
 #else // CONFIG_ENABLE_PROFILER
 
 class Profiler {
 public:
     static void init() {}
     static void dump() {}
+    static void reset() {}
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_)
+# define PROFILER_INTERVAL_BUDGET(_name_, _desc_, _budget_)
 # define PROFILER_INTERVAL_BEGIN(_name_)
 # define PROFILER_INTERVAL_END(_name_)
 
 # define PROFILER_COUNTER(_name_, _desc_)
-# define PROFILER_COUNTER_ADD(_num_)
+# define PROFILER_COUNTER_ADD(_name_, _num_)
+
+# define PROFILER_MEMORY(_name_, _desc_)
+# define PROFILER_MEMORY_USE(_name_, _bytes_, _reserved_)
 
 #endif // CONFIG_ENABLE_PROFILER
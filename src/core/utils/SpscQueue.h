@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstddef>
+
+// Lock-free single producer, single consumer queue with a power of two capacity.
+//
+// One context (i.e. an interrupt handler or task) pushes items while another context pops them. The read and write
+// indices are free running counters that are padded to live on separate cache lines. Pushing to a full queue drops
+// the new item and counts it in overflowCount(). The producer also keeps track of the maximum number of queued items
+// in highWaterMark().
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // number of queued items (exact on the consumer side)
+    size_t size() const {
+        return _write.load(std::memory_order_acquire) - _read.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= Capacity; }
+
+    // number of items dropped due to the queue being full
+    uint32_t overflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+    // maximum number of queued items
+    uint32_t highWaterMark() const { return _highWaterMark.load(std::memory_order_relaxed); }
+
+    // producer: push an item, returns false if the queue is full
+    bool push(const T &item) {
+        uint32_t write = _write.load(std::memory_order_relaxed);
+        uint32_t size = write - _read.load(std::memory_order_acquire);
+        if (size >= Capacity) {
+            _overflowCount.store(_overflowCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[write & Mask] = item;
+        _write.store(write + 1, std::memory_order_release);
+        if (size + 1 > _highWaterMark.load(std::memory_order_relaxed)) {
+            _highWaterMark.store(size + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // consumer: pop an item, returns false if the queue is empty
+    bool pop(T &item) {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        if (read == _write.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[read & Mask];
+        _read.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: pop up to length items into data, returns the number of items
+    size_t drain(T *data, size_t length) {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        size_t count = std::min(size_t(_write.load(std::memory_order_acquire) - read), length);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = _items[(read + i) & Mask];
+        }
+        _read.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    // consumer: drop all queued items
+    void clear() {
+        _read.store(_write.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static constexpr uint32_t Mask = Capacity - 1;
+
+    // producer owned
+    std::atomic<uint32_t> _write{0};
+    std::atomic<uint32_t> _highWaterMark{0};
+    std::atomic<uint32_t> _overflowCount{0};
+    uint8_t _padding0[CACHE_LINE_SIZE];
+    // consumer owned
+    std::atomic<uint32_t> _read{0};
+    uint8_t _padding1[CACHE_LINE_SIZE];
+    std::array<T, Capacity> _items;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Random.h"
+
+#include <array>
+
+#include <cstdint>
+#include <cstdlib>
+
+// Allocation free weighted random selection of up to Capacity items.
+//
+// Items are ordered by descending weight (keeping the original order for equal weights) and a cumulative
+// table of the positive weights is built, so sampling is a single random number plus a binary search.
+// Given the same random generator state, this selects the same items as drawing a random number in
+// [0, total) and walking the list of items sorted by descending weight.
+template<size_t Capacity>
+class WeightedSampler {
+public:
+    WeightedSampler() {
+        clear();
+    }
+
+    void clear() {
+        _count = 0;
+        _positiveCount = 0;
+        _total = 0;
+    }
+
+    size_t capacity() const { return Capacity; }
+    size_t size() const { return _count; }
+
+    // sum of all weights
+    int total() const { return _total; }
+
+    // set item weights, the sampling table is only rebuilt if the weights have changed
+    void setWeights(const int *weights, size_t count) {
+        if (count > Capacity) {
+            count = Capacity;
+        }
+
+        bool changed = count != _count;
+        for (size_t i = 0; i < count && !changed; ++i) {
+            changed = weights[i] != _weights[i];
+        }
+        if (!changed) {
+            return;
+        }
+
+        _count = count;
+        _total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            _weights[i] = weights[i];
+            _total += weights[i];
+        }
+
+        rebuild();
+    }
+
+    // returns the index of the selected item, -1 if there are no items with positive weight
+    int sample(Random &rng) const {
+        if (_total == 0) {
+            return -1;
+        }
+
+        int rnd = rng.nextRange(_total);
+
+        // find first item with rnd <= cumulative weight
+        size_t lo = 0;
+        size_t hi = _positiveCount;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (rnd <= _cumulative[mid]) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+
+        return lo < _positiveCount ? _indices[lo] : -1;
+    }
+
+private:
+    void rebuild() {
+        // stable insertion sort by descending weight
+        for (size_t i = 0; i < _count; ++i) {
+            uint8_t index = i;
+            size_t j = i;
+            while (j > 0 && _weights[_indices[j - 1]] < _weights[index]) {
+                _indices[j] = _indices[j - 1];
+                --j;
+            }
+            _indices[j] = index;
+        }
+
+        // cumulative weights of items with positive weight
+        int sum = 0;
+        _positiveCount = 0;
+        while (_positiveCount < _count && _weights[_indices[_positiveCount]] > 0) {
+            sum += _weights[_indices[_positiveCount]];
+            _cumulative[_positiveCount++] = sum;
+        }
+    }
+
+    std::array<int, Capacity> _weights;
+    std::array<int, Capacity> _cumulative;
+    std::array<uint8_t, Capacity> _indices;
+    size_t _count;
+    size_t _positiveCount;
+    int _total;
+};
@@ -1,3 +1,6 @@
 #pragma once
 
 #define CCMRAM_BSS
+
+// used to keep data shared between threads on separate cache lines
+#define CACHE_LINE_SIZE 64
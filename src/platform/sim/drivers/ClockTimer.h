@@ -45,6 +45,11 @@ public:
         _listener = listener;
     }
 
+    // current time in the time base of clock ticks and received MIDI messages (simulated time)
+    static uint32_t us() {
+        return uint32_t(sim::Simulator::instance().ticks() * 1000.0);
+    }
+
 private:
     void update() {
         if (!_enabled) {
@@ -5,26 +5,69 @@
 
 #include "SystemConfig.h"
 
+#include "core/gfx/DirtyRegion.h"
+#include "core/gfx/FrameBufferDiff.h"
+
 #include <cstdint>
-#include <cstring>
 
 class Lcd {
 public:
     static constexpr int Width = CONFIG_LCD_WIDTH;
     static constexpr int Height = CONFIG_LCD_HEIGHT;
 
+    static constexpr size_t TxBufferSize = 2048;
+
+    struct FrameStats {
+        uint32_t frames;        // frames with changes sent to the display
+        uint32_t skipped;       // frames dropped because the previous frame was still being sent
+        uint32_t windows;       // windows sent
+        uint32_t bytesSent;     // pixel data bytes sent
+        uint32_t lastBytesSent; // pixel data bytes sent with the last frame
+    };
+
     Lcd() :
         _simulator(sim::Simulator::instance())
     {}
 
     void init() {}
 
-    void draw(uint8_t *frameBuffer) {
-        std::memcpy(_frameBuffer.data(), frameBuffer, _frameBuffer.size());
+    // accounts for the same partial updates as the hardware driver, the simulator is only updated on changes
+    bool draw(const uint8_t *frameBuffer, const DirtyRegion &region = DirtyRegion::full(Width, Height)) {
+        _diff.update(frameBuffer, region);
+
+        _frameStats.lastBytesSent = 0;
+        if (_diff.windowCount() == 0) {
+            return true;
+        }
+
+        if (_diff.changedSize() > TxBufferSize) {
+            _frameStats.lastBytesSent = Diff::Size;
+            _frameStats.windows += 1;
+        } else {
+            _frameStats.lastBytesSent = _diff.changedSize();
+            _frameStats.windows += _diff.windowCount();
+        }
+        _frameStats.bytesSent += _frameStats.lastBytesSent;
+        ++_frameStats.frames;
+
+        // unpack 4 bit frame
+        for (size_t i = 0; i < _frameBuffer.size(); i += 2) {
+            uint8_t pixels = *frameBuffer++;
+            _frameBuffer[i] = pixels >> 4;
+            _frameBuffer[i + 1] = pixels & 0xf;
+        }
         _simulator.writeLcd(_frameBuffer);
+
+        return true;
     }
 
+    const FrameStats &frameStats() const { return _frameStats; }
+
 private:
+    typedef FrameBufferDiff<Width, Height> Diff;
+
     sim::Simulator &_simulator;
     sim::FrameBuffer _frameBuffer;
+    Diff _diff;
+    FrameStats _frameStats = {};
 };
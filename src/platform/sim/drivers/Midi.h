@@ -1,11 +1,13 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/SpscQueue.h"
 
 #include "sim/Simulator.h"
 
+#include "ClockTimer.h"
+
 #include <functional>
-#include <deque>
 
 #include <cstdint>
 
@@ -26,31 +28,42 @@ public:
         return true;
     }
 
-    bool recv(MidiMessage *message) {
-        if (!_recvQueue.empty()) {
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
-            return true;
+    // receive a message, optionally returns the reception time (ClockTimer::us())
+    bool recv(MidiMessage *message, uint32_t *timestamp = nullptr) {
+        RecvMessage recvMessage;
+        if (!_recvQueue.pop(recvMessage)) {
+            return false;
+        }
+        *message = recvMessage.message;
+        if (timestamp) {
+            *timestamp = recvMessage.timestamp;
         }
-        return false;
+        return true;
     }
 
     void setRecvFilter(RecvFilter filter) {
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    uint32_t rxOverflow() const { return _recvQueue.overflowCount(); }
+    uint32_t rxHighWaterMark() const { return _recvQueue.highWaterMark(); }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
         if (event.port == 0 && event.kind == sim::MidiEvent::Message) {
             if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                _recvQueue.emplace_back(event.message);
+                _recvQueue.push({ ClockTimer::us(), event.message });
             }
         }
     }
 
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+
+    struct RecvMessage {
+        uint32_t timestamp;
+        MidiMessage message;
+    };
+
+    SpscQueue<RecvMessage, 64> _recvQueue;
     RecvFilter _recvFilter;
 };
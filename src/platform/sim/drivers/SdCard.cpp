@@ -0,0 +1,126 @@
+#include "SdCard.h"
+
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// function local, as cards may be constructed during static initialization
+static std::string &configuredPath() {
+    static std::string path = "sdcard.iso";
+    return path;
+}
+
+static size_t &configuredSectorCount() {
+    static size_t sectorCount = SdCard::DefaultSectorCount;
+    return sectorCount;
+}
+
+void SdCard::configure(const std::string &path, size_t sectorCount) {
+    configuredPath() = path;
+    configuredSectorCount() = sectorCount;
+}
+
+SdCard::SdCard() :
+    _path(configuredPath()),
+    _sectorCount(configuredSectorCount())
+{
+    _fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat st = {};
+    if (_fd != -1 && ::fstat(_fd, &st) == 0) {
+        // larger images are kept as is and used at their full size
+        _sectorCount = std::max(_sectorCount, size_t(st.st_size) / SectorSize);
+    }
+
+    _dirty.assign(_sectorCount, false);
+    _dirtyBegin = _sectorCount;
+    _stats.resize(_sectorCount);
+
+    size_t size = _sectorCount * SectorSize;
+
+    if (_fd != -1) {
+        // grow image to the configured size
+        if (size_t(st.st_size) >= size || ::ftruncate(_fd, size) == 0) {
+            void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<uint8_t *>(data);
+                _mapped = true;
+                return;
+            }
+        }
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    DBG("failed to map sd card image '%s', using memory", _path.c_str());
+    _data = new uint8_t[size]();
+    std::ifstream ifs(_path, std::ios::binary);
+    ifs.read(reinterpret_cast<char *>(_data), size);
+}
+
+SdCard::~SdCard() {
+    sync();
+    if (_mapped) {
+        ::munmap(_data, _sectorCount * SectorSize);
+        ::close(_fd);
+    } else {
+        delete [] _data;
+    }
+}
+
+void SdCard::sync() {
+    // write back runs of dirty sectors
+    size_t begin = _dirtyBegin;
+    while (begin < _dirtyEnd) {
+        while (begin < _dirtyEnd && !_dirty[begin]) {
+            ++begin;
+        }
+        size_t end = begin;
+        while (end < _dirtyEnd && _dirty[end]) {
+            _dirty[end] = false;
+            ++_stats[end].syncs;
+            ++end;
+        }
+        if (end > begin) {
+            writeBack(begin, end);
+        }
+        begin = end;
+    }
+    _dirtyBegin = _sectorCount;
+    _dirtyEnd = 0;
+}
+
+SdCard::SectorStats SdCard::totalStats() const {
+    SectorStats total;
+    for (const auto &stats : _stats) {
+        total.reads += stats.reads;
+        total.writes += stats.writes;
+        total.syncs += stats.syncs;
+    }
+    return total;
+}
+
+void SdCard::resetStats() {
+    std::fill(_stats.begin(), _stats.end(), SectorStats());
+}
+
+void SdCard::writeBack(size_t begin, size_t end) {
+    size_t offset = begin * SectorSize;
+    size_t length = (end - begin) * SectorSize;
+
+    if (_mapped) {
+        // msync requires a page aligned address
+        static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+        size_t alignedOffset = offset - offset % pageSize;
+        ::msync(_data + alignedOffset, length + offset - alignedOffset, MS_ASYNC);
+    } else {
+        std::fstream fs(_path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!fs.is_open()) {
+            fs.open(_path, std::ios::binary | std::ios::out);
+        }
+        fs.seekp(offset);
+        fs.write(reinterpret_cast<const char *>(_data + offset), length);
+    }
+}
@@ -2,21 +2,38 @@
 
 #include "core/Debug.h"
 
-#include <memory>
-#include <fstream>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include <cstring>
 #include <cstddef>
 #include <cstdint>
 
+// Simulated SD card backed by an image file.
+// The image is memory mapped, so reads and writes go directly to the mapped file. Written sectors are tracked and
+// only the pages containing dirty sectors are flushed on sync(). If the image cannot be mapped, the card is kept in
+// memory and dirty sectors are written to the image on sync().
+// Per sector read/write/sync counters allow to profile the access patterns of the filesystem.
 class SdCard {
 public:
-    SdCard() :
-        _data(new uint8_t[SectorCount * SectorSize])
-    {
-        std::ifstream ifs("sdcard.iso");
-        ifs.read(reinterpret_cast<char *>(_data.get()), SectorCount * SectorSize);
-    }
+    static constexpr size_t DefaultSectorCount = 1024;
+    static constexpr size_t SectorSize = 512;
+
+    struct SectorStats {
+        uint32_t reads = 0;
+        uint32_t writes = 0;
+        uint32_t syncs = 0;
+    };
+
+    // image path and size used by cards constructed afterwards, larger existing images are used at their full size
+    static void configure(const std::string &path, size_t sectorCount = DefaultSectorCount);
+
+    SdCard();
+    ~SdCard();
+
+    SdCard(const SdCard &) = delete;
+    SdCard &operator=(const SdCard &) = delete;
 
     void init() {
     }
@@ -29,30 +46,51 @@ public:
         return false;
     }
 
-    size_t sectorCount() const { return SectorCount; }
+    size_t sectorCount() const { return _sectorCount; }
     size_t sectorSize() const { return SectorSize; }
 
+    bool isMapped() const { return _mapped; }
+
     bool read(uint8_t *buf, uint32_t sector, uint8_t count) {
-        ASSERT(sector >= 0 && sector + count <= SectorCount, "invalid read range");
+        ASSERT(sector + count <= _sectorCount, "invalid read range");
         memcpy(buf, &_data[sector * SectorSize], count * SectorSize);
+        for (uint32_t i = sector; i < sector + count; ++i) {
+            ++_stats[i].reads;
+        }
         return true;
     }
 
     bool write(const uint8_t *buf, uint32_t sector, uint8_t count) {
-        ASSERT(sector >= 0 && sector + count <= SectorCount, "invalid write range");
+        ASSERT(sector + count <= _sectorCount, "invalid write range");
         memcpy(&_data[sector * SectorSize], buf, count * SectorSize);
+        for (uint32_t i = sector; i < sector + count; ++i) {
+            ++_stats[i].writes;
+            _dirty[i] = true;
+        }
+        _dirtyBegin = std::min(_dirtyBegin, size_t(sector));
+        _dirtyEnd = std::max(_dirtyEnd, size_t(sector + count));
         return true;
     }
 
-    void sync() {
-        std::ofstream ofs("sdcard.iso");
-        ofs.write(reinterpret_cast<const char *>(_data.get()), SectorCount * SectorSize);
-        ofs.close();
-    }
+    // flush dirty sectors to the image
+    void sync();
+
+    // access statistics
+
+    const SectorStats &sectorStats(size_t sector) const { return _stats[sector]; }
+    SectorStats totalStats() const;
+    void resetStats();
 
 private:
-    static constexpr size_t SectorCount = 1024;
-    static constexpr size_t SectorSize = 512;
+    void writeBack(size_t begin, size_t end);
 
-    std::unique_ptr<uint8_t[]> _data;
+    std::string _path;
+    size_t _sectorCount;
+    int _fd = -1;
+    bool _mapped = false;
+    uint8_t *_data = nullptr;
+    std::vector<bool> _dirty;
+    size_t _dirtyBegin;
+    size_t _dirtyEnd = 0;
+    std::vector<SectorStats> _stats;
 };
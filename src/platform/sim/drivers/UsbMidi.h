@@ -1,11 +1,13 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/utils/SpscQueue.h"
 
 #include "sim/Simulator.h"
 
+#include "ClockTimer.h"
+
 #include <functional>
-#include <deque>
 #include <memory>
 
 #include <cstdint>
@@ -29,14 +31,24 @@ public:
         return true;
     }
 
-    bool recv(uint8_t *cable, MidiMessage *message) {
-        if (!_recvQueue.empty()) {
-            *cable = 0;
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
-            return true;
+    bool sendLowPriority(uint8_t cable, const MidiMessage &message) {
+        return send(cable, message);
+    }
+
+    size_t txPending() const { return 0; }
+
+    // receive a message, optionally returns the reception time (ClockTimer::us())
+    bool recv(uint8_t *cable, MidiMessage *message, uint32_t *timestamp = nullptr) {
+        RecvMessage recvMessage;
+        if (!_recvQueue.pop(recvMessage)) {
+            return false;
         }
-        return false;
+        *cable = 0;
+        *message = recvMessage.message;
+        if (timestamp) {
+            *timestamp = recvMessage.timestamp;
+        }
+        return true;
     }
 
     void setConnectHandler(ConnectHandler handler) {
@@ -51,7 +63,8 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    uint32_t rxOverflow() const { return _recvQueue.overflowCount(); }
+    uint32_t rxHighWaterMark() const { return _recvQueue.highWaterMark(); }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
@@ -69,7 +82,7 @@ private:
                 break;
             case sim::MidiEvent::Message:
                 if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                    _recvQueue.emplace_back(event.message);
+                    _recvQueue.push({ ClockTimer::us(), event.message });
                 }
                 break;
             }
@@ -81,5 +94,11 @@ private:
     RecvFilter _recvFilter;
 
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+
+    struct RecvMessage {
+        uint32_t timestamp;
+        MidiMessage message;
+    };
+
+    SpscQueue<RecvMessage, 64> _recvQueue;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/Debug.h"
+#include "core/profiler/Profiler.h"
 
 #include "sim/Simulator.h"
 
@@ -31,9 +32,26 @@ namespace os {
     template<size_t StackSize>
     class PeriodicTask {
     public:
-        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func) {
+        PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func)
+#if CONFIG_ENABLE_PROFILER
+            : _interval(name, interval * 1000)
+#endif // CONFIG_ENABLE_PROFILER
+        {
+#if CONFIG_ENABLE_PROFILER
+            os::updateCallbacks().emplace_back([this, func] () {
+                _interval.begin();
+                func();
+                _interval.end();
+            });
+#else // CONFIG_ENABLE_PROFILER
             os::updateCallbacks().emplace_back(func);
+#endif // CONFIG_ENABLE_PROFILER
         }
+
+    private:
+#if CONFIG_ENABLE_PROFILER
+        Profiler::Interval _interval;
+#endif // CONFIG_ENABLE_PROFILER
     };
 
     inline void suspend(TaskHandle handle) {}
@@ -13,6 +13,10 @@
 #include "sim/TargetConfig.h"
 #include "sim/TargetUtils.h"
 
+#include "core/profiler/Profiler.h"
+
+#include "drivers/SdCard.h"
+
 #include "args.hxx"
 #include "tinyformat.h"
 
@@ -54,6 +58,8 @@ int Frontend::main(int argc, char *argv[]) {
     args::ArgumentParser parser("PER|FORMER Simulator", "");
     args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
     args::Flag showMidiPorts(parser, "midi", "Show available MIDI ports", { 'm', "midi" });
+    args::ValueFlag<std::string> sdCardImage(parser, "path", "SD card image (default: sdcard.iso)", { "sdcard" }, "sdcard.iso");
+    args::ValueFlag<int> sdCardSectors(parser, "sectors", "SD card size in sectors of 512 bytes", { "sdcard-sectors" }, int(SdCard::DefaultSectorCount));
 
     try {
         parser.ParseCLI(argc, argv);
@@ -71,6 +77,7 @@ int Frontend::main(int argc, char *argv[]) {
         return 0;
     }
 
+    SdCard::configure(args::get(sdCardImage), std::max(128, args::get(sdCardSectors)));
 
 
     run();
@@ -358,6 +365,26 @@ void Frontend::setupControls() {
         });
 
     }
+
+    // profiler
+    {
+        auto button = _window->createWidget<Button>(
+            Vector2f(x + 10, y + 20),
+            Vector2f(40, 20),
+            Button::Rectangle,
+            SDLK_F9
+        );
+        _window->createWidget<Label>(Vector2f(x, y + 60), Vector2f(60, 10), "PROFILER");
+        x += 70;
+
+        // dump profiler statistics to the console and start a new measurement
+        button->setCallback([&] (bool pressed) {
+            if (pressed) {
+                Profiler::dump();
+                Profiler::reset();
+            }
+        });
+    }
 }
 
 // // button label
@@ -1,3 +1,6 @@
 #pragma once
 
 #define CCMRAM_BSS __attribute__((section(".ccmram_bss")))
+
+// used to keep data shared between interrupts and tasks on separate cache lines (no data cache on the Cortex-M4)
+#define CACHE_LINE_SIZE 4
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "HighResolutionTimer.h"
+
 #include <cstdint>
 
 class ClockTimer {
@@ -19,6 +21,9 @@ public:
 
     void setListener(Listener *listener);
 
+    // current time in the time base of clock ticks and received MIDI messages
+    static uint32_t us() { return HighResolutionTimer::us(); }
+
 private:
     uint32_t _period = 0;
 };
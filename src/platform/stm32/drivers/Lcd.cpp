@@ -65,6 +65,8 @@ static InitCommand initCommands[] = {
     { 0x00 }
 };
 
+static Lcd *g_lcd;
+
 #ifdef LCD_USE_DMA
 static volatile uint32_t txDone = 1;
 #endif // LCD_USE_DMA
@@ -76,6 +78,8 @@ static inline void waitTxDone() {
 
 
 void Lcd::init() {
+    g_lcd = this;
+
     // init spi pins
     rcc_periph_clock_enable(RCC_GPIOB);
     rcc_periph_clock_enable(RCC_GPIOC);
@@ -123,66 +127,87 @@ void Lcd::init() {
     initialize();
 }
 
-void Lcd::draw(uint8_t *frameBuffer) {
+bool Lcd::draw(const uint8_t *frameBuffer, const DirtyRegion &region) {
 #ifdef LCD_USE_DMA
-    // wait until previous frame is sent
-    while (!txDone) {}
-    txDone = 0;
+    // drop the frame if the previous frame is still being sent,
+    // changes are picked up by the next frame as the shadow frame is not updated
+    if (!txDone) {
+        ++_frameStats.skipped;
+        return false;
+    }
 #endif // LCD_USE_DMA
 
-    // copy buffer
-    uint8_t *src = frameBuffer;
-    uint8_t *dst = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int i = 0; i < Width * Height / 2; ++i) {
-        uint8_t a = *src++;
-        uint8_t b = *src++;
-        *dst++ = std::min(b, uint8_t(15)) | (std::min(a, uint8_t(15)) << 4);
-        // *dst++ = (b >> 4) | ((a >> 4) << 4);
-    }
+    _diff.update(frameBuffer, region);
 
+    _frameStats.lastBytesSent = 0;
+    if (_diff.windowCount() == 0) {
+        return true;
+    }
 
-#ifdef LCD_USE_DMA
+    if (_diff.changedSize() > TxBufferSize) {
+        // send full frame directly from the shadow frame
+        _windows[0] = { 0, uint8_t(Diff::Columns - 1), 0, uint8_t(Height - 1) };
+        _windowCount = 1;
+        _windowData = _diff.data();
+    } else {
+        // gather changed windows
+        uint8_t *dst = reinterpret_cast<uint8_t *>(_txBuffer);
+        _windowCount = _diff.windowCount();
+        for (int i = 0; i < _windowCount; ++i) {
+            _windows[i] = _diff.window(i);
+            dst += _diff.copyWindow(_windows[i], dst);
+        }
+        _windowData = reinterpret_cast<const uint8_t *>(_txBuffer);
+    }
+    _windowIndex = 0;
 
-    setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
-    setWrite();
+    for (int i = 0; i < _windowCount; ++i) {
+        _frameStats.lastBytesSent += _windows[i].size();
+    }
+    _frameStats.bytesSent += _frameStats.lastBytesSent;
+    _frameStats.windows += _windowCount;
+    ++_frameStats.frames;
 
-    waitTxDone();
-    gpio_set(LCD_PORT, LCD_DC);
+#ifdef LCD_USE_DMA
 
-    dma_stream_reset(LCD_DMA, LCD_DMA_STREAM);
-    dma_set_peripheral_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(&LCD_SPI_DR));
-    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(_frameBuffer));
-    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, sizeof(_frameBuffer));
-    dma_channel_select(LCD_DMA, LCD_DMA_STREAM, LCD_DMA_CHANNEL);
-    dma_set_priority(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PL_HIGH);
+    txDone = 0;
+    setWindow(_windows[0]);
+    sendWindow(_windowData, _windows[0].size());
 
-    dma_set_transfer_mode(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
-    dma_set_memory_size(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_MSIZE_8BIT);
-    dma_set_peripheral_size(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PSIZE_8BIT);
+#else // LCD_USE_DMA
 
-    dma_enable_memory_increment_mode(LCD_DMA, LCD_DMA_STREAM);
-    dma_disable_peripheral_increment_mode(LCD_DMA, LCD_DMA_STREAM);
+    const uint8_t *src = _windowData;
+    for (int i = 0; i < _windowCount; ++i) {
+        setWindow(_windows[i]);
+        for (size_t j = 0; j < _windows[i].size(); ++j) {
+            sendData(*src++);
+        }
+    }
 
-    dma_enable_transfer_complete_interrupt(LCD_DMA, LCD_DMA_STREAM);
+#endif // LCD_USE_DMA
 
-    dma_enable_stream(LCD_DMA, LCD_DMA_STREAM);
+    return true;
+}
 
-    spi_enable_tx_dma(LCD_SPI);
+void Lcd::handleIrq() {
+#ifdef LCD_USE_DMA
+    if (dma_get_interrupt_flag(LCD_DMA, LCD_DMA_STREAM, DMA_TCIF)) {
+        dma_clear_interrupt_flags(LCD_DMA, LCD_DMA_STREAM, DMA_TCIF);
+        dma_disable_stream(LCD_DMA, LCD_DMA_STREAM);
 
-#else // LCD_USE_DMA
+        spi_disable_tx_dma(LCD_SPI);
 
-    setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
-    setWrite();
+        waitTxDone();
 
-    src = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int y = 0; y < Height; y++) {
-        for (int x = 0; x < Width/2; x++) {
-            sendData(*src++);
+        // continue with next window
+        _windowData += _windows[_windowIndex].size();
+        if (++_windowIndex < _windowCount) {
+            setWindow(_windows[_windowIndex]);
+            sendWindow(_windowData, _windows[_windowIndex].size());
+        } else {
+            txDone = 1;
         }
     }
-
 #endif // LCD_USE_DMA
 }
 
@@ -228,17 +253,42 @@ void Lcd::setWrite() {
     sendCmd(0x5C);
 }
 
+void Lcd::setWindow(const Diff::Window &window) {
+    // panel columns start at column address 0x1c, each column address holds 4 pixels
+    setColAddr(0x1c + window.col0, 0x1c + window.col1);
+    setRowAddr(window.row0, window.row1);
+    setWrite();
+}
+
+void Lcd::sendWindow(const uint8_t *data, size_t size) {
 #ifdef LCD_USE_DMA
-void dma1_stream4_isr(void) {
-    if (dma_get_interrupt_flag(LCD_DMA, LCD_DMA_STREAM, DMA_TCIF)) {
-        dma_clear_interrupt_flags(LCD_DMA, LCD_DMA_STREAM, DMA_TCIF);
-        dma_disable_stream(LCD_DMA, LCD_DMA_STREAM);
+    waitTxDone();
+    gpio_set(LCD_PORT, LCD_DC);
 
-        spi_disable_tx_dma(LCD_SPI);
+    dma_stream_reset(LCD_DMA, LCD_DMA_STREAM);
+    dma_set_peripheral_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(&LCD_SPI_DR));
+    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(data));
+    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, size);
+    dma_channel_select(LCD_DMA, LCD_DMA_STREAM, LCD_DMA_CHANNEL);
+    dma_set_priority(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PL_HIGH);
 
-        waitTxDone();
+    dma_set_transfer_mode(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    dma_set_memory_size(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_MSIZE_8BIT);
+    dma_set_peripheral_size(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PSIZE_8BIT);
 
-        txDone = 1;
-    }
+    dma_enable_memory_increment_mode(LCD_DMA, LCD_DMA_STREAM);
+    dma_disable_peripheral_increment_mode(LCD_DMA, LCD_DMA_STREAM);
+
+    dma_enable_transfer_complete_interrupt(LCD_DMA, LCD_DMA_STREAM);
+
+    dma_enable_stream(LCD_DMA, LCD_DMA_STREAM);
+
+    spi_enable_tx_dma(LCD_SPI);
+#endif // LCD_USE_DMA
+}
+
+#ifdef LCD_USE_DMA
+void dma1_stream4_isr(void) {
+    g_lcd->handleIrq();
 }
 #endif // LCD_USE_DMA
@@ -2,6 +2,9 @@
 
 #include "SystemConfig.h"
 
+#include "core/gfx/DirtyRegion.h"
+#include "core/gfx/FrameBufferDiff.h"
+
 #include <cstdint>
 #include <cstdlib>
 
@@ -10,11 +13,30 @@ public:
     static constexpr int Width = CONFIG_LCD_WIDTH;
     static constexpr int Height = CONFIG_LCD_HEIGHT;
 
+    // changed windows are gathered into the transmit buffer, larger updates send the full frame
+    static constexpr size_t TxBufferSize = 2048;
+
+    struct FrameStats {
+        uint32_t frames;        // frames with changes sent to the display
+        uint32_t skipped;       // frames dropped because the previous frame was still being sent
+        uint32_t windows;       // windows sent
+        uint32_t bytesSent;     // pixel data bytes sent
+        uint32_t lastBytesSent; // pixel data bytes sent with the last frame
+    };
+
     void init();
 
-    void draw(uint8_t *frameBuffer);
+    // send the changed pixels of the 4 bit frame buffer to the display, only pixels within the dirty region are
+    // compared with the previous frame, returns false if the previous frame is still being sent (frame is dropped)
+    bool draw(const uint8_t *frameBuffer, const DirtyRegion &region = DirtyRegion::full(Width, Height));
+
+    const FrameStats &frameStats() const { return _frameStats; }
+
+    void handleIrq();
 
 private:
+    typedef FrameBufferDiff<Width, Height> Diff;
+
     void sendCmd(uint8_t cmd);
     void sendData(uint8_t data);
 
@@ -24,5 +46,17 @@ private:
     void setRowAddr(uint8_t a, uint8_t b);
     void setWrite();
 
-    uint32_t _frameBuffer[Width * Height / 8];
+    void setWindow(const Diff::Window &window);
+    void sendWindow(const uint8_t *data, size_t size);
+
+    Diff _diff;
+    uint32_t _txBuffer[TxBufferSize / 4];
+
+    // pending windows of the current transfer
+    Diff::Window _windows[Diff::MaxWindows];
+    const uint8_t *_windowData;
+    int _windowCount;
+    int _windowIndex;
+
+    FrameStats _frameStats = {};
 };
@@ -1,4 +1,5 @@
 #include "Midi.h"
+#include "ClockTimer.h"
 
 #include "SystemConfig.h"
 
@@ -45,10 +46,14 @@ bool Midi::send(const MidiMessage &message) {
     return true;
 }
 
-bool Midi::recv(MidiMessage *message) {
-    while (!_rxBuffer.empty()) {
-        if (_midiParser.feed(_rxBuffer.read())) {
+bool Midi::recv(MidiMessage *message, uint32_t *timestamp) {
+    RxData rxData;
+    while (_rxQueue.pop(rxData)) {
+        if (_midiParser.feed(rxData.data)) {
             *message = _midiParser.message();
+            if (timestamp) {
+                *timestamp = rxData.timestamp;
+            }
             return true;
         }
     }
@@ -92,11 +97,8 @@ void Midi::handleIrq() {
     if (usart_get_flag(MIDI_USART, USART_SR_RXNE)) {
         uint8_t data = usart_recv(MIDI_USART);
         if (!_recvFilter || !_recvFilter(data)) {
-            if (_rxBuffer.full()) {
-                // overflow
-                ++_rxOverflow;
-            }
-            _rxBuffer.write(data);
+            // drops and counts data on overflow
+            _rxQueue.push({ ClockTimer::us(), data });
         }
     }
 }
@@ -3,6 +3,7 @@
 #include "core/midi/MidiMessage.h"
 #include "core/midi/MidiParser.h"
 #include "core/utils/RingBuffer.h"
+#include "core/utils/SpscQueue.h"
 
 #include <functional>
 
@@ -15,19 +16,25 @@ public:
     void init();
 
     bool send(const MidiMessage &message);
-    bool recv(MidiMessage *message);
+    // receive a message, optionally returns the reception time of the last byte (ClockTimer::us())
+    bool recv(MidiMessage *message, uint32_t *timestamp = nullptr);
 
     void setRecvFilter(RecvFilter filter);
 
-    uint32_t rxOverflow() const { return _rxOverflow; }
+    uint32_t rxOverflow() const { return _rxQueue.overflowCount(); }
+    uint32_t rxHighWaterMark() const { return _rxQueue.highWaterMark(); }
 
     void handleIrq();
 private:
     void send(uint8_t data);
 
     RingBuffer<uint8_t, 64> _txBuffer;
-    RingBuffer<uint8_t, 64> _rxBuffer;
-    volatile uint32_t _rxOverflow = 0;
+    struct RxData {
+        uint32_t timestamp;
+        uint8_t data;
+    };
+
+    SpscQueue<RxData, 64> _rxQueue;
     volatile uint32_t _txActive = 0;
 
     RecvFilter _recvFilter;
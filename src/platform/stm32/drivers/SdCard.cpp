@@ -69,14 +69,7 @@ bool SdCard::read(uint8_t *buf, uint32_t sector, uint8_t count) {
 
 bool SdCard::write(const uint8_t *buf, uint32_t sector, uint8_t count) {
     // DBG("write(sector=%d,count=%d)", sector, count);
-    const uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!writeBlock(sector + i, data)) {
-            return false;
-        }
-        data += 512;
-    }
-    return true;
+    return count > 0 ? writeBlocks(sector, buf, count) : true;
 }
 
 bool SdCard::cardDetect() const {
@@ -392,9 +385,10 @@ bool SdCard::readBlock(uint32_t address, void *buffer) {
     return true;
 }
 
-bool SdCard::writeBlock(uint32_t address, const void *buffer) {
+// writes multiple blocks in a single transfer (CMD25) to avoid the per block command and programming overhead
+bool SdCard::writeBlocks(uint32_t address, const void *buffer, uint32_t count) {
     ASSERT(buffer >= (void *)0x20000000, "buffer not in SRAM");
-    // DBG("writeBlock(address=%lu, buffer=%p)", address, buffer);
+    // DBG("writeBlocks(address=%lu, buffer=%p, count=%lu)", address, buffer, count);
     if (!waitDataReady()) {
         return false;
     }
@@ -406,7 +400,9 @@ bool SdCard::writeBlock(uint32_t address, const void *buffer) {
         }
     }
 
-    if (sendCommandWait(24, address) != Success) {
+    bool multiple = count > 1;
+
+    if (sendCommandWait(multiple ? 25 : 24, address) != Success) {
         return false;
     }
 
@@ -438,18 +434,19 @@ bool SdCard::writeBlock(uint32_t address, const void *buffer) {
     dma_enable_stream(DMA2, DMA_STREAM3);
 #endif
 
-    // A 500ms timeout expressed as ticks in the 24Mhz bus clock.
+    // A 500ms timeout (per block) expressed as ticks in the 24Mhz bus clock.
     SDIO_DTIMER = 12000000;
     // These two registers must be set before SDIO_DCTRL.
-    SDIO_DLEN = 512;
+    SDIO_DLEN = 512 * count;
     SDIO_DCTRL = SDIO_DCTRL_DBLOCKSIZE_9 | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN;
 
     const uint32_t DATA_TX_ERROR_FLAGS = (SDIO_STA_STBITERR |
                                           SDIO_STA_TXUNDERR |
                                           SDIO_STA_DTIMEOUT |
                                           SDIO_STA_DCRCFAIL);
-    const uint32_t DATA_TX_SUCCESS_FLAGS = (SDIO_STA_DBCKEND |
-                                            SDIO_STA_DATAEND);
+    // block end is signaled after every block, wait for the end of all data when writing multiple blocks
+    const uint32_t DATA_TX_SUCCESS_FLAGS = multiple ? SDIO_STA_DATAEND : (SDIO_STA_DBCKEND |
+                                                                          SDIO_STA_DATAEND);
 
     while (!dma_get_interrupt_flag(DMA2, DMA_STREAM3, DMA_TCIF)) {
         // allow other tasks to run
@@ -462,6 +459,9 @@ bool SdCard::writeBlock(uint32_t address, const void *buffer) {
         // DBG("FIFOCNT = %d", SDIO_FIFOCNT);
         if (result & (DATA_TX_SUCCESS_FLAGS | DATA_TX_ERROR_FLAGS)) {
             if (result & DATA_TX_ERROR_FLAGS) {
+                if (multiple) {
+                    sendCommandWait(12, 0);
+                }
                 return false;
             } else if (result & DATA_TX_SUCCESS_FLAGS) {
                 break;
@@ -472,5 +472,10 @@ bool SdCard::writeBlock(uint32_t address, const void *buffer) {
         os::this_task::yield();
     }
 
+    // stop transmission, the card signals busy while programming which is handled by waitDataReady()
+    if (multiple && sendCommandRetry(12, 0) != Success) {
+        return false;
+    }
+
     return true;
 }
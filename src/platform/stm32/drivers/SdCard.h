@@ -56,7 +56,7 @@ private:
     bool waitDataReady();
 
     bool readBlock(uint32_t address, void *buffer);
-    bool writeBlock(uint32_t address, const void *buffer);
+    bool writeBlocks(uint32_t address, const void *buffer, uint32_t count);
 
     bool _initialized = false;
     CardInfo _cardInfo;
@@ -48,6 +48,12 @@ static size_t writeBufferSize;
 static size_t writeBufferIndex;
 static size_t writeBufferPos;
 
+// sysex message split across packets, continued with the next packet
+static MidiMessage sysExMessage;
+static uint8_t sysExDevice;
+static uint8_t sysExCable;
+static size_t sysExIndex;
+
 struct MidiDriverHandler {
 
     static void connectHandler(int device, uint16_t vendorId, uint16_t productId, uint32_t maxPacketSize) {
@@ -59,6 +65,9 @@ struct MidiDriverHandler {
     static void disconnectHandler(int device) {
         DBG("MIDI device disconnected (id=%d)", device);
         g_usbh->midiDisconnectDevice(device);
+        if (sysExPending() && sysExDevice == device) {
+            sysExMessage = MidiMessage();
+        }
     }
 
     static void recvHandler(int device, uint8_t *data) {
@@ -99,83 +108,116 @@ struct MidiDriverHandler {
         }
     }
 
+    // writes a message to the write buffer, returns true if the write buffer was flushed
     static bool write(uint8_t device, uint8_t cable, const MidiMessage &message) {
-        bool flushed = true;
-
         if (message.isSystemExclusive()) {
-            const uint8_t *payloadData = message.payloadData();
-            size_t payloadLength = message.payloadLength();
-            if (payloadData && payloadLength > 0) {
-                size_t messageLength = payloadLength + 2;
-                size_t writeSize = ((messageLength + 3) / 4) * 4;
-                if (writeBufferPos + writeSize >= writeBufferSize) {
-                    flush(device);
-                    flushed = true;
+            if (message.payloadData() && message.payloadLength() > 0) {
+                sysExMessage = message;
+                sysExDevice = device;
+                sysExCable = cable;
+                sysExIndex = 0;
+                return writeSysEx();
+            }
+            return false;
+        }
+
+        bool flushed = false;
+        if (writeBufferPos + 4 > writeBufferSize) {
+            flushed = flush(device);
+        }
+        uint8_t *p = &writeBuffer[writeBufferIndex][writeBufferPos];
+        p[0] = message.status() >> 4 | (cable << 4);
+        p[1] = message.status();
+        p[2] = message.data0();
+        p[3] = message.data1();
+        writeBufferPos += 4;
+
+        return flushed;
+    }
+
+    static bool sysExPending() {
+        return sysExMessage.hasPayload();
+    }
+
+    // writes the pending sysex message, each usb midi event carries 3 bytes of the message
+    // messages that fit into a packet are not split, larger messages are written in chunks of one packet, the
+    // remainder is kept pending if the write buffer was flushed already (one packet is sent per process() call)
+    // returns true if the write buffer was flushed
+    static bool writeSysEx() {
+        const uint8_t *payloadData = sysExMessage.payloadData();
+        size_t messageLength = sysExMessage.payloadLength() + 2;
+        uint8_t device = sysExDevice;
+        bool flushed = false;
+
+        if (sysExIndex == 0) {
+            size_t writeSize = ((messageLength + 2) / 3) * 4;
+            if (writeSize <= writeBufferSize && writeBufferPos + writeSize > writeBufferSize) {
+                flushed = flush(device);
+            }
+        }
+
+        while (sysExIndex < messageLength) {
+            if (writeBufferPos + 4 > writeBufferSize) {
+                if (flushed) {
+                    return true;
                 }
+                flushed = flush(device);
+            }
 
-                size_t messageIndex = 0;
-                while (messageIndex < messageLength) {
-                    uint8_t *p = &writeBuffer[writeBufferIndex][writeBufferPos];
-                    size_t chunkSize;
-                    switch (messageLength - messageIndex) {
-                    case 1:
-                        p[0] = 0x5;
-                        chunkSize = 1;
-                        break;
-                    case 2:
-                        p[0] = 0x6;
-                        chunkSize = 2;
-                        break;
-                    case 3:
-                        p[0] = 0x7;
-                        chunkSize = 3;
-                        break;
-                    default:
-                        p[0] = 0x4;
-                        chunkSize = 3;
-                        break;
-                    }
-                    p[0] |= cable << 4;
-                    for (size_t i = 0; i < chunkSize; ++i) {
-                        uint8_t byte;
-                        if (messageIndex == 0) {
-                            byte = 0xf0;
-                        } else if (messageIndex == messageLength - 1) {
-                            byte = 0xf7;
-                        } else {
-                            byte = payloadData[messageIndex - 1];
-                        }
-                        p[1 + i] = byte;
-                        ++messageIndex;
-                    }
-                    for (size_t i = chunkSize; i < 3; ++i) {
-                        p[1 + i] = 0;
-                    }
-                    writeBufferPos += 4;
+            uint8_t *p = &writeBuffer[writeBufferIndex][writeBufferPos];
+            size_t chunkSize;
+            switch (messageLength - sysExIndex) {
+            case 1:
+                p[0] = 0x5;
+                chunkSize = 1;
+                break;
+            case 2:
+                p[0] = 0x6;
+                chunkSize = 2;
+                break;
+            case 3:
+                p[0] = 0x7;
+                chunkSize = 3;
+                break;
+            default:
+                p[0] = 0x4;
+                chunkSize = 3;
+                break;
+            }
+            p[0] |= sysExCable << 4;
+            for (size_t i = 0; i < chunkSize; ++i) {
+                uint8_t byte;
+                if (sysExIndex == 0) {
+                    byte = 0xf0;
+                } else if (sysExIndex == messageLength - 1) {
+                    byte = 0xf7;
+                } else {
+                    byte = payloadData[sysExIndex - 1];
                 }
+                p[1 + i] = byte;
+                ++sysExIndex;
             }
-        } else {
-            if (writeBufferPos + 4 >= writeBufferSize) {
-                flush(device);
-                flushed = true;
+            for (size_t i = chunkSize; i < 3; ++i) {
+                p[1 + i] = 0;
             }
-            uint8_t *p = &writeBuffer[writeBufferIndex][writeBufferPos];
-            p[0] = message.status() >> 4 | (cable << 4);
-            p[1] = message.status();
-            p[2] = message.data0();
-            p[3] = message.data1();
             writeBufferPos += 4;
         }
 
+        // release the payload
+        sysExMessage = MidiMessage();
+
         return flushed;
     }
 
-    static void flush(uint8_t device) {
+    // returns true if the write buffer was sent
+    static bool flush(uint8_t device) {
         if (writeBufferPos > 0) {
             usbh_midi_write(device, writeBuffer[writeBufferIndex], writeBufferPos, &writeCallback);
             writeBufferIndex = (writeBufferIndex + 1) % 2;
             writeBufferPos = 0;
+            return true;
         }
+        return false;
     }
 
     static void writeCallback(uint8_t bytes_written) {
@@ -226,16 +268,17 @@ void UsbH::process() {
     usbh_poll(time_us);
 
     // Start sending MIDI messages
-    uint8_t device;
+    uint8_t device = 0;
     uint8_t cable;
     MidiMessage message;
     bool flushed = false;
-    while (midiDequeueMessage(&device, &cable, &message)) {
+    if (MidiDriverHandler::sysExPending()) {
+        device = sysExDevice;
+        flushed = MidiDriverHandler::writeSysEx();
+    }
+    while (!flushed && midiDequeueMessage(&device, &cable, &message)) {
         if (midiDeviceConnected(device)) {
             flushed = MidiDriverHandler::write(device, cable, message);
-            if (flushed) {
-                break;
-            }
         }
     }
     if (!flushed) {
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "core/utils/RingBuffer.h"
+#include "core/utils/SpscQueue.h"
 #include "core/midi/MidiMessage.h"
 
+#include "ClockTimer.h"
+
 #include <functional>
 
 #include <cstdint>
@@ -23,13 +26,29 @@ public:
         return true;
     }
 
-    bool recv(uint8_t *cable, MidiMessage *message) {
-        if (_rxQueue.empty()) {
+    // send a message with low priority, it is only transmitted once all messages queued with send() are transmitted
+    bool sendLowPriority(uint8_t cable, const MidiMessage &message) {
+        if (_txLowPriorityQueue.full()) {
             return false;
         }
-        auto cableAndMessage = _rxQueue.read();
-        *cable = cableAndMessage.cable;
-        *message = cableAndMessage.message;
+        _txLowPriorityQueue.write({ cable, message });
+        return true;
+    }
+
+    // number of messages waiting for transmission
+    size_t txPending() const { return _txQueue.readable() + _txLowPriorityQueue.readable(); }
+
+    // receive a message, optionally returns the reception time (ClockTimer::us())
+    bool recv(uint8_t *cable, MidiMessage *message, uint32_t *timestamp = nullptr) {
+        RxMessage rxMessage;
+        if (!_rxQueue.pop(rxMessage)) {
+            return false;
+        }
+        *cable = rxMessage.cable;
+        *message = rxMessage.message;
+        if (timestamp) {
+            *timestamp = rxMessage.timestamp;
+        }
         return true;
     }
 
@@ -45,7 +64,8 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    uint32_t rxOverflow() const { return _rxQueue.overflowCount(); }
+    uint32_t rxHighWaterMark() const { return _rxQueue.highWaterMark(); }
 
 private:
     void connect(uint16_t vendorId, uint16_t productId) {
@@ -61,11 +81,8 @@ private:
     }
 
     void enqueueMessage(uint8_t cable, const MidiMessage &message) {
-        if (_rxQueue.full()) {
-            // overflow
-            ++_rxOverflow;
-        }
-        _rxQueue.write({ cable, message });
+        // drops and counts messages on overflow
+        _rxQueue.push({ ClockTimer::us(), cable, message });
     }
 
     void enqueueData(uint8_t cable, uint8_t data) {
@@ -75,10 +92,14 @@ private:
     }
 
     bool dequeueMessage(uint8_t *cable, MidiMessage *message) {
-        if (_txQueue.empty()) {
+        CableAndMessage messageAndCable;
+        if (!_txQueue.empty()) {
+            messageAndCable = _txQueue.readAndReplace();
+        } else if (!_txLowPriorityQueue.empty()) {
+            messageAndCable = _txLowPriorityQueue.readAndReplace();
+        } else {
             return false;
         }
-        auto messageAndCable = _txQueue.readAndReplace();
         *cable = messageAndCable.cable;
         *message = messageAndCable.message;
         return true;
@@ -93,9 +114,15 @@ private:
         MidiMessage message;
     };
 
+    struct RxMessage {
+        uint32_t timestamp;
+        uint8_t cable;
+        MidiMessage message;
+    };
+
     RingBuffer<CableAndMessage, 128> _txQueue;
-    RingBuffer<CableAndMessage, 16> _rxQueue;
-    volatile uint32_t _rxOverflow = 0;
+    RingBuffer<CableAndMessage, 64> _txLowPriorityQueue;
+    SpscQueue<RxMessage, 16> _rxQueue;
 
     friend class UsbH;
 };
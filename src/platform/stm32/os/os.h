@@ -3,6 +3,7 @@
 #include "SystemConfig.h"
 
 #include "core/Debug.h"
+#include "core/profiler/Profiler.h"
 
 extern "C" {
 #include "FreeRTOS.h"
@@ -265,15 +266,30 @@ namespace os {
     class PeriodicTask : public Task<StackSize> {
     public:
         PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func) :
-            Task<StackSize>(name, priority, [interval, func] () {
+            Task<StackSize>(name, priority, [this, interval, func] () {
                 uint32_t lastWakeupTime = os::ticks();
                 while (true) {
+#if CONFIG_ENABLE_PROFILER
+                    _interval.begin();
                     func();
+                    _interval.end();
+#else // CONFIG_ENABLE_PROFILER
+                    func();
+#endif // CONFIG_ENABLE_PROFILER
                     os::delayUntil(lastWakeupTime, interval);
                 }
             })
+#if CONFIG_ENABLE_PROFILER
+            , _interval(name, interval * (1000000 / configTICK_RATE_HZ))
+#endif // CONFIG_ENABLE_PROFILER
         {
         }
+
+    private:
+#if CONFIG_ENABLE_PROFILER
+        // execution time of a single period measured against the task period
+        Profiler::Interval _interval;
+#endif // CONFIG_ENABLE_PROFILER
     };
 
 } // namespace os
@@ -0,0 +1,118 @@
+#include "IntegrationTest.h"
+
+#include "core/fs/FileSystem.h"
+#include "core/fs/FileWriter.h"
+#include "core/fs/FileReader.h"
+
+#include "drivers/SdCard.h"
+
+#include <algorithm>
+
+#include <cstring>
+
+// Measures write throughput and the number of block device calls of FileWriter with different buffer sizes,
+// write patterns and preallocation.
+class FileSystemBenchmark : public IntegrationTest {
+public:
+    FileSystemBenchmark() :
+        volume(sdCard)
+    {}
+
+#ifdef PLATFORM_SIM
+    // use a separate image large enough to get clusters of multiple sectors like on real cards
+    struct SimSdCardConfig {
+        SimSdCardConfig() { SdCard::configure("benchmark.iso", 64 * 1024); }
+    };
+#endif
+
+    void init() override {
+        sdCard.init();
+    }
+
+    void once() override {
+        fsAssert(volume.format(), fs::OK, "failed to format volume");
+        fsAssert(volume.mount(), fs::OK, "failed to mount volume");
+
+        for (size_t i = 0; i < DataLength / 4; ++i) {
+            data[i] = i * 0x9e3779b9;
+        }
+
+        DBG("%-36s %8s %8s %8s %8s %8s", "test", "time", "kB/s", "writes", "sectors", "syncs");
+        benchmark("small writes", 4, 0, false);
+        benchmark("small writes, preallocated", 4, 0, true);
+        benchmark("small writes, 4k buffer", 4, 4096, false);
+        benchmark("2k writes", 2048, 0, false);
+        benchmark("2k writes, preallocated", 2048, 0, true);
+        benchmark("unaligned 2k writes, 4k buffer", 2047, 4096, false);
+        benchmark("unaligned 2k writes, 4k buffer, pre", 2047, 4096, true);
+        benchmark("whole file", DataLength, 0, true);
+
+        fsAssert(volume.unmount(), fs::OK, "failed to unmount volume");
+    }
+
+    void fsAssert(fs::Error actual, fs::Error expected, const char *msg) {
+        EXPECT(actual == expected, "%s (actual: %s, expected: %s)", msg, fs::errorToString(actual), fs::errorToString(expected));
+    }
+
+    void writeFile(fs::FileWriter &writer, size_t writeSize, bool preallocate) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        if (preallocate) {
+            fsAssert(writer.preallocate(DataLength), fs::OK, "failed to preallocate");
+        }
+        for (size_t offset = 0; offset < DataLength; offset += writeSize) {
+            fsAssert(writer.write(src + offset, std::min(writeSize, DataLength - offset)), fs::OK, "failed to write");
+        }
+        fsAssert(writer.finish(), fs::OK, "failed to finish writing");
+    }
+
+    void benchmark(const char *name, size_t writeSize, size_t bufferSize, bool preallocate) {
+        const char *filename = "bench.dat";
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+
+        fs::resetIoStats();
+        timer.reset();
+        if (bufferSize > 0) {
+            fs::FileWriter writer(filename, buffer, bufferSize);
+            writeFile(writer, writeSize, preallocate);
+        } else {
+            fs::FileWriter writer(filename);
+            writeFile(writer, writeSize, preallocate);
+        }
+        uint32_t time = timer.elapsed();
+        auto stats = fs::ioStats();
+
+        DBG("%-36s %6dus %8d %8d %8d %8d", name, int(time), int(time > 0 ? uint64_t(DataLength) * 1000000 / 1024 / time : 0),
+            int(stats.writeCalls), int(stats.sectorsWritten), int(stats.syncCalls));
+
+        // verify
+        fs::FileReader reader(filename);
+        static uint8_t buf[512];
+        for (size_t offset = 0; offset < DataLength; offset += sizeof(buf)) {
+            fsAssert(reader.read(buf, sizeof(buf)), fs::OK, "failed to read");
+            EXPECT(std::memcmp(buf, src + offset, sizeof(buf)) == 0, "read invalid data");
+        }
+        fsAssert(reader.finish(), fs::OK, "failed to finish reading");
+        fs::File file(filename, fs::File::Read);
+        EXPECT(file.size() == DataLength, "invalid file size");
+        file.close();
+        fsAssert(fs::remove(filename), fs::OK, "failed to remove file");
+    }
+
+private:
+    static constexpr size_t DataLength = 64 * 1024;
+
+#ifdef PLATFORM_SIM
+    SimSdCardConfig simSdCardConfig;
+#endif
+    SdCard sdCard;
+    fs::Volume volume;
+    Timer timer;
+
+    static uint32_t data[DataLength / 4];
+    static uint32_t buffer[4096 / 4];
+};
+
+uint32_t FileSystemBenchmark::data[FileSystemBenchmark::DataLength / 4];
+uint32_t FileSystemBenchmark::buffer[4096 / 4];
+
+INTEGRATION_TEST(FileSystemBenchmark, "FileSystemBenchmark", false)
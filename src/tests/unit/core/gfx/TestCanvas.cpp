@@ -0,0 +1,252 @@
+#include "UnitTest.h"
+
+#include "core/gfx/Canvas.h"
+#include "core/hash/FnvHash.h"
+#include "core/utils/Random.h"
+#include "core/utils/StringBuilder.h"
+
+#include <cstdint>
+
+static const int Width = 256;
+static const int Height = 64;
+
+static const int SceneCount = 6;
+
+static float randomCoord(Random &rng, int size) {
+    return int(rng.nextRange(size + 40)) - 20 + rng.nextRange(100) / 100.f;
+}
+
+static void drawScene(Canvas &canvas, int scene, uint32_t seed) {
+    Random rng(seed);
+    auto randomInt = [&] (int min, int max) { return min + int(rng.nextRange(max - min + 1)); };
+    auto randomColor = [&] () { canvas.setColorValue(rng.nextRange(16)); };
+
+    canvas.setBlendMode(BlendMode::Set);
+    canvas.setColor(Color::None);
+    canvas.fill();
+
+    switch (scene) {
+    case 0:
+        // text on a gradient background
+        for (int x = 0; x < Width; ++x) {
+            canvas.setColorValue(x % 16);
+            canvas.vline(x, 0, Height);
+        }
+        for (int i = 0; i < 12; ++i) {
+            canvas.setFont(rng.nextRange(2) ? Font::Tiny : Font::Small);
+            canvas.setBlendMode(rng.nextRange(2) ? BlendMode::Add : BlendMode::Set);
+            randomColor();
+            canvas.drawText(randomInt(-10, Width + 2), randomInt(-4, Height + 8), "Hello World! 0123456789");
+        }
+        canvas.setBlendMode(BlendMode::Set);
+        canvas.setColor(Color::Bright);
+        canvas.drawTextCentered(0, 0, Width, 16, "CENTERED");
+        canvas.drawTextAligned(0, 40, Width, 20, HorizontalAlign::Right, VerticalAlign::Bottom, "RIGHT");
+        canvas.drawTextMultiline(3, 20, 60, "a multiline text that wraps around\nand breaks");
+        break;
+    case 1:
+        // rectangles and lines, a few additive
+        for (int i = 0; i < 40; ++i) {
+            randomColor();
+            switch (rng.nextRange(4)) {
+            case 0: canvas.fillRect(randomInt(-20, Width), randomInt(-20, Height), randomInt(0, 80), randomInt(0, 30)); break;
+            case 1: canvas.drawRect(randomInt(-20, Width), randomInt(-20, Height), randomInt(1, 80), randomInt(1, 30)); break;
+            case 2: canvas.hline(randomInt(-20, Width), randomInt(-2, Height + 1), randomInt(0, 300)); break;
+            case 3: canvas.vline(randomInt(-2, Width + 1), randomInt(-20, Height), randomInt(0, 80)); break;
+            }
+        }
+        canvas.setBlendMode(BlendMode::Add);
+        for (int i = 0; i < 8; ++i) {
+            randomColor();
+            switch (rng.nextRange(3)) {
+            case 0: canvas.fillRect(randomInt(-20, Width), randomInt(-20, Height), randomInt(0, 80), randomInt(0, 30)); break;
+            case 1: canvas.hline(randomInt(-20, Width), randomInt(-2, Height + 1), randomInt(0, 300)); break;
+            case 2: canvas.point(randomInt(-1, Width), randomInt(-1, Height)); break;
+            }
+        }
+        break;
+    case 2:
+        // subtractive drawing on filled background
+        for (int i = 0; i < 20; ++i) {
+            randomColor();
+            canvas.fillRect(randomInt(-20, Width), randomInt(-20, Height), randomInt(0, 120), randomInt(0, 40));
+        }
+        canvas.setBlendMode(BlendMode::Sub);
+        for (int i = 0; i < 20; ++i) {
+            randomColor();
+            switch (rng.nextRange(4)) {
+            case 0: canvas.fillRect(randomInt(-20, Width), randomInt(-20, Height), randomInt(0, 80), randomInt(0, 30)); break;
+            case 1: canvas.drawText(randomInt(-10, Width), randomInt(0, Height + 4), "SUBTRACT"); break;
+            case 2: canvas.vline(randomInt(-2, Width + 1), randomInt(-20, Height), randomInt(0, 80)); break;
+            case 3: canvas.line(randomCoord(rng, Width), randomCoord(rng, Height), randomCoord(rng, Width), randomCoord(rng, Height)); break;
+            }
+        }
+        break;
+    case 3:
+        // antialiased lines
+        canvas.setBlendMode(BlendMode::Add);
+        for (int i = 0; i < 8; ++i) {
+            randomColor();
+            canvas.line(randomCoord(rng, Width), randomCoord(rng, Height), randomCoord(rng, Width), randomCoord(rng, Height));
+        }
+        canvas.setBlendMode(BlendMode::Set);
+        for (int i = 0; i < 8; ++i) {
+            randomColor();
+            canvas.line(randomCoord(rng, Width), randomCoord(rng, Height), randomCoord(rng, Width), randomCoord(rng, Height));
+        }
+        break;
+    case 4:
+        // inverted text as drawn by the window painter
+        canvas.setColor(Color::Low);
+        canvas.fill();
+        for (int i = 0; i < 10; ++i) {
+            int x = randomInt(0, Width - 40);
+            int y = randomInt(6, Height);
+            canvas.setBlendMode(BlendMode::Set);
+            canvas.setColor(Color::Bright);
+            canvas.fillRect(x - 1, y - 5, canvas.textWidth("INVERTED") + 1, 7);
+            canvas.setBlendMode(BlendMode::Sub);
+            canvas.drawText(x, y, "INVERTED");
+        }
+        break;
+    case 5:
+        // screensaver and fills
+        canvas.setColor(Color::Medium);
+        canvas.fill();
+        canvas.screensaver();
+        canvas.setColor(Color::MediumLow);
+        canvas.fillRect(1, 1, Width - 2, Height - 2);
+        canvas.setBlendMode(BlendMode::Add);
+        canvas.setColor(Color::Low);
+        canvas.fillRect(3, 3, 7, 7);
+        canvas.drawBitmap1bit(20, 20, 13, 5, reinterpret_cast<const uint8_t *>("\x55\xaa\x0f\xf0\x33\xcc\x81\x7e\xff"));
+        canvas.setBlendMode(BlendMode::Set);
+        canvas.drawBitmap4bit(40, 20, 6, 4, reinterpret_cast<const uint8_t *>("\x10\x32\x54\x76\x98\xba\xdc\xfe\x01\x23\x45\x67"));
+        break;
+    }
+}
+
+// hashes of the scenes drawn with the previous 8 bit canvas, packed to 4 bit as sent to the display
+// (rows are brightness 1.0, 0.7 and 0.3)
+static const uint32_t referenceHashes[3][SceneCount] = {
+    { 0x741a1f3c, 0x0c64d62d, 0x5f7aa233, 0x47e001bd, 0xfcdeb0a4, 0xc4de1b55 },
+    { 0x1737af4e, 0x21649de9, 0x5eaa4309, 0xfcf9a1de, 0x0d999bbf, 0x5d46e105 },
+    { 0xbed286a3, 0x589b8368, 0x27987782, 0xa1c7dac9, 0xefd5ee7d, 0x60578705 },
+};
+
+template<typename Blit>
+static void testBlit() {
+    // all combinations of pixel and color values against the single pixel operation
+    Random rng(0x1234);
+    for (int i = 0; i < 10000; ++i) {
+        uint32_t dst = rng.next();
+        uint8_t color = rng.nextRange(16);
+        uint32_t result = Blit::word(dst, 0x11111111u * color);
+        for (int x = 0; x < 8; ++x) {
+            int shift = FrameBuffer4bit::pixelShift(x);
+            uint8_t expected = Blit::pixel((dst >> shift) & 0xf, color);
+            expectEqual(int((result >> shift) & 0xf), int(expected));
+        }
+    }
+}
+
+UNIT_TEST("Canvas") {
+
+    CASE("frame buffer layout") {
+        uint32_t data[2 * 2];
+        FrameBuffer4bit frameBuffer(16, 2, data);
+        frameBuffer.fill(0);
+        expectEqual(frameBuffer.stride(), 2);
+        expectEqual(int(frameBuffer.size()), 16);
+        for (int x = 0; x < 16; ++x) {
+            frameBuffer.set(x, 1, x);
+        }
+        // first pixel in the high nibble
+        for (int i = 0; i < 8; ++i) {
+            expectEqual(int(frameBuffer.data()[8 + i]), ((2 * i) << 4) | (2 * i + 1));
+        }
+        for (int x = 0; x < 16; ++x) {
+            expectEqual(int(frameBuffer.get(x, 1)), x);
+            expectEqual(int(frameBuffer.get(x, 0)), 0);
+        }
+        for (int x0 = 0; x0 < 8; ++x0) {
+            uint32_t mask = 0;
+            for (int x1 = x0; x1 < 8; ++x1) {
+                mask |= FrameBuffer4bit::pixelMask(x1);
+                expectEqual(FrameBuffer4bit::spanMask(x0, x1), mask);
+            }
+        }
+    }
+
+    CASE("blit") {
+        for (int a = 0; a < 16; ++a) {
+            for (int b = 0; b < 16; ++b) {
+                expectEqual(int(blit::add::pixel(a, b)), std::min(15, a + b));
+                expectEqual(int(blit::sub::pixel(a, b)), std::max(0, a - b));
+            }
+        }
+        testBlit<blit::set>();
+        testBlit<blit::add>();
+        testBlit<blit::sub>();
+    }
+
+    CASE("bitmap") {
+        static uint32_t data[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, data);
+        float brightness = 1.f;
+        Canvas canvas(frameBuffer, brightness);
+        Random rng(0x5678);
+        uint8_t bitmap[32 * 4 / 8];
+        for (auto &byte : bitmap) {
+            byte = rng.next();
+        }
+        // narrow bitmaps are blended a word at a time, wide bitmaps a pixel at a time
+        for (int w : { 1, 5, 8, 13, 24, 25, 32 }) {
+            for (int x = -w; x <= Width; x += 3) {
+                frameBuffer.fill(0x5);
+                canvas.setBlendMode(BlendMode::Set);
+                canvas.setColor(Color::Bright);
+                canvas.drawBitmap1bit(x, 30, w, 4, bitmap);
+                canvas.setBlendMode(BlendMode::Add);
+                canvas.setColor(Color::Medium);
+                canvas.drawBitmap1bit(x + 1, 31, w, 4, bitmap);
+                for (int py = 0; py < Height; ++py) {
+                    for (int px = 0; px < Width; ++px) {
+                        auto bitmapBit = [&] (int bx, int by) {
+                            int bit = by * w + bx;
+                            return bx >= 0 && bx < w && by >= 0 && by < 4 && (bitmap[bit >> 3] & (1 << (bit & 7)));
+                        };
+                        int expected = 0x5;
+                        if (px >= x && px < x + w && py >= 30 && py < 34) {
+                            expected = bitmapBit(px - x, py - 30) ? 0xf : 0x0;
+                        }
+                        if (bitmapBit(px - x - 1, py - 31)) {
+                            expected = std::min(15, expected + 0x7);
+                        }
+                        expectEqual(int(frameBuffer.get(px, py)), expected);
+                    }
+                }
+            }
+        }
+    }
+
+    CASE("reference output") {
+        static uint32_t data[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, data);
+        const float brightnesses[] = { 1.f, 0.7f, 0.3f };
+        for (int i = 0; i < 3; ++i) {
+            float brightness = brightnesses[i];
+            Canvas canvas(frameBuffer, brightness);
+            for (int scene = 0; scene < SceneCount; ++scene) {
+                FnvHash hash;
+                for (uint32_t seed = 1; seed <= 4; ++seed) {
+                    drawScene(canvas, scene, seed);
+                    hash(frameBuffer.data(), frameBuffer.size());
+                }
+                FixedStringBuilder<64> msg("scene %d brightness %.1f", scene, brightness);
+                expectEqual(hash.result(), referenceHashes[i][scene], msg);
+            }
+        }
+    }
+
+}
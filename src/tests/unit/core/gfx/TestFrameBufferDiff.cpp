@@ -0,0 +1,172 @@
+#include "UnitTest.h"
+
+#include "core/gfx/Canvas.h"
+#include "core/gfx/FrameBufferDiff.h"
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+
+static const int Width = 256;
+static const int Height = 64;
+
+typedef FrameBufferDiff<Width, Height> Diff;
+
+static bool shadowMatches(const Diff &diff, const FrameBuffer4bit &frameBuffer) {
+    return std::equal(frameBuffer.data(), frameBuffer.data() + frameBuffer.size(), diff.data());
+}
+
+UNIT_TEST("FrameBufferDiff") {
+
+    CASE("windows") {
+        static uint32_t frameBufferData[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, frameBufferData);
+        frameBuffer.fill(0);
+        auto full = DirtyRegion::full(Width, Height);
+
+        Diff diff;
+
+        // first update sends the full frame
+        diff.update(frameBuffer.data(), full);
+        expectEqual(diff.windowCount(), 1);
+        expectEqual(int(diff.changedSize()), Width * Height / 2);
+
+        // unchanged frame
+        diff.update(frameBuffer.data(), full);
+        expectEqual(diff.windowCount(), 0);
+        expectEqual(int(diff.changedSize()), 0);
+
+        // single pixel
+        frameBuffer.set(9, 10, 0xf);
+        diff.update(frameBuffer.data(), full);
+        expectEqual(diff.windowCount(), 1);
+        expectEqual(int(diff.window(0).col0), 2);
+        expectEqual(int(diff.window(0).col1), 2);
+        expectEqual(int(diff.window(0).row0), 10);
+        expectEqual(int(diff.window(0).row1), 10);
+        expectEqual(int(diff.changedSize()), 2);
+        expectTrue(shadowMatches(diff, frameBuffer));
+
+        // changes in two bands
+        frameBuffer.set(0, 1, 0x7);
+        frameBuffer.set(255, 3, 0x7);
+        frameBuffer.set(100, 60, 0x3);
+        diff.update(frameBuffer.data(), full);
+        expectEqual(diff.windowCount(), 2);
+        expectEqual(int(diff.window(0).col0), 0);
+        expectEqual(int(diff.window(0).col1), 63);
+        expectEqual(int(diff.window(0).row0), 1);
+        expectEqual(int(diff.window(0).row1), 3);
+        expectEqual(int(diff.window(1).col0), 25);
+        expectEqual(int(diff.window(1).col1), 25);
+        expectEqual(int(diff.window(1).row0), 60);
+        expectEqual(int(diff.window(1).row1), 60);
+        expectEqual(int(diff.changedSize()), 64 * 3 * 2 + 2);
+
+        // windows contain the packed pixels
+        uint8_t window[64 * 3 * 2];
+        expectEqual(int(diff.copyWindow(diff.window(0), window)), int(sizeof(window)));
+        expectEqual(int(window[0]), 0x70);
+        expectEqual(int(window[64 * 2 * 2 + 127]), 0x07);
+
+        // changes outside of the dirty region are ignored
+        frameBuffer.set(40, 40, 0xf);
+        diff.update(frameBuffer.data(), DirtyRegion(0, 0, 39, 63));
+        expectEqual(diff.windowCount(), 0);
+        diff.update(frameBuffer.data(), DirtyRegion());
+        expectEqual(diff.windowCount(), 0);
+        diff.update(frameBuffer.data(), DirtyRegion(40, 40, 40, 40));
+        expectEqual(diff.windowCount(), 1);
+        expectTrue(shadowMatches(diff, frameBuffer));
+
+        // invalidate sends the full frame
+        diff.invalidate();
+        diff.update(frameBuffer.data(), DirtyRegion());
+        expectEqual(diff.windowCount(), 1);
+        expectEqual(int(diff.changedSize()), Width * Height / 2);
+    }
+
+    CASE("random against reference") {
+        static uint32_t frameBufferData[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, frameBufferData);
+        frameBuffer.fill(0);
+        static uint8_t display[Width * Height / 2];
+        Random rng(0x5678);
+
+        Diff diff;
+        for (int frame = 0; frame < 200; ++frame) {
+            for (int i = rng.nextRange(32); i > 0; --i) {
+                frameBuffer.set(rng.nextRange(Width), rng.nextRange(Height), rng.nextRange(16));
+            }
+            diff.update(frameBuffer.data(), DirtyRegion::full(Width, Height));
+            expectTrue(shadowMatches(diff, frameBuffer));
+
+            // apply windows to a simulated display
+            for (int i = 0; i < diff.windowCount(); ++i) {
+                const auto &window = diff.window(i);
+                std::vector<uint8_t> data(window.size());
+                diff.copyWindow(window, data.data());
+                size_t rowSize = window.columns() * 2;
+                for (int row = window.row0; row <= window.row1; ++row) {
+                    std::copy_n(&data[(row - window.row0) * rowSize], rowSize, &display[row * Width / 2 + window.col0 * 2]);
+                }
+            }
+            expectTrue(std::equal(frameBuffer.data(), frameBuffer.data() + frameBuffer.size(), display), "display");
+        }
+    }
+
+    CASE("canvas dirty region") {
+        static uint32_t frameBufferData[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, frameBufferData);
+        float brightness = 1.f;
+        Canvas canvas(frameBuffer, brightness);
+
+        // initially dirty
+        expectFalse(canvas.dirtyRegion().isEmpty());
+        canvas.clearDirtyRegion();
+        expectTrue(canvas.dirtyRegion().isEmpty());
+
+        canvas.fillRect(10, 20, 5, 4);
+        canvas.point(100, 2);
+        expectEqual(canvas.dirtyRegion().x0(), 10);
+        expectEqual(canvas.dirtyRegion().y0(), 2);
+        expectEqual(canvas.dirtyRegion().x1(), 100);
+        expectEqual(canvas.dirtyRegion().y1(), 23);
+        canvas.clearDirtyRegion();
+
+        // clipped
+        canvas.hline(-10, 5, 20);
+        canvas.vline(300, 0, 10);
+        canvas.drawText(-100, -100, "OFFSCREEN");
+        expectEqual(canvas.dirtyRegion().x0(), 0);
+        expectEqual(canvas.dirtyRegion().x1(), 9);
+        expectEqual(canvas.dirtyRegion().y0(), 5);
+        expectEqual(canvas.dirtyRegion().y1(), 5);
+        canvas.clearDirtyRegion();
+
+        // all drawn pixels are within the dirty region
+        Random rng(0x9abc);
+        for (int i = 0; i < 100; ++i) {
+            frameBuffer.fill(0);
+            canvas.clearDirtyRegion();
+            canvas.setBlendMode(BlendMode::Add);
+            float x0 = rng.nextRange(300) - 20.f + rng.nextRange(100) / 100.f;
+            float y0 = rng.nextRange(100) - 20.f + rng.nextRange(100) / 100.f;
+            float x1 = rng.nextRange(300) - 20.f + rng.nextRange(100) / 100.f;
+            float y1 = rng.nextRange(100) - 20.f + rng.nextRange(100) / 100.f;
+            canvas.line(x0, y0, x1, y1);
+            canvas.drawText(rng.nextRange(256), rng.nextRange(64), "TEXT");
+            const auto &region = canvas.dirtyRegion();
+            for (int y = 0; y < Height; ++y) {
+                for (int x = 0; x < Width; ++x) {
+                    if (frameBuffer.get(x, y) != 0) {
+                        expectTrue(x >= region.x0() && x <= region.x1() && y >= region.y0() && y <= region.y1(), "pixel outside of dirty region");
+                    }
+                }
+            }
+        }
+    }
+
+}
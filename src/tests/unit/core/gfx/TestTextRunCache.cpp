@@ -0,0 +1,143 @@
+#include "UnitTest.h"
+
+#include "core/gfx/Canvas.h"
+#include "core/gfx/TextRunCache.h"
+#include "core/gfx/fonts/tiny5x5.h"
+#include "core/gfx/fonts/ati8x8.h"
+#include "core/utils/Random.h"
+#include "core/utils/StringBuilder.h"
+
+#include <algorithm>
+
+#include <cstdint>
+
+static const int Width = 256;
+static const int Height = 64;
+
+// draw a string glyph by glyph (reference for cached text runs)
+static void drawGlyphs(Canvas &canvas, const BitmapFont &font, int x, int y, const char *str) {
+    for (; *str != '\0'; ++str) {
+        auto c = *str;
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        canvas.drawBitmap1bit(x + g.xOffset, y + g.yOffset, g.width, g.height, &font.bitmap[g.offset]);
+        x += g.xAdvance;
+    }
+}
+
+UNIT_TEST("TextRunCache") {
+
+    CASE("lookup") {
+        TextRunCache cache;
+        expectTrue(cache.find(tiny5x5, "TRACK1") == nullptr);
+
+        auto run = cache.lookup(tiny5x5, "TRACK1");
+        expectTrue(run != nullptr);
+        expectTrue(cache.lookup(tiny5x5, "TRACK1") == run);
+        expectTrue(cache.find(tiny5x5, "TRACK1") == run);
+        expectTrue(cache.find(ati8x8, "TRACK1") == nullptr);
+        expectTrue(cache.lookup(ati8x8, "TRACK1") != run);
+
+        int width = 0;
+        for (const char *s = "TRACK1"; *s; ++s) {
+            width += tiny5x5.glyphs[*s - tiny5x5.first].xAdvance;
+        }
+        expectEqual(int(run->width), width);
+        expectTrue(run->w > 0 && run->w <= TextRunCache::MaxWidth);
+        expectTrue(run->h > 0 && run->h <= TextRunCache::MaxRows);
+
+        // empty and blank strings have a width but nothing to draw
+        auto blank = cache.lookup(tiny5x5, "  ");
+        expectTrue(blank != nullptr);
+        expectEqual(int(blank->width), 2 * tiny5x5.glyphs[' ' - tiny5x5.first].xAdvance);
+        expectEqual(int(blank->w), 0);
+        expectEqual(int(cache.lookup(tiny5x5, "")->width), 0);
+
+        // strings that cannot be cached
+        expectTrue(cache.lookup(tiny5x5, "LINE\nBREAK") == nullptr);
+        expectTrue(cache.lookup(tiny5x5, "A STRING THAT IS TOO LONG") == nullptr);
+        expectTrue(cache.lookup(ati8x8, "WIDEWIDEWIDE") == nullptr);
+
+        cache.clear();
+        expectTrue(cache.find(tiny5x5, "TRACK1") == nullptr);
+    }
+
+    CASE("least recently used runs are replaced") {
+        TextRunCache cache;
+        for (int i = 0; i < TextRunCache::Entries; ++i) {
+            cache.lookup(tiny5x5, FixedStringBuilder<8>("%d", i));
+            // keep the first run in use
+            cache.lookup(tiny5x5, "0");
+        }
+        cache.lookup(tiny5x5, "NEW");
+        expectTrue(cache.find(tiny5x5, "NEW") != nullptr);
+        expectTrue(cache.find(tiny5x5, "0") != nullptr);
+        expectTrue(cache.find(tiny5x5, "1") == nullptr);
+        for (int i = 2; i < TextRunCache::Entries; ++i) {
+            expectTrue(cache.find(tiny5x5, FixedStringBuilder<8>("%d", i)) != nullptr);
+        }
+    }
+
+    CASE("strings that cannot be cached are remembered") {
+        TextRunCache cache;
+        for (int i = 0; i < TextRunCache::Entries; ++i) {
+            cache.lookup(tiny5x5, FixedStringBuilder<8>("%d", i));
+        }
+        for (int i = 0; i < 2 * TextRunCache::RejectedEntries; ++i) {
+            expectTrue(cache.lookup(ati8x8, FixedStringBuilder<16>("WIDEWIDEWIDE%d", i)) == nullptr);
+            expectTrue(cache.lookup(ati8x8, FixedStringBuilder<16>("WIDEWIDEWIDE%d", i)) == nullptr);
+        }
+        // rejected strings do not replace cached runs
+        for (int i = 0; i < TextRunCache::Entries; ++i) {
+            expectTrue(cache.find(tiny5x5, FixedStringBuilder<8>("%d", i)) != nullptr);
+        }
+        expectTrue(cache.lookup(ati8x8, "WIDE") != nullptr);
+    }
+
+    CASE("cached runs draw like glyphs") {
+        static uint32_t frameBufferData[Width * Height / 8];
+        static uint32_t referenceData[Width * Height / 8];
+        FrameBuffer4bit frameBuffer(Width, Height, frameBufferData);
+        FrameBuffer4bit reference(Width, Height, referenceData);
+        float brightness = 1.f;
+        Canvas canvas(frameBuffer, brightness);
+        Canvas referenceCanvas(reference, brightness);
+
+        const char *strings[] = { "TRACK 1", "C#4", "P16", "-1.25V", "Hello World!", "|||.:;", "mixed Case" };
+        const BlendMode blendModes[] = { BlendMode::Set, BlendMode::Add, BlendMode::Sub };
+
+        Random rng(0x1234);
+        for (int i = 0; i < 2000; ++i) {
+            // random background
+            for (int y = 0; y < Height; ++y) {
+                for (int x = 0; x < Width; x += 16) {
+                    uint8_t color = rng.nextRange(16);
+                    for (int px = x; px < x + 16; ++px) {
+                        frameBuffer.set(px, y, color);
+                    }
+                }
+            }
+            std::copy_n(frameBufferData, Width * Height / 8, referenceData);
+
+            Font font = rng.nextRange(2) ? Font::Tiny : Font::Small;
+            BlendMode blendMode = blendModes[rng.nextRange(3)];
+            uint8_t color = rng.nextRange(16);
+            const char *str = strings[rng.nextRange(7)];
+            int x = int(rng.nextRange(Width + 80)) - 70;
+            int y = int(rng.nextRange(Height + 20)) - 4;
+
+            for (auto c : { &canvas, &referenceCanvas }) {
+                c->setFont(font);
+                c->setBlendMode(blendMode);
+                c->setColorValue(color);
+            }
+            canvas.drawText(x, y, str);
+            drawGlyphs(referenceCanvas, font == Font::Tiny ? tiny5x5 : ati8x8, x, y, str);
+            expectTrue(std::equal(frameBufferData, frameBufferData + Width * Height / 8, referenceData), "cached text run");
+            expectEqual(canvas.textWidth(str), referenceCanvas.textWidth(str));
+        }
+    }
+
+}
@@ -155,6 +155,76 @@ static void clear() {
     std::memset(buf, 0, sizeof(buf));
 }
 
+enum class Color : uint8_t {
+    Red,
+    Green,
+    Blue,
+    Last
+};
+
+static uint8_t colorSerialize(Color color) {
+    switch (color) {
+    case Color::Red:    return 7;
+    case Color::Green:  return 3;
+    case Color::Blue:   return 5;
+    case Color::Last:   break;
+    }
+    return 0;
+}
+
+struct Data5 {
+    uint8_t field1 = 123;
+    Color color = Color::Blue;
+    uint8_t array[100];
+    uint32_t field3 = 345;
+
+    Data5() {
+        for (size_t i = 0; i < sizeof(array); ++i) {
+            array[i] = i * 3;
+        }
+    }
+};
+
+static size_t writeVersion5(void *buf, size_t len) {
+    MemoryWriter memoryWriter(buf, len);
+    {
+        VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, 5);
+        Data5 data;
+        writer.write(data.field1);
+        writer.writeEnum(data.color, colorSerialize);
+        writer.write(data.array, sizeof(data.array));
+        for (int i = 0; i < 40; ++i) {
+            writer.write(data.field3);
+        }
+        writer.writeHash();
+    }
+    return memoryWriter.bytesWritten();
+}
+
+static void readVersion5(const void *buf, size_t len, size_t available) {
+    MemoryReader memoryReader(buf, len);
+    VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 5, available);
+    Data5 data;
+    std::memset(&data, 0, sizeof(data));
+    reader.read(data.field1);
+    reader.readEnum(data.color, colorSerialize);
+    reader.read(data.array, sizeof(data.array), 0);
+    Data5 expected;
+    for (int i = 0; i < 40; ++i) {
+        data.field3 = 0;
+        reader.read(data.field3);
+        expectEqual(data.field3, expected.field3);
+    }
+    expectTrue(reader.checkHash());
+    expectEqual(data.field1, expected.field1);
+    expectTrue(data.color == expected.color);
+    expectEqual(std::memcmp(data.array, expected.array, sizeof(data.array)), 0);
+    expectEqual(int(reader.remaining()), 0);
+    if (available > 0) {
+        expectEqual(memoryReader.bytesRead(), available);
+    }
+}
+
 UNIT_TEST("VersionedSerialization") {
 
     CASE("version 1") {
@@ -209,4 +279,41 @@ UNIT_TEST("VersionedSerialization") {
         readVersion4(buf, sizeof(buf));
     }
 
+
+    CASE("block reads") {
+        clear();
+        size_t size = writeVersion5(buf, sizeof(buf));
+        expectEqual(int(size), 4 + 1 + 1 + 100 + 40 * 4 + 4);
+        // read field by field
+        readVersion5(buf, sizeof(buf), 0);
+        // fetch blocks from reader
+        readVersion5(buf, sizeof(buf), size);
+    }
+
+    CASE("enum") {
+        for (auto color : { Color::Red, Color::Green, Color::Blue }) {
+            clear();
+            MemoryWriter memoryWriter(buf, sizeof(buf));
+            VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, 1);
+            writer.writeEnum(color, colorSerialize);
+            writer.writeHash();
+
+            MemoryReader memoryReader(buf, sizeof(buf));
+            VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 1);
+            Color result = Color::Last;
+            reader.readEnum(result, colorSerialize);
+            expectTrue(reader.checkHash());
+            expectTrue(result == color);
+        }
+
+        // unknown values are read as the first enum value
+        clear();
+        buf[4] = 42;
+        MemoryReader memoryReader(buf, sizeof(buf));
+        VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 1);
+        Color result = Color::Blue;
+        reader.readEnum(result, colorSerialize);
+        expectTrue(result == Color::Red);
+    }
+
 }
@@ -0,0 +1,92 @@
+#include "UnitTest.h"
+
+#include "core/profiler/Profiler.h"
+
+#include <cstdint>
+
+#if CONFIG_ENABLE_PROFILER
+static int intervalIndex(const Profiler::Interval &target) {
+    int index = 0, result = -1;
+    Profiler::forEachInterval([&] (const Profiler::Interval &interval) {
+        if (&interval == &target) {
+            result = index;
+        }
+        ++index;
+    });
+    return result;
+}
+#endif // CONFIG_ENABLE_PROFILER
+
+UNIT_TEST("Profiler") {
+
+#if CONFIG_ENABLE_PROFILER
+
+    CASE("histogram buckets") {
+        expectEqual(Profiler::Interval::histogramBucket(0), 0);
+        expectEqual(Profiler::Interval::histogramBucket(1), 1);
+        expectEqual(Profiler::Interval::histogramBucket(2), 2);
+        expectEqual(Profiler::Interval::histogramBucket(3), 2);
+        expectEqual(Profiler::Interval::histogramBucket(4), 3);
+        expectEqual(Profiler::Interval::histogramBucket(1000), 10);
+        expectEqual(Profiler::Interval::histogramBucket(1 << 14), 15);
+        expectEqual(Profiler::Interval::histogramBucket(UINT32_MAX), Profiler::HistogramBuckets - 1);
+    }
+
+    CASE("statistics") {
+        static Profiler::Interval interval("test", 1000);
+        Profiler::IntervalSnapshot snapshot = {};
+
+        expectTrue(interval.snapshot(snapshot));
+        expectEqual(snapshot.count, uint32_t(0));
+        expectEqual(snapshot.min, uint32_t(0));
+        expectEqual(snapshot.max, uint32_t(0));
+        expectEqual(snapshot.mean, uint32_t(0));
+
+        interval.record(100);
+        interval.record(300);
+        interval.record(200);
+
+        expectTrue(interval.snapshot(snapshot));
+        expectEqual(snapshot.count, uint32_t(3));
+        expectEqual(snapshot.last, uint32_t(200));
+        expectEqual(snapshot.min, uint32_t(100));
+        expectEqual(snapshot.max, uint32_t(300));
+        expectEqual(snapshot.mean, uint32_t(200));
+        expectEqual(snapshot.budget, uint32_t(1000));
+        expectEqual(snapshot.meanUtilization(), 20.f);
+        expectEqual(snapshot.maxUtilization(), 30.f);
+        expectEqual(snapshot.histogram[7], uint32_t(1));
+        expectEqual(snapshot.histogram[8], uint32_t(1));
+        expectEqual(snapshot.histogram[9], uint32_t(1));
+    }
+
+    CASE("registration") {
+        int count = Profiler::intervalCount();
+        static Profiler::Interval a("a");
+        static Profiler::Interval b("b");
+        expectEqual(Profiler::intervalCount(), count + 2);
+        expectEqual(intervalIndex(b), intervalIndex(a) + 1);
+    }
+
+    CASE("reset") {
+        static Profiler::Interval interval("test");
+        Profiler::IntervalSnapshot snapshot = {};
+
+        interval.record(10);
+        interval.record(20);
+        Profiler::reset();
+
+        // reset is applied with the next measurement
+        expectTrue(interval.snapshot(snapshot));
+        expectEqual(snapshot.count, uint32_t(2));
+
+        interval.record(5);
+        expectTrue(interval.snapshot(snapshot));
+        expectEqual(snapshot.count, uint32_t(1));
+        expectEqual(snapshot.min, uint32_t(5));
+        expectEqual(snapshot.max, uint32_t(5));
+        expectEqual(snapshot.histogram[4], uint32_t(0));
+    }
+#endif // CONFIG_ENABLE_PROFILER
+
+}
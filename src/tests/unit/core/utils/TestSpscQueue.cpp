@@ -0,0 +1,115 @@
+#include "UnitTest.h"
+
+#include "core/utils/SpscQueue.h"
+
+#ifdef PLATFORM_SIM
+#include <thread>
+#endif
+
+#include <cstdint>
+
+UNIT_TEST("SpscQueue") {
+
+    CASE("empty") {
+        SpscQueue<int, 8> queue;
+        int value;
+        expectEqual(queue.capacity(), size_t(8));
+        expectEqual(queue.size(), size_t(0));
+        expectTrue(queue.empty());
+        expectFalse(queue.full());
+        expectFalse(queue.pop(value));
+        expectEqual(queue.overflowCount(), uint32_t(0));
+        expectEqual(queue.highWaterMark(), uint32_t(0));
+    }
+
+    CASE("push/pop in order") {
+        SpscQueue<int, 8> queue;
+        for (int i = 0; i < 100; ++i) {
+            expectTrue(queue.push(i));
+            expectTrue(queue.push(i + 1000));
+            int value;
+            expectTrue(queue.pop(value));
+            expectEqual(value, i);
+            expectTrue(queue.pop(value));
+            expectEqual(value, i + 1000);
+        }
+        expectTrue(queue.empty());
+        expectEqual(queue.highWaterMark(), uint32_t(2));
+    }
+
+    CASE("overflow drops new items") {
+        SpscQueue<int, 4> queue;
+        for (int i = 0; i < 6; ++i) {
+            expectEqual(queue.push(i), i < 4);
+        }
+        expectTrue(queue.full());
+        expectEqual(queue.overflowCount(), uint32_t(2));
+        expectEqual(queue.highWaterMark(), uint32_t(4));
+        for (int i = 0; i < 4; ++i) {
+            int value;
+            expectTrue(queue.pop(value));
+            expectEqual(value, i);
+        }
+        expectTrue(queue.empty());
+    }
+
+    CASE("drain") {
+        SpscQueue<int, 8> queue;
+        int values[8];
+        expectEqual(queue.drain(values, 8), size_t(0));
+        for (int i = 0; i < 6; ++i) {
+            queue.push(i);
+        }
+        expectEqual(queue.drain(values, 4), size_t(4));
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(values[i], i);
+        }
+        // wrap around
+        for (int i = 6; i < 12; ++i) {
+            queue.push(i);
+        }
+        expectEqual(queue.drain(values, 8), size_t(8));
+        for (int i = 0; i < 8; ++i) {
+            expectEqual(values[i], i + 4);
+        }
+        expectTrue(queue.empty());
+    }
+
+    CASE("clear") {
+        SpscQueue<int, 8> queue;
+        queue.push(1);
+        queue.push(2);
+        queue.clear();
+        expectTrue(queue.empty());
+        int value;
+        expectFalse(queue.pop(value));
+    }
+
+#ifdef PLATFORM_SIM
+    CASE("producer and consumer threads") {
+        static SpscQueue<uint32_t, 64> queue;
+        const uint32_t count = 100000;
+
+        std::thread producer([&] () {
+            for (uint32_t i = 0; i < count; ++i) {
+                while (!queue.push(i)) {}
+            }
+        });
+
+        uint32_t expected = 0;
+        uint32_t values[16];
+        while (expected < count) {
+            size_t n = queue.drain(values, 16);
+            for (size_t i = 0; i < n; ++i) {
+                expectEqual(values[i], expected);
+                ++expected;
+            }
+        }
+        producer.join();
+
+        expectTrue(queue.empty());
+        expectTrue(queue.highWaterMark() <= 64);
+    }
+#endif
+
+}
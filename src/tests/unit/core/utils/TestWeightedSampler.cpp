@@ -0,0 +1,136 @@
+#include "UnitTest.h"
+
+#include "core/utils/WeightedSampler.h"
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cmath>
+
+// reference implementation (vector, sort and linear walk) previously used by the stochastic and arp engines
+struct ReferenceStep {
+    int index;
+    int probability;
+};
+
+static int referenceSample(const std::vector<int> &weights, Random &rng) {
+    std::vector<ReferenceStep> distr;
+    int total = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        distr.push_back({ int(i), weights[i] });
+        total += weights[i];
+    }
+    if (total == 0) {
+        return -1;
+    }
+    std::sort(distr.begin(), distr.end(), [] (const ReferenceStep &a, const ReferenceStep &b) {
+        return a.probability > b.probability;
+    });
+    int rnd = rng.nextRange(total);
+    for (const auto &step : distr) {
+        if (rnd <= step.probability && step.probability > 0) {
+            return step.index;
+        }
+        rnd -= step.probability;
+    }
+    return -1;
+}
+
+UNIT_TEST("WeightedSampler") {
+
+    CASE("empty") {
+        WeightedSampler<4> sampler;
+        Random rng;
+        expectEqual(sampler.size(), size_t(0));
+        expectEqual(sampler.total(), 0);
+        expectEqual(sampler.sample(rng), -1);
+
+        int weights[] = { 0, 0, 0, 0 };
+        sampler.setWeights(weights, 4);
+        expectEqual(sampler.size(), size_t(4));
+        expectEqual(sampler.sample(rng), -1);
+    }
+
+    CASE("single item") {
+        WeightedSampler<4> sampler;
+        Random rng;
+        int weights[] = { 0, 0, 5, 0 };
+        sampler.setWeights(weights, 4);
+        for (int i = 0; i < 100; ++i) {
+            expectEqual(sampler.sample(rng), 2);
+        }
+    }
+
+    CASE("same selection as reference for same seed") {
+        Random weightRng(0x1234);
+        for (int set = 0; set < 1000; ++set) {
+            int count = 1 + weightRng.nextRange(12);
+            std::vector<int> weights(count);
+            for (auto &weight : weights) {
+                // include clamped negative and duplicate weights as produced by the engines
+                weight = int(weightRng.nextRange(10)) - 1;
+            }
+
+            WeightedSampler<12> sampler;
+            sampler.setWeights(weights.data(), weights.size());
+
+            Random rng(set);
+            Random referenceRng(set);
+            for (int i = 0; i < 100; ++i) {
+                expectEqual(sampler.sample(rng), referenceSample(weights, referenceRng));
+            }
+        }
+    }
+
+    CASE("distribution matches reference") {
+        int weights[] = { 1, 7, 3, 0, 7, 12, 2, 0, 5, 1, 9, 4 };
+        std::vector<int> weightsVector(std::begin(weights), std::end(weights));
+        const int count = 12;
+        const int samples = 200000;
+
+        WeightedSampler<12> sampler;
+        sampler.setWeights(weights, count);
+
+        int histogram[count] = {};
+        int referenceHistogram[count] = {};
+        Random rng(1);
+        Random referenceRng(2);
+        for (int i = 0; i < samples; ++i) {
+            ++histogram[sampler.sample(rng)];
+            ++referenceHistogram[referenceSample(weightsVector, referenceRng)];
+        }
+
+        // compare both histograms to each other and to the expected frequencies
+        int total = sampler.total();
+        for (int i = 0; i < count; ++i) {
+            float expected = float(weights[i]) / total;
+            float actual = float(histogram[i]) / samples;
+            float reference = float(referenceHistogram[i]) / samples;
+            DBG("%2d: expected %.4f actual %.4f reference %.4f", i, expected, actual, reference);
+            expectTrue(std::abs(actual - reference) < 0.01f);
+            // inclusive bounds shift one unit of weight from the last to the first item in the reference implementation
+            expectTrue(std::abs(actual - expected) < 0.01f + 1.f / total);
+            if (weights[i] == 0) {
+                expectEqual(histogram[i], 0);
+            }
+        }
+    }
+
+    CASE("rebuild only on change") {
+        WeightedSampler<4> sampler;
+        Random rng(0);
+        int weights[] = { 1, 2, 3, 4 };
+        sampler.setWeights(weights, 4);
+        expectEqual(sampler.total(), 10);
+        sampler.setWeights(weights, 4);
+        expectEqual(sampler.total(), 10);
+        weights[0] = 0;
+        sampler.setWeights(weights, 4);
+        expectEqual(sampler.total(), 9);
+        sampler.setWeights(weights, 3);
+        expectEqual(sampler.total(), 5);
+        expectEqual(sampler.size(), size_t(3));
+    }
+
+}
@@ -9,6 +9,8 @@
 #include "libs/stb/stb_image_write.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 
 const int Width = 32;
@@ -18,13 +20,55 @@ float brightness = 1.0;
 
 UNIT_TEST("Curve") {
 
+    CASE("wavetable accuracy") {
+        // evaluate on the fixed point grid, so both evaluations see the same x at discontinuities
+        for (int type = 0; type < Curve::Last; ++type) {
+            float maxError = 0.f;
+            for (uint32_t i = 0; i <= 65536; ++i) {
+                float x = i * (1.f / 65536);
+                float reference = Curve::eval(Curve::Type(type), x);
+                float fixed = Curve::evalFixed(Curve::Type(type), i) * (1.f / Curve::FixedOne);
+                maxError = std::max(maxError, std::abs(fixed - reference));
+                expectEqual(Curve::evalTable(Curve::Type(type), x), fixed);
+            }
+            FixedStringBuilder<64> msg("curve type %d max error %f", type, maxError);
+            expectTrue(maxError < 2e-4f, msg);
+        }
+    }
+
+    CASE("reverse and inverse shapes") {
+        for (int type = 0; type < Curve::Last; ++type) {
+            expectTrue(Curve::revAt(type) < Curve::Last);
+            expectTrue(Curve::invAt(type) < Curve::Last);
+        }
+        expectEqual(int(Curve::revAt(0)), int(Curve::Low));
+        expectEqual(int(Curve::revAt(26)), int(Curve::Triangle));
+        expectEqual(int(Curve::revAt(32)), int(Curve::ExpDown2x));
+        expectEqual(int(Curve::invAt(0)), int(Curve::High));
+        expectEqual(int(Curve::invAt(26)), int(Curve::RevTriangle));
+        expectEqual(int(Curve::invAt(37)), int(Curve::ExpDown4x));
+        expectEqual(int(Curve::revAt(-1)), int(Curve::revAt(0)));
+        expectEqual(int(Curve::revAt(Curve::Last)), int(Curve::revAt(Curve::Last - 1)));
+    }
+
 #ifdef PLATFORM_SIM
 
+    CASE("render") {
+        float values[17];
+        for (int type = 0; type < Curve::Last; ++type) {
+            Curve::render(Curve::Type(type), values, 17, 0.25f, -0.5f);
+            for (int i = 0; i <= 16; ++i) {
+                float expected = 0.25f + Curve::evalTable(Curve::Type(type), i / 16.f) * -0.75f;
+                expectTrue(std::abs(values[i] - expected) < 1e-5f, "rendered value does not match evaluation");
+            }
+        }
+    }
+
     CASE("markdown") {
 
         auto drawCurve = [] (int index, const char *filename) {
-            uint8_t data[Width * Height];
-            FrameBuffer8bit framebuffer(Width, Height, data);
+            uint32_t data[Width * Height / FrameBuffer4bit::WordPixels];
+            FrameBuffer4bit framebuffer(Width, Height, data);
             Canvas canvas(framebuffer, brightness);
 
             canvas.setBlendMode(BlendMode::Set);
@@ -55,11 +99,14 @@ UNIT_TEST("Curve") {
                 );
             }
 
-            for (int i = 0; i < Width * Height; ++i) {
-                data[i] = std::min(255, int(data[i]) * 0xf);
+            uint8_t image[Width * Height];
+            for (int y = 0; y < Height; ++y) {
+                for (int x = 0; x < Width; ++x) {
+                    image[y * Width + x] = framebuffer.get(x, y) * 0xf;
+                }
             }
 
-            stbi_write_png(filename, Width, Height, 1, data, Width * 1);
+            stbi_write_png(filename, Width, Height, 1, image, Width * 1);
         };
 
         FixedStringBuilder<4096> indices("| Index |");
@@ -0,0 +1,197 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/EventScheduler.h"
+
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+
+struct Event {
+    uint32_t tick;
+    int value;
+};
+
+template<typename Scheduler>
+static std::vector<Event> popAll(Scheduler &scheduler, uint32_t tick) {
+    std::vector<Event> events;
+    Event event;
+    while (scheduler.pop(tick, event)) {
+        events.emplace_back(event);
+    }
+    return events;
+}
+
+UNIT_TEST("EventScheduler") {
+
+    CASE("empty") {
+        EventScheduler<Event, 8> scheduler;
+        Event event;
+        expectEqual(scheduler.capacity(), size_t(8));
+        expectEqual(scheduler.size(), size_t(0));
+        expectTrue(scheduler.empty());
+        expectFalse(scheduler.pop(1000, event));
+    }
+
+    CASE("pop in tick order") {
+        EventScheduler<Event, 8> scheduler;
+        scheduler.push({ 5, 0 });
+        scheduler.push({ 2, 1 });
+        scheduler.push({ 3, 2 });
+        expectEqual(scheduler.size(), size_t(3));
+
+        Event event;
+        expectFalse(scheduler.pop(1, event));
+        expectTrue(scheduler.pop(3, event));
+        expectEqual(event.tick, uint32_t(2));
+        expectTrue(scheduler.pop(3, event));
+        expectEqual(event.tick, uint32_t(3));
+        expectFalse(scheduler.pop(4, event));
+        expectTrue(scheduler.pop(5, event));
+        expectEqual(event.tick, uint32_t(5));
+        expectTrue(scheduler.empty());
+    }
+
+    CASE("same tick in insertion order") {
+        EventScheduler<Event, 8> scheduler;
+        for (int i = 0; i < 4; ++i) {
+            scheduler.push({ 10, i });
+        }
+        auto events = popAll(scheduler, 10);
+        expectEqual(int(events.size()), 4);
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(events[i].value, i);
+        }
+    }
+
+    CASE("events in the past are due immediately") {
+        EventScheduler<Event, 8> scheduler;
+        Event event;
+        expectFalse(scheduler.pop(100, event));
+        scheduler.push({ 50, 0 });
+        expectTrue(scheduler.pop(100, event));
+        expectEqual(event.tick, uint32_t(50));
+    }
+
+    CASE("events across levels") {
+        EventScheduler<Event, 8> scheduler;
+        // level 0, level 1 and overflow list
+        scheduler.push({ 100000, 3 });
+        scheduler.push({ 500, 2 });
+        scheduler.push({ 40, 1 });
+        scheduler.push({ 4, 0 });
+
+        Event event;
+        uint32_t expectedTicks[] = { 4, 40, 500, 100000 };
+        for (int i = 0; i < 4; ++i) {
+            expectFalse(scheduler.pop(expectedTicks[i] - 1, event));
+            expectTrue(scheduler.pop(expectedTicks[i], event));
+            expectEqual(event.tick, expectedTicks[i]);
+            expectEqual(event.value, i);
+        }
+        expectTrue(scheduler.empty());
+    }
+
+    CASE("pushReplace drops later events") {
+        EventScheduler<Event, 8> scheduler;
+        scheduler.push({ 10, 0 });
+        scheduler.push({ 20, 1 });
+        scheduler.push({ 2000, 2 });
+        scheduler.pushReplace({ 10, 3 });
+        expectEqual(scheduler.size(), size_t(2));
+
+        auto events = popAll(scheduler, 5000);
+        expectEqual(int(events.size()), 2);
+        expectEqual(events[0].value, 0);
+        expectEqual(events[1].value, 3);
+    }
+
+    CASE("overflow") {
+        EventScheduler<Event, 4> scheduler;
+        for (int i = 0; i < 6; ++i) {
+            scheduler.push({ uint32_t(i), i });
+        }
+        expectEqual(scheduler.size(), size_t(4));
+        expectEqual(scheduler.overflowCount(), uint32_t(2));
+
+        auto events = popAll(scheduler, 10);
+        expectEqual(int(events.size()), 4);
+
+        scheduler.clear();
+        expectEqual(scheduler.overflowCount(), uint32_t(2));
+        for (int i = 0; i < 4; ++i) {
+            scheduler.push({ uint32_t(i), i });
+        }
+        expectEqual(scheduler.overflowCount(), uint32_t(2));
+    }
+
+    CASE("retrigger burst") {
+        // 8 retriggers with gate offset and swing, scheduled ahead of a pending note off
+        EventScheduler<Event, 32> scheduler;
+        scheduler.push({ 200, 0 });
+        uint32_t stepTick = 100;
+        for (int i = 0; i < 8; ++i) {
+            scheduler.pushReplace({ stepTick + 7 + i * 12, 1 });
+            scheduler.pushReplace({ stepTick + 7 + i * 12 + 6, 0 });
+        }
+        expectEqual(scheduler.overflowCount(), uint32_t(0));
+        expectEqual(scheduler.size(), size_t(16));
+
+        auto events = popAll(scheduler, 1000);
+        expectEqual(int(events.size()), 16);
+        for (int i = 0; i < 16; ++i) {
+            expectEqual(events[i].value, i % 2 == 0 ? 1 : 0);
+        }
+    }
+
+    CASE("random against reference") {
+        EventScheduler<Event, 64> scheduler;
+        std::vector<Event> reference;
+        Random rng(0x1234);
+        int value = 0;
+
+        for (uint32_t tick = 0; tick < 100000; ++tick) {
+            // schedule events
+            while (rng.nextRange(4) == 0 && reference.size() < 64) {
+                uint32_t range = rng.nextBinary() ? 64 : 8192;
+                Event event = { tick + rng.nextRange(range), value++ };
+                if (rng.nextRange(8) == 0) {
+                    scheduler.pushReplace(event);
+                    reference.erase(std::remove_if(reference.begin(), reference.end(), [&] (const Event &e) { return e.tick > event.tick; }), reference.end());
+                } else {
+                    scheduler.push(event);
+                }
+                reference.emplace_back(event);
+            }
+
+            // due events from reference in tick and insertion order
+            std::vector<Event> expected;
+            while (true) {
+                auto it = reference.end();
+                for (auto cur = reference.begin(); cur != reference.end(); ++cur) {
+                    if (cur->tick <= tick && (it == reference.end() || cur->tick < it->tick)) {
+                        it = cur;
+                    }
+                }
+                if (it == reference.end()) {
+                    break;
+                }
+                expected.emplace_back(*it);
+                reference.erase(it);
+            }
+
+            auto events = popAll(scheduler, tick);
+            expectEqual(events.size(), expected.size());
+            for (size_t i = 0; i < events.size(); ++i) {
+                expectEqual(events[i].tick, expected[i].tick);
+                expectEqual(events[i].value, expected[i].value);
+            }
+            expectEqual(scheduler.size(), reference.size());
+        }
+
+        expectEqual(scheduler.overflowCount(), uint32_t(0));
+    }
+
+}
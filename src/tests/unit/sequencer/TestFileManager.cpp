@@ -0,0 +1,270 @@
+// model sources are included before UnitTest.h, they define (and undefine) their own CASE macros
+#include "apps/sequencer/model/Arpeggiator.cpp"
+#include "apps/sequencer/model/ArpSequence.cpp"
+#include "apps/sequencer/model/ArpTrack.cpp"
+#include "apps/sequencer/model/Calibration.cpp"
+#include "apps/sequencer/model/ClockSetup.cpp"
+#include "apps/sequencer/model/Curve.cpp"
+#include "apps/sequencer/model/CurveSequence.cpp"
+#include "apps/sequencer/model/CurveTrack.cpp"
+#include "apps/sequencer/model/FileManager.cpp"
+#include "apps/sequencer/model/LogicSequence.cpp"
+#include "apps/sequencer/model/LogicTrack.cpp"
+#include "apps/sequencer/model/MidiCvTrack.cpp"
+#include "apps/sequencer/model/MidiOutput.cpp"
+#include "apps/sequencer/model/ModelUtils.cpp"
+#include "apps/sequencer/model/NoteSequence.cpp"
+#include "apps/sequencer/model/NoteTrack.cpp"
+#include "apps/sequencer/model/PlayState.cpp"
+#include "apps/sequencer/model/Project.cpp"
+#include "apps/sequencer/model/Routing.cpp"
+#include "apps/sequencer/model/Scale.cpp"
+#include "apps/sequencer/model/Settings.cpp"
+#include "apps/sequencer/model/Song.cpp"
+#include "apps/sequencer/model/StochasticSequence.cpp"
+#include "apps/sequencer/model/StochasticTrack.cpp"
+#include "apps/sequencer/model/TimeSignature.cpp"
+#include "apps/sequencer/model/Track.cpp"
+#include "apps/sequencer/model/Types.cpp"
+#include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/UserSettings.cpp"
+
+#include "UnitTest.h"
+
+#include "core/fs/Volume.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <cstdint>
+#include <cstdlib>
+
+static const char *ImagePath = "test_file_manager.iso";
+static const char *ProjectPath = "TEST.PRO";
+
+// the model lives in zero-initialized static memory in the firmware, mirror that when allocating projects on the heap
+struct TestProject : public Project {
+    static void *operator new(size_t size) { return std::calloc(1, size); }
+    static void operator delete(void *ptr) { std::free(ptr); }
+};
+
+typedef std::unique_ptr<TestProject> ProjectPtr;
+
+// serialized project, used to compare projects
+static std::vector<uint8_t> serialize(const Project &project) {
+    std::vector<uint8_t> data;
+    VersionedSerializedWriter writer(
+        [&data] (const void *src, size_t len) {
+            auto bytes = static_cast<const uint8_t *>(src);
+            data.insert(data.end(), bytes, bytes + len);
+        },
+        ProjectVersion::Latest
+    );
+    project.write(writer);
+    return data;
+}
+
+static std::vector<uint8_t> readFile(const char *path) {
+    std::vector<uint8_t> data;
+    fs::File file(path, fs::File::Read);
+    data.resize(file.size());
+    file.read(data.data(), data.size());
+    return data;
+}
+
+static ProjectTable readTable(const char *path) {
+    ProjectTable table;
+    fs::File file(path, fs::File::Read);
+    file.read(&table, sizeof(table));
+    return table;
+}
+
+static size_t chunkSize(const Project &project, int chunk) {
+    ChunkDigest digest;
+    writeProjectChunk(project, chunk, digest, nullptr);
+    return digest.size;
+}
+
+static void setupProject(Project &project) {
+    project.setName("CHUNKS");
+    project.setTempo(133.f);
+    project.setTrackMode(1, Track::TrackMode::Curve);
+    project.setTrackMode(2, Track::TrackMode::Stochastic);
+    auto &sequence = project.track(0).noteTrack().sequence(3);
+    for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+        sequence.step(stepIndex).setGate(stepIndex % 3 == 0);
+        sequence.step(stepIndex).setNote(stepIndex);
+    }
+}
+
+// volume shared by all cases, so a failing case (which does not unwind) does not affect the following cases
+static fs::Volume &testVolume() {
+    SdCard::configure(ImagePath);
+    static SdCard sdCard;
+    static fs::Volume volume(sdCard);
+    return volume;
+}
+
+// counts lock/unlock calls and checks that they are balanced
+struct LockTracker {
+    int locks = 0;
+    bool locked = false;
+    bool balanced = true;
+
+    FileManager::LockCallback callback() {
+        return [this] (bool lock) {
+            balanced &= lock != locked;
+            locked = lock;
+            locks += lock ? 1 : 0;
+        };
+    }
+};
+
+UNIT_TEST("FileManager") {
+
+    // each case runs on a freshly formatted volume
+    auto &volume = testVolume();
+    volume.unmount();
+    expectEqual(int(volume.format()), int(fs::OK), "format");
+    expectEqual(int(volume.mount()), int(fs::OK), "mount");
+
+    CASE("write and read chunked project") {
+        ProjectPtr projectPtr(new TestProject());
+        auto &project = *projectPtr;
+        setupProject(project);
+        LockTracker lockTracker;
+        expectEqual(int(FileManager::writeProject(project, ProjectPath, lockTracker.callback())), int(fs::OK), "write");
+        expectTrue(lockTracker.balanced && !lockTracker.locked, "balanced locking");
+        expectTrue(lockTracker.locks >= Project::ChunkCount, "locked per chunk");
+
+        auto table = readTable(ProjectPath);
+        expectEqual(int(table.header.version), int(FileHeader::ChunkedVersion), "chunked version");
+        for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+            const auto &entry = table.chunks[chunk];
+            expectEqual(int(entry.offset % SectorSize), 0, "chunk at sector boundary");
+            expectEqual(int(entry.size), int(chunkSize(project, chunk)), "chunk size");
+        }
+
+        ProjectPtr readBackPtr(new TestProject());
+        auto &readBack = *readBackPtr;
+        expectEqual(int(FileManager::readProject(readBack, ProjectPath)), int(fs::OK), "read");
+        expectTrue(serialize(readBack) == serialize(project), "read back project");
+    }
+
+    CASE("update changed chunk in place") {
+        ProjectPtr projectPtr(new TestProject());
+        auto &project = *projectPtr;
+        setupProject(project);
+        expectEqual(int(FileManager::writeProject(project, ProjectPath)), int(fs::OK), "write");
+        auto table = readTable(ProjectPath);
+        auto before = readFile(ProjectPath);
+
+        project.track(CONFIG_TRACK_COUNT - 1).noteTrack().sequence(0).step(5).setNote(7);
+        LockTracker lockTracker;
+        expectEqual(int(FileManager::writeProject(project, ProjectPath, lockTracker.callback())), int(fs::OK), "update");
+        expectTrue(lockTracker.balanced && !lockTracker.locked, "balanced locking");
+
+        // chunks are hashed one stage at a time to find the changed chunks
+        size_t stages = 0;
+        for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+            stages += (chunkSize(project, chunk) + StagedWriter::StageSize - 1) / StagedWriter::StageSize;
+        }
+        expectTrue(lockTracker.locks >= int(stages), "locked per stage");
+
+        // chunks keep their place, only the changed chunk and the chunk table differ
+        auto newTable = readTable(ProjectPath);
+        auto after = readFile(ProjectPath);
+        expectEqual(int(after.size()), int(before.size()), "file size");
+        const auto &changedEntry = table.chunks[Project::TrackChunk + CONFIG_TRACK_COUNT - 1];
+        for (int chunk = 0; chunk < Project::ChunkCount; ++chunk) {
+            const auto &entry = table.chunks[chunk];
+            const auto &newEntry = newTable.chunks[chunk];
+            expectEqual(int(newEntry.offset), int(entry.offset), "chunk offset");
+            expectEqual(int(newEntry.capacity), int(entry.capacity), "chunk capacity");
+            expectEqual(newEntry.hash != entry.hash, &entry == &changedEntry, "chunk hash");
+        }
+        for (size_t offset = SectorSize; offset < before.size(); ++offset) {
+            bool inChangedChunk = offset >= changedEntry.offset && offset < changedEntry.offset + changedEntry.capacity;
+            if (!inChangedChunk && after[offset] != before[offset]) {
+                expectTrue(false, "unchanged chunk rewritten");
+                break;
+            }
+        }
+
+        ProjectPtr readBackPtr(new TestProject());
+        auto &readBack = *readBackPtr;
+        expectEqual(int(FileManager::readProject(readBack, ProjectPath)), int(fs::OK), "read");
+        expectTrue(serialize(readBack) == serialize(project), "read back project");
+    }
+
+    CASE("chunk exceeding its capacity rewrites the whole file") {
+        // find the track modes with the smallest and largest track chunk
+        ProjectPtr projectPtr(new TestProject());
+        auto &project = *projectPtr;
+        Track::TrackMode smallest = Track::TrackMode::Note;
+        Track::TrackMode largest = Track::TrackMode::Note;
+        size_t smallestSize = chunkSize(project, Project::TrackChunk);
+        size_t largestSize = smallestSize;
+        for (int mode = 0; mode < int(Track::TrackMode::Last); ++mode) {
+            project.setTrackMode(0, Track::TrackMode(mode));
+            size_t size = chunkSize(project, Project::TrackChunk);
+            if (size < smallestSize) {
+                smallest = Track::TrackMode(mode);
+                smallestSize = size;
+            }
+            if (size > largestSize) {
+                largest = Track::TrackMode(mode);
+                largestSize = size;
+            }
+        }
+        expectTrue(largestSize > roundUpToSector(smallestSize), "track chunk sizes differ by more than a sector");
+
+        project.setTrackMode(0, smallest);
+        expectEqual(int(FileManager::writeProject(project, ProjectPath)), int(fs::OK), "write");
+        auto table = readTable(ProjectPath);
+
+        project.setTrackMode(0, largest);
+        expectEqual(int(FileManager::writeProject(project, ProjectPath)), int(fs::OK), "write grown project");
+        auto newTable = readTable(ProjectPath);
+        const auto &entry = newTable.chunks[Project::TrackChunk];
+        expectEqual(int(entry.size), int(largestSize), "grown chunk size");
+        expectTrue(entry.capacity >= entry.size, "grown chunk capacity");
+        expectTrue(newTable.chunks[Project::TrackChunk + 1].offset > table.chunks[Project::TrackChunk + 1].offset, "chunks moved");
+
+        ProjectPtr readBackPtr(new TestProject());
+        auto &readBack = *readBackPtr;
+        expectEqual(int(FileManager::readProject(readBack, ProjectPath)), int(fs::OK), "read");
+        expectTrue(readBack.track(0).trackMode() == largest, "track mode");
+        expectTrue(serialize(readBack) == serialize(project), "read back project");
+    }
+
+    CASE("read legacy project") {
+        ProjectPtr projectPtr(new TestProject());
+        auto &project = *projectPtr;
+        setupProject(project);
+
+        // write project as a single serialized stream like before chunked project files
+        {
+            fs::FileWriter fileWriter(ProjectPath);
+            FileHeader header(FileType::Project, 0, project.name());
+            fileWriter.write(&header, sizeof(header));
+            VersionedSerializedWriter writer(
+                [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
+                ProjectVersion::Latest
+            );
+            project.write(writer);
+            expectEqual(int(fileWriter.finish()), int(fs::OK), "write legacy");
+        }
+
+        ProjectPtr readBackPtr(new TestProject());
+        auto &readBack = *readBackPtr;
+        expectEqual(int(FileManager::readProject(readBack, ProjectPath)), int(fs::OK), "read legacy");
+        expectTrue(serialize(readBack) == serialize(project), "read back project");
+
+        // legacy files are replaced by chunked files when written
+        expectEqual(int(FileManager::writeProject(readBack, ProjectPath)), int(fs::OK), "write");
+        expectEqual(int(readTable(ProjectPath).header.version), int(FileHeader::ChunkedVersion), "chunked version");
+    }
+
+}
@@ -0,0 +1,204 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadDevice.cpp"
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadMk2Device.cpp"
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadMk3Device.cpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+
+static uint8_t payloadPool[4 * 48];
+
+// exposes the led state set on the device
+template<typename Device>
+struct TestDevice : public Device {
+    template<typename... Args>
+    TestDevice(Args... args) : Device(args...) {}
+
+    uint8_t ledState(int row, int col) const { return this->_ledState[row * LaunchpadDevice::Cols + col]; }
+};
+
+// led state as seen by the device, decoded from the sent messages
+struct DeviceLeds {
+    std::vector<int> leds = std::vector<int>(128, -1);
+    int messages = 0;
+    int sysExMessages = 0;
+    size_t maxSysExLength = 0;
+    // number of messages accepted before sending fails (-1 accepts all)
+    int capacity = -1;
+
+    int cable;
+    uint8_t model;
+    size_t ledLength;
+
+    void attach(LaunchpadDevice &device, int cable, uint8_t model, size_t ledLength) {
+        this->cable = cable;
+        this->model = model;
+        this->ledLength = ledLength;
+        device.setSendMidiHandler([this] (uint8_t messageCable, const MidiMessage &message) {
+            if (capacity == 0) {
+                return false;
+            }
+            if (capacity > 0) {
+                --capacity;
+            }
+            expectEqual(int(messageCable), this->cable);
+            send(message);
+            return true;
+        });
+    }
+
+    void send(const MidiMessage &message) {
+        ++messages;
+        if (message.isSystemExclusive()) {
+            const uint8_t *data = message.payloadData();
+            size_t length = message.payloadLength();
+            expectTrue(length > 6 && data[4] == model, "sysex header");
+            if (data[5] == 0x0a || data[5] == 0x03) {
+                ++sysExMessages;
+                maxSysExLength = std::max(maxSysExLength, length);
+                expectEqual(int((length - 6) % ledLength), 0);
+                for (size_t i = 6; i + ledLength <= length; i += ledLength) {
+                    if (ledLength == 3) {
+                        expectEqual(int(data[i]), 0);
+                    }
+                    leds[data[i + ledLength - 2]] = data[i + ledLength - 1];
+                }
+            }
+        } else if (message.isNoteOn()) {
+            leds[message.note()] = message.velocity();
+        } else if (message.isControlChange()) {
+            leds[message.controlNumber()] = message.controlValue();
+        }
+    }
+
+    void resetCounts() {
+        messages = sysExMessages = 0;
+    }
+};
+
+// led index on launchpads with a 10x10 layout
+static int ledIndex(int row, int col, int functionOffset) {
+    if (row == LaunchpadDevice::SceneRow) {
+        return 19 + 10 * (7 - col);
+    } else if (row == LaunchpadDevice::FunctionRow) {
+        return functionOffset + col;
+    }
+    return 11 + 10 * (7 - row) + col;
+}
+
+static void setAllLeds(LaunchpadDevice &device, int seed) {
+    for (int row = 0; row < LaunchpadDevice::Rows + LaunchpadDevice::ExtraRows; ++row) {
+        for (int col = 0; col < LaunchpadDevice::Cols; ++col) {
+            device.setLed(row, col, (row + col + seed) % 4, (row * col + seed) % 4, (row + seed) % 2);
+        }
+    }
+}
+
+template<typename Device>
+static void expectSynced(const TestDevice<Device> &device, const DeviceLeds &deviceLeds, int functionOffset) {
+    for (int row = 0; row < LaunchpadDevice::Rows + LaunchpadDevice::ExtraRows; ++row) {
+        for (int col = 0; col < LaunchpadDevice::Cols; ++col) {
+            expectEqual(deviceLeds.leds[ledIndex(row, col, functionOffset)], int(device.ledState(row, col)), "led");
+        }
+    }
+}
+
+UNIT_TEST("LaunchpadDevice") {
+
+    MidiMessage::setPayloadPool(payloadPool, sizeof(payloadPool));
+
+    CASE("few changes are sent as individual messages") {
+        TestDevice<LaunchpadMk2Device> device;
+        DeviceLeds deviceLeds;
+        deviceLeds.attach(device, 0, 0x18, 2);
+        device.syncLeds();
+        expectSynced(device, deviceLeds, 104);
+        deviceLeds.resetCounts();
+
+        device.setLed(0, 0, 3, 0, 0);
+        device.setLed(LaunchpadDevice::SceneRow, 1, 0, 3, 0);
+        device.setLed(LaunchpadDevice::FunctionRow, 2, 3, 3, 0);
+        device.syncLeds();
+        expectEqual(deviceLeds.messages, 3);
+        expectEqual(deviceLeds.sysExMessages, 0);
+        expectSynced(device, deviceLeds, 104);
+
+        // unchanged leds are not sent again
+        device.syncLeds();
+        expectEqual(deviceLeds.messages, 3);
+    }
+
+    CASE("many changes are sent in bulk") {
+        TestDevice<LaunchpadMk2Device> device;
+        DeviceLeds deviceLeds;
+        deviceLeds.attach(device, 0, 0x18, 2);
+        setAllLeds(device, 1);
+        device.syncLeds();
+        expectEqual(deviceLeds.messages, deviceLeds.sysExMessages);
+        expectEqual(deviceLeds.sysExMessages, 4);
+        expectTrue(deviceLeds.maxSysExLength <= 46, "sysex fits a usb packet");
+        expectSynced(device, deviceLeds, 104);
+
+        TestDevice<LaunchpadMk3Device> mk3(LaunchpadMk3Device::X);
+        DeviceLeds mk3Leds;
+        mk3Leds.attach(mk3, 1, LaunchpadMk3Device::X, 3);
+        mk3.initialize();
+        mk3Leds.resetCounts();
+        setAllLeds(mk3, 2);
+        mk3.syncLeds();
+        expectEqual(mk3Leds.messages, mk3Leds.sysExMessages);
+        expectTrue(mk3Leds.maxSysExLength <= 46, "sysex fits a usb packet");
+        expectSynced(mk3, mk3Leds, 91);
+    }
+
+    CASE("leds that cannot be sent are sent with the next sync") {
+        for (int capacity : { 0, 1, 3 }) {
+            TestDevice<LaunchpadMk3Device> device(LaunchpadMk3Device::MiniMk3);
+            DeviceLeds deviceLeds;
+            deviceLeds.attach(device, 1, LaunchpadMk3Device::MiniMk3, 3);
+            for (int seed = 0; seed < 8; ++seed) {
+                setAllLeds(device, seed);
+                deviceLeds.capacity = capacity;
+                device.syncLeds();
+                deviceLeds.capacity = -1;
+                for (int sync = 0; sync < 10; ++sync) {
+                    device.syncLeds();
+                }
+                expectSynced(device, deviceLeds, 91);
+            }
+        }
+
+        // all payload slots are held by queued messages
+        TestDevice<LaunchpadMk3Device> device(LaunchpadMk3Device::MiniMk3);
+        DeviceLeds deviceLeds;
+        deviceLeds.attach(device, 1, LaunchpadMk3Device::MiniMk3, 3);
+        std::vector<MidiMessage> queued;
+        auto sendHandler = [&] (uint8_t cable, const MidiMessage &message) {
+            queued.push_back(message);
+            return true;
+        };
+        device.setSendMidiHandler(sendHandler);
+        setAllLeds(device, 3);
+        device.syncLeds();
+        // leds left once all payload slots are allocated are sent with individual messages
+        int sysExQueued = std::count_if(queued.begin(), queued.end(), [] (const MidiMessage &message) {
+            return message.hasPayload();
+        });
+        expectEqual(sysExQueued, 4);
+        expectTrue(int(queued.size()) > sysExQueued, "individual messages");
+        // sending the queued messages releases the slots
+        deviceLeds.attach(device, 1, LaunchpadMk3Device::MiniMk3, 3);
+        for (const auto &message : queued) {
+            deviceLeds.send(message);
+        }
+        queued.clear();
+        expectSynced(device, deviceLeds, 91);
+        setAllLeds(device, 5);
+        device.syncLeds();
+        expectSynced(device, deviceLeds, 91);
+    }
+
+}
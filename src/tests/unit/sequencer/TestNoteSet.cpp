@@ -0,0 +1,98 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/NoteSet.h"
+
+#include "core/utils/Random.h"
+
+#include <set>
+
+struct TestNote {
+    int32_t note;
+    uint32_t order;
+};
+
+UNIT_TEST("NoteSet") {
+
+    CASE("key set") {
+        KeySet keys;
+        expectFalse(keys.any());
+        expectEqual(keys.count(), 0);
+        keys.set(0);
+        keys.set(31);
+        keys.set(32);
+        keys.set(127);
+        expectTrue(keys.any());
+        expectEqual(keys.count(), 4);
+        expectTrue(keys.test(31));
+        expectFalse(keys.test(30));
+        expectEqual(keys.nextAbove(-1), 0);
+        expectEqual(keys.nextAbove(0), 31);
+        expectEqual(keys.nextAbove(31), 32);
+        expectEqual(keys.nextAbove(32), 127);
+        expectEqual(keys.nextAbove(127), -1);
+        expectEqual(keys.nextBelow(128), 127);
+        expectEqual(keys.nextBelow(127), 32);
+        expectEqual(keys.nextBelow(32), 31);
+        expectEqual(keys.nextBelow(31), 0);
+        expectEqual(keys.nextBelow(0), -1);
+        keys.reset(127);
+        expectEqual(keys.nextAbove(32), -1);
+        // keys are wrapped
+        keys.set(-1);
+        expectTrue(keys.test(127));
+        keys.clear();
+        expectFalse(keys.any());
+    }
+
+    CASE("ordered insert/remove") {
+        NoteSet<TestNote, 4> notes;
+        expectTrue(notes.empty());
+        expectEqual(notes.insert({ 5, 0 }), 0);
+        expectEqual(notes.insert({ -3, 1 }), 0);
+        expectEqual(notes.insert({ 7, 2 }), 2);
+        expectEqual(notes.insert({ 5, 3 }), -1);
+        expectEqual(notes.insert({ 6, 4 }), 2);
+        expectTrue(notes.full());
+        expectEqual(notes.insert({ 0, 5 }), -1);
+        expectEqual(int(notes.size()), 4);
+        expectEqual(notes[0].note, -3);
+        expectEqual(notes[1].note, 5);
+        expectEqual(notes[1].order, uint32_t(0));
+        expectEqual(notes[2].note, 6);
+        expectEqual(notes[3].note, 7);
+        expectEqual(notes.find(6), 2);
+        expectEqual(notes.find(4), -1);
+        expectTrue(notes.remove(5));
+        expectFalse(notes.remove(5));
+        expectEqual(int(notes.size()), 3);
+        expectEqual(notes[1].note, 6);
+        notes.erase(0);
+        expectEqual(notes[0].note, 6);
+        notes.clear();
+        expectTrue(notes.empty());
+    }
+
+    CASE("random against std::set") {
+        Random rng(0x5678);
+        NoteSet<TestNote, 12> notes;
+        std::set<int> reference;
+        for (int i = 0; i < 10000; ++i) {
+            int note = int(rng.nextRange(48)) - 24;
+            if (rng.nextRange(2) == 0) {
+                bool inserted = notes.insert({ note, uint32_t(i) }) != -1;
+                expectEqual(inserted, reference.size() < 12 && reference.count(note) == 0);
+                if (inserted) {
+                    reference.insert(note);
+                }
+            } else {
+                expectEqual(notes.remove(note), reference.erase(note) == 1);
+            }
+            expectEqual(notes.size(), reference.size());
+            size_t index = 0;
+            for (int n : reference) {
+                expectEqual(notes[index++].note, n);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,144 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/RouteIndex.h"
+
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+typedef RouteIndex<64, 12> Index;
+
+struct MidiRoute {
+    int port;
+    int channel;
+    Index::MidiKind kind;
+    int number;
+};
+
+template<typename F>
+static std::vector<int> collect(F f) {
+    std::vector<int> routes;
+    f([&] (int routeIndex) { routes.emplace_back(routeIndex); });
+    std::sort(routes.begin(), routes.end());
+    return routes;
+}
+
+UNIT_TEST("RouteIndex") {
+
+    CASE("empty") {
+        Index index;
+        expectEqual(index.midiRouteCount(), size_t(0));
+        expectEqual(index.cvRouteCount(), size_t(0));
+        auto routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 0, Index::MidiKind::ControlChange, 1, f); });
+        expectTrue(routes.empty());
+        for (int cvSource = 0; cvSource < 12; ++cvSource) {
+            routes = collect([&] (std::function<void(int)> f) { index.forEachCvRoute(cvSource, f); });
+            expectTrue(routes.empty());
+        }
+    }
+
+    CASE("exact channel and omni") {
+        Index index;
+        index.addMidiRoute(0, 3, Index::MidiKind::ControlChange, 7, 0);
+        index.addMidiRoute(0, Index::Omni, Index::MidiKind::ControlChange, 7, 1);
+        index.addMidiRoute(1, 3, Index::MidiKind::ControlChange, 7, 2);
+        index.addMidiRoute(0, 3, Index::MidiKind::Note, 7, 3);
+        index.addMidiRoute(0, 3, Index::MidiKind::PitchBend, 100, 4);
+        index.build();
+
+        auto routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 3, Index::MidiKind::ControlChange, 7, f); });
+        expectTrue(routes == std::vector<int>({ 0, 1 }));
+        routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 4, Index::MidiKind::ControlChange, 7, f); });
+        expectTrue(routes == std::vector<int>({ 1 }));
+        routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(1, 3, Index::MidiKind::ControlChange, 7, f); });
+        expectTrue(routes == std::vector<int>({ 2 }));
+        routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 3, Index::MidiKind::Note, 7, f); });
+        expectTrue(routes == std::vector<int>({ 3 }));
+        routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 3, Index::MidiKind::PitchBend, 0, f); });
+        expectTrue(routes == std::vector<int>({ 4 }));
+    }
+
+    CASE("random against linear scan") {
+        Random rng(0x1234);
+        for (int set = 0; set < 100; ++set) {
+            Index index;
+            std::vector<MidiRoute> midiRoutes;
+            std::vector<int> cvSources;
+
+            for (int routeIndex = 0; routeIndex < 64; ++routeIndex) {
+                // use a small number of keys to get duplicate keys
+                MidiRoute route = {
+                    int(rng.nextRange(1)),
+                    int(rng.nextRange(2)) - 1,
+                    Index::MidiKind(rng.nextRange(3)),
+                    int(rng.nextRange(3))
+                };
+                if (route.kind == Index::MidiKind::NoteRange || route.kind == Index::MidiKind::PitchBend) {
+                    route.number = 0;
+                }
+                midiRoutes.emplace_back(route);
+                index.addMidiRoute(route.port, route.channel, route.kind, route.number, routeIndex);
+
+                int cvSource = rng.nextRange(11);
+                cvSources.emplace_back(cvSource);
+                index.addCvRoute(cvSource, routeIndex);
+            }
+            index.build();
+            expectEqual(index.midiRouteCount(), size_t(64));
+            expectEqual(index.cvRouteCount(), size_t(64));
+
+            for (int port = 0; port < 2; ++port) {
+                for (int channel = 0; channel < 16; ++channel) {
+                    for (int kind = 0; kind < 4; ++kind) {
+                        for (int number = 0; number < 4; ++number) {
+                            std::vector<int> expected;
+                            for (int routeIndex = 0; routeIndex < 64; ++routeIndex) {
+                                const auto &route = midiRoutes[routeIndex];
+                                if (route.port == port && (route.channel == Index::Omni || route.channel == channel) &&
+                                    int(route.kind) == kind && route.number == number) {
+                                    expected.emplace_back(routeIndex);
+                                }
+                            }
+                            auto routes = collect([&] (std::function<void(int)> f) {
+                                index.forEachMidiRoute(port, channel, Index::MidiKind(kind), number, f);
+                            });
+                            expectTrue(routes == expected);
+                        }
+                    }
+                }
+            }
+
+            for (int cvSource = 0; cvSource < 12; ++cvSource) {
+                std::vector<int> expected;
+                for (int routeIndex = 0; routeIndex < 64; ++routeIndex) {
+                    if (cvSources[routeIndex] == cvSource) {
+                        expected.emplace_back(routeIndex);
+                    }
+                }
+                auto routes = collect([&] (std::function<void(int)> f) { index.forEachCvRoute(cvSource, f); });
+                expectTrue(routes == expected);
+            }
+        }
+    }
+
+    CASE("rebuild") {
+        Index index;
+        index.addMidiRoute(0, 0, Index::MidiKind::ControlChange, 1, 0);
+        index.addCvRoute(0, 1);
+        index.build();
+
+        index.clear();
+        index.addMidiRoute(0, 0, Index::MidiKind::ControlChange, 2, 0);
+        index.build();
+
+        auto routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 0, Index::MidiKind::ControlChange, 1, f); });
+        expectTrue(routes.empty());
+        routes = collect([&] (std::function<void(int)> f) { index.forEachMidiRoute(0, 0, Index::MidiKind::ControlChange, 2, f); });
+        expectTrue(routes == std::vector<int>({ 0 }));
+        routes = collect([&] (std::function<void(int)> f) { index.forEachCvRoute(0, f); });
+        expectTrue(routes.empty());
+    }
+
+}
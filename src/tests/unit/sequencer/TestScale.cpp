@@ -4,6 +4,7 @@
 
 #include "apps/sequencer/model/Scale.cpp"
 #include "apps/sequencer/model/UserScale.cpp"
+#include "apps/sequencer/model/QuantizerTable.cpp"
 
 #include <array>
 #include <cstdint>
@@ -62,6 +63,58 @@ UNIT_TEST("Scale") {
         }
     }
 
+    CASE("quantizer table") {
+        // setup user scales
+        auto &chromatic = UserScale::userScales[0];
+        chromatic.setMode(UserScale::Mode::Chromatic);
+        chromatic.setSize(5);
+        for (int i = 0; i < 5; ++i) {
+            chromatic.setItem(i, i * 2 + 1);
+        }
+        auto &voltage = UserScale::userScales[1];
+        voltage.setMode(UserScale::Mode::Voltage);
+        voltage.setSize(4);
+        voltage.setItem(0, -200);
+        voltage.setItem(1, 300);
+        voltage.setItem(2, 100);
+        voltage.setItem(3, 1300);
+
+        for (int i = 0; i < Scale::Count; ++i) {
+            const auto &scale = Scale::get(i);
+            for (int rootNote = 0; rootNote < 12; ++rootNote) {
+                const auto &table = QuantizerTable::get(scale, rootNote);
+                expectEqual(table.notesPerOctave(), scale.notesPerOctave(), "notes per octave");
+                expectEqual(table.isChromatic(), scale.isChromatic(), "chromatic");
+
+                for (int note = -64; note <= 64; ++note) {
+                    float expected = scale.noteToVolts(note) + (scale.isChromatic() ? rootNote : 0) * (1.f / 12.f);
+                    expectTrue(std::abs(table.noteToVolts(note) - expected) < 1e-5f, "noteToVolts");
+                    expectEqual(table.isNotePresent(note), scale.isNotePresent(note), "isNotePresent");
+                    expectEqual(table.getNoteIndex(note), scale.getNoteIndex(note), "getNoteIndex");
+                }
+
+                for (int step = -5 * 1536; step <= 5 * 1536; ++step) {
+                    float volts = step * (1.f / 1536.f) + 0.0001f;
+                    expectEqual(table.noteFromVolts(volts), scale.noteFromVolts(volts), "noteFromVolts");
+                }
+
+                for (int midiNote = 0; midiNote < 128; ++midiNote) {
+                    int expected = scale.noteFromVolts((midiNote - 60 - (scale.isChromatic() ? rootNote : 0)) * (1.f / 12.f));
+                    expectEqual(table.noteFromMidiNote(midiNote), expected, "noteFromMidiNote");
+                }
+            }
+        }
+
+        // tables are shared
+        expectTrue(&QuantizerTable::get(Scale::get(1), 3) == &QuantizerTable::get(Scale::get(1), 3), "shared table");
+
+        // tables are rebuilt on edit
+        const auto &table = QuantizerTable::get(chromatic, 0);
+        expectEqual(table.noteFromMidiNote(60), -1, "user scale before edit");
+        chromatic.setItem(0, 0);
+        expectEqual(QuantizerTable::get(chromatic, 0).noteFromMidiNote(60), 0, "user scale after edit");
+    }
+
 #ifdef PLATFORM_SIM
 
     CASE("markdown") {
@@ -0,0 +1,187 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/VoiceAllocator.h"
+
+#include "core/utils/Random.h"
+
+#include <algorithm>
+#include <vector>
+
+typedef VoiceAllocator<8> Allocator;
+
+struct HeldNote {
+    int note;
+    uint32_t time;
+};
+
+// held notes in priority order
+static std::vector<HeldNote> sortedNotes(std::vector<HeldNote> notes, Allocator::Priority priority) {
+    std::sort(notes.begin(), notes.end(), [priority] (const HeldNote &a, const HeldNote &b) {
+        switch (priority) {
+        case Allocator::Priority::LastNote:     return a.time > b.time;
+        case Allocator::Priority::FirstNote:    return a.time < b.time;
+        case Allocator::Priority::LowestNote:   return a.note < b.note;
+        case Allocator::Priority::HighestNote:  return a.note > b.note;
+        }
+        return false;
+    });
+    return notes;
+}
+
+static std::vector<int> activeNotes(const Allocator &allocator) {
+    std::vector<int> notes;
+    allocator.forEachActiveVoice([&] (const Allocator::Voice &voice) { notes.emplace_back(voice.note); });
+    return notes;
+}
+
+static std::vector<int> outputNotes(const Allocator &allocator) {
+    std::vector<int> notes;
+    for (int output = 0; output < allocator.outputCount(); ++output) {
+        auto voice = allocator.outputVoice(output);
+        notes.emplace_back(voice ? voice->note : -1);
+    }
+    return notes;
+}
+
+UNIT_TEST("VoiceAllocator") {
+
+    CASE("round robin with release tails") {
+        Allocator allocator;
+        allocator.setOutputCount(4);
+        allocator.noteOn(60, 100, 1);
+        allocator.noteOn(62, 100, 2);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 60, 62, -1, -1 }));
+        allocator.noteOff(60);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 60, 62, -1, -1 }));
+        expectFalse(allocator.outputVoice(0)->isActive());
+        allocator.noteOn(64, 100, 3);
+        allocator.noteOn(65, 100, 4);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 60, 62, 64, 65 }));
+        // new note reuses the release tail
+        allocator.noteOn(67, 100, 5);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 67, 62, 64, 65 }));
+        expectEqual(allocator.activeCount(), 4);
+    }
+
+    CASE("steal lowest priority") {
+        Allocator allocator;
+        allocator.setOutputCount(2);
+        allocator.setPriority(Allocator::Priority::HighestNote);
+        allocator.noteOn(60, 100, 1);
+        allocator.noteOn(64, 100, 2);
+        allocator.noteOn(62, 100, 3);
+        // 62 takes the output of the lowest note
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 62, 64 }));
+        allocator.noteOn(67, 100, 4);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 67, 64 }));
+        // releasing a note hands its output to the next held note
+        allocator.noteOff(67);
+        expectTrue(outputNotes(allocator) == std::vector<int>({ 62, 64 }));
+        expectTrue(activeNotes(allocator) == std::vector<int>({ 64, 62, 60 }));
+    }
+
+    CASE("monophonic") {
+        Allocator allocator;
+        allocator.setOutputCount(1);
+        allocator.noteOn(60, 100, 1);
+        allocator.noteOn(62, 100, 2);
+        expectEqual(int(allocator.outputVoice(0)->note), 62);
+        allocator.noteOff(62);
+        expectEqual(int(allocator.outputVoice(0)->note), 60);
+        allocator.noteOff(60);
+        expectEqual(int(allocator.outputVoice(0)->note), 60);
+        expectFalse(allocator.outputVoice(0)->isActive());
+    }
+
+    CASE("retrigger and key pressure") {
+        Allocator allocator;
+        allocator.setOutputCount(2);
+        allocator.noteOn(60, 100, 1);
+        allocator.noteOn(62, 100, 2);
+        allocator.noteOn(60, 50, 3);
+        expectEqual(allocator.activeCount(), 2);
+        expectTrue(activeNotes(allocator) == std::vector<int>({ 60, 62 }));
+        auto voice = allocator.findVoice(60);
+        expectTrue(voice != nullptr);
+        expectEqual(int(voice->velocity), 50);
+        voice->pressure = 10;
+        expectEqual(int(allocator.outputVoice(0)->pressure), 10);
+        expectTrue(allocator.findVoice(61) == nullptr);
+        expectFalse(allocator.noteOff(61));
+        expectTrue(allocator.noteOff(60));
+        expectTrue(allocator.findVoice(60) == nullptr);
+    }
+
+    CASE("random against sorted reference") {
+        Random rng(0x1234);
+        for (int priorityIndex = 0; priorityIndex < 4; ++priorityIndex) {
+            for (int outputCount = 1; outputCount <= 8; ++outputCount) {
+                auto priority = Allocator::Priority(priorityIndex);
+                Allocator allocator;
+                allocator.setPriority(priority);
+                allocator.setOutputCount(outputCount);
+
+                std::vector<HeldNote> held;
+                for (uint32_t time = 1; time < 2000; ++time) {
+                    int note = 48 + rng.nextRange(24);
+                    auto it = std::find_if(held.begin(), held.end(), [note] (const HeldNote &n) { return n.note == note; });
+                    if (rng.nextRange(2) == 0) {
+                        allocator.noteOn(note, 100, time);
+                        if (it != held.end()) {
+                            it->time = time;
+                        } else {
+                            if (held.size() == 8) {
+                                // lowest priority note is stolen
+                                auto sorted = sortedNotes(held, priority);
+                                int stolen = sorted.back().note;
+                                held.erase(std::find_if(held.begin(), held.end(), [stolen] (const HeldNote &n) { return n.note == stolen; }));
+                            }
+                            held.push_back({ note, time });
+                        }
+                    } else {
+                        expectEqual(allocator.noteOff(note), it != held.end());
+                        if (it != held.end()) {
+                            held.erase(it);
+                        }
+                    }
+
+                    // priority order
+                    auto sorted = sortedNotes(held, priority);
+                    std::vector<int> expected;
+                    for (const auto &n : sorted) {
+                        expected.emplace_back(n.note);
+                    }
+                    expectTrue(activeNotes(allocator) == expected, "priority order");
+
+                    // highest priority notes are assigned to distinct outputs, other outputs play release tails
+                    std::vector<int> assigned;
+                    for (int output = 0; output < outputCount; ++output) {
+                        auto voice = allocator.outputVoice(output);
+                        if (voice) {
+                            expectEqual(int(voice->output), output);
+                            if (voice->isActive()) {
+                                assigned.emplace_back(voice->note);
+                            } else {
+                                expectTrue(allocator.findVoice(voice->note) != voice, "release tail");
+                            }
+                        }
+                    }
+                    std::vector<int> top(expected.begin(), expected.begin() + std::min(int(expected.size()), outputCount));
+                    std::sort(top.begin(), top.end());
+                    std::sort(assigned.begin(), assigned.end());
+                    expectTrue(assigned == top, "assigned outputs");
+                }
+
+                // switching priority reorders held notes
+                auto nextPriority = Allocator::Priority((priorityIndex + 1) % 4);
+                allocator.setPriority(nextPriority);
+                std::vector<int> expected;
+                for (const auto &n : sortedNotes(held, nextPriority)) {
+                    expected.emplace_back(n.note);
+                }
+                expectTrue(activeNotes(allocator) == expected, "priority change");
+            }
+        }
+    }
+
+}